@@ -0,0 +1,435 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <CLI/CLI.hpp>
+
+#include "Assembler.h"
+#include "BytecodeInterpreter.h"
+#include "CodeGen.h"
+#include "ElfAsmBuilder.h"
+#include "Interpreter.h"
+#include "IrAsmBuilder.h"
+#include "Jit.h"
+#include "Optimizer.h"
+#include "Parser.h"
+#include "Pipeline.h"
+#include "Profile.h"
+#include "Reporter.h"
+#include "Scanner.h"
+
+using namespace goo;
+namespace fs = std::filesystem;
+
+/*
+ * goo_bench measures each stage of the compiler and each way of executing a program, for every program of a corpus,
+ * and prints the results as JSON, to compare them between releases:
+ *
+ *   goo_bench --repetitions 5 --output bench.json
+ *
+ * By default, the corpus consists of the programs in the examples directory. Further programs may be passed as
+ * arguments, which are run without any input.
+ *
+ * The engine binary-pgo is a binary that is optimized with the profile of a single run of a profiled binary, on the
+ * same input, see OptimizerConfig::profile.
+ *
+ * The input, the binaries and their output are written to a directory of their own, which is created by mkdtemp and
+ * removed once all programs have been run, therefor several benchmarks may run at the same time.
+ */
+
+/// A program of the corpus and the input it reads.
+struct Program {
+    std::string path;
+    std::string input;
+};
+
+/// The timings of a stage or engine over all repetitions, in microseconds.
+struct Timing {
+    double min = 0;
+    double median = 0;
+};
+
+/// The results of a single program.
+struct ProgramResult {
+    std::string name;
+    std::size_t sourceBytes = 0;
+    std::size_t parsedStmts = 0;
+    std::size_t optimizedStmts = 0;
+    std::size_t outputBytes = 0;
+
+    /// Whether all engines produced the same output as the Interpreter.
+    bool outputsMatch = true;
+
+    std::vector<std::pair<std::string, Timing>> stages;
+    std::vector<std::pair<std::string, Timing>> engines;
+};
+
+/// Runs the function `repetitions` times and returns the minimum and median of its wall time.
+Timing measure(const int repetitions, const std::function<void()> &function) {
+    std::vector<double> durations;
+
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+
+        durations.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    std::ranges::sort(durations);
+
+    return Timing{.min = durations.front(), .median = durations[durations.size() / 2]};
+}
+
+/// Temporarily replaces stdin with a file containing `input`, as the interpreters and the JIT read directly from
+/// STDIN_FILENO. The file is also passed to the generated binaries as their stdin.
+class StdinReplacement {
+    int savedStdin;
+
+public:
+    const std::string path;
+
+    StdinReplacement(const std::string &input, const fs::path &workDir) : path((workDir / "input").string()) {
+        std::ofstream(path, std::ios::binary) << input;
+
+        savedStdin = dup(STDIN_FILENO);
+        const int inputFd = open(path.c_str(), O_RDONLY);
+        dup2(inputFd, STDIN_FILENO);
+        close(inputFd);
+    }
+
+    ~StdinReplacement() {
+        dup2(savedStdin, STDIN_FILENO);
+        close(savedStdin);
+        std::remove(path.c_str());
+    }
+
+    /// Rewinds stdin, so that each repetition reads the same input.
+    static void rewind() {
+        lseek(STDIN_FILENO, 0, SEEK_SET);
+    }
+};
+
+/// Runs an executable with the given files as stdin and stdout.
+/// @return True if the executable exited successfully.
+bool runBinary(const std::string &executable, const std::string &inputFile, const std::string &outputFile) {
+    const pid_t pid = fork();
+
+    if (pid == 0) {
+        const int inputFd = open(inputFile.c_str(), O_RDONLY);
+        const int outputFd = open(outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(inputFd, STDIN_FILENO);
+        dup2(outputFd, STDOUT_FILENO);
+
+        execl(executable.c_str(), executable.c_str(), nullptr);
+        _exit(127);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/// Writes the ELF code of an executable to `path` and makes it executable.
+void writeExecutable(const std::shared_ptr<Payload> &elfCode, const std::string &path) {
+    const auto &elf = std::static_pointer_cast<StringPayload>(elfCode)->value;
+
+    std::ofstream(path, std::ios::binary).write(elf.data(), static_cast<std::streamsize>(elf.size()));
+    fs::permissions(path, fs::perms::owner_exec, fs::perm_options::add);
+}
+
+std::string readFile(const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    std::stringstream content;
+    content << ifs.rdbuf();
+
+    return content.str();
+}
+
+ProgramResult benchmark(const Program &program, const int repetitions, const OptimizerConfig &optimizerConfig,
+                        const bool withNasm, const fs::path &workDir) {
+    // Warnings, such as wrap-arounds of the tape pointer, end up here instead of in the results.
+    std::stringstream messages;
+    Reporter reporter("", messages);
+
+    ProgramResult result{.name = fs::path(program.path).filename().string()};
+
+    const auto source = std::make_shared<StringPayload>(StringPayload{.value = readFile(program.path)});
+    result.sourceBytes = source->value.size();
+
+    //
+    // Compiler stages
+    //
+
+    std::shared_ptr<Payload> tokens;
+    result.stages.emplace_back("scanner", measure(repetitions, [&] {
+        tokens = Scanner(reporter).run(source);
+    }));
+
+    std::shared_ptr<Payload> parsed;
+    result.stages.emplace_back("parser", measure(repetitions, [&] {
+        parsed = Parser(reporter).run(tokens);
+    }));
+
+    result.stages.emplace_back("streaming-parser", measure(repetitions, [&] {
+        auto _ = StreamingParser(true, STRING, reporter).run(source);
+    }));
+
+    std::shared_ptr<Payload> optimized;
+    result.stages.emplace_back("optimizer", measure(repetitions, [&] {
+        optimized = Optimizer(optimizerConfig, reporter).run(parsed);
+    }));
+
+    result.parsedStmts = std::static_pointer_cast<StmtPayload>(parsed)->stmts.size();
+    result.optimizedStmts = std::static_pointer_cast<StmtPayload>(optimized)->stmts.size();
+
+    const auto codeGenConfig = CodeGenConfig{.debugBuild = false};
+
+    std::shared_ptr<Payload> asmCode;
+    result.stages.emplace_back("codegen", measure(repetitions, [&] {
+        const auto asmBuilder = std::make_shared<IrAsmBuilder>(reporter);
+        asmCode = CodeGen(codeGenConfig, asmBuilder, reporter).run(optimized);
+    }));
+
+    std::shared_ptr<Payload> elfCode;
+    result.stages.emplace_back("elf-codegen", measure(repetitions, [&] {
+        const auto asmBuilder = std::make_shared<ElfAsmBuilder>(ELF_EXECUTABLE, reporter);
+        elfCode = CodeGen(codeGenConfig, asmBuilder, reporter).run(optimized);
+    }));
+
+    const auto objectFile = (workDir / "program.o").string();
+    if (withNasm) {
+        std::stringstream assemblerMessages;
+        Reporter assemblerReporter("", assemblerMessages);
+
+        result.stages.emplace_back("assembler", measure(repetitions, [&] {
+            Assembler(AssemblerConfig{.debugBuild = false, .verbose = false, .outputFile = objectFile},
+                      assemblerReporter).run(asmCode);
+        }));
+
+        fs::remove(objectFile);
+    }
+
+    //
+    // Execution engines
+    //
+
+    const StdinReplacement stdinReplacement(program.input, workDir);
+
+    std::string expectedOutput;
+    result.engines.emplace_back("interpreter", measure(repetitions, [&] {
+        StdinReplacement::rewind();
+
+        std::stringstream out;
+        Interpreter(reporter, out).run(optimized);
+        expectedOutput = out.str();
+    }));
+
+    result.outputBytes = expectedOutput.size();
+
+    std::string output;
+    result.engines.emplace_back("bytecode-interpreter", measure(repetitions, [&] {
+        StdinReplacement::rewind();
+
+        std::stringstream out;
+        BytecodeInterpreter(reporter, out).run(optimized);
+        output = out.str();
+    }));
+
+    result.outputsMatch &= output == expectedOutput;
+
+    if (Jit::isAvailable()) {
+        result.engines.emplace_back("jit", measure(repetitions, [&] {
+            StdinReplacement::rewind();
+
+            std::stringstream out;
+            Jit(reporter, out).run(optimized);
+            output = out.str();
+        }));
+
+        result.outputsMatch &= output == expectedOutput;
+    }
+
+    const auto executable = (workDir / "binary").string();
+    const auto outputFile = (workDir / "output").string();
+    writeExecutable(elfCode, executable);
+
+    bool exitedSuccessfully = true;
+    result.engines.emplace_back("binary", measure(repetitions, [&] {
+        exitedSuccessfully &= runBinary(executable, stdinReplacement.path, outputFile);
+    }));
+
+    result.outputsMatch &= exitedSuccessfully && readFile(outputFile) == expectedOutput;
+
+    // The profile of a single run is taken for compiling the binary of binary-pgo. The compilation isn't measured.
+    const auto profileFile = executable + ".prof";
+    const auto profiledElf = std::make_shared<ElfAsmBuilder>(ELF_EXECUTABLE, reporter);
+    writeExecutable(CodeGen(CodeGenConfig{.debugBuild = false, .profileFile = profileFile}, profiledElf, reporter)
+                    .run(optimized), executable);
+
+    const bool profiled = runBinary(executable, stdinReplacement.path, outputFile);
+
+    if (const auto profile = Profile::read(profileFile); profiled && profile.has_value()) {
+        const auto profileOptimized = Optimizer(OptimizerConfig{
+            .level = optimizerConfig.level,
+            .passes = optimizerConfig.passes,
+            .profile = std::make_shared<const Profile>(*profile)
+        }, reporter).run(parsed);
+
+        const auto pgoElf = std::make_shared<ElfAsmBuilder>(ELF_EXECUTABLE, reporter);
+        writeExecutable(CodeGen(codeGenConfig, pgoElf, reporter).run(profileOptimized), executable);
+
+        result.engines.emplace_back("binary-pgo", measure(repetitions, [&] {
+            exitedSuccessfully &= runBinary(executable, stdinReplacement.path, outputFile);
+        }));
+
+        result.outputsMatch &= exitedSuccessfully && readFile(outputFile) == expectedOutput;
+    } else {
+        result.outputsMatch = false;
+    }
+
+    fs::remove(profileFile);
+    fs::remove(executable);
+    fs::remove(outputFile);
+
+    return result;
+}
+
+/// Escapes a string for JSON. The names of programs and stages don't contain any control characters.
+std::string quote(const std::string &value) {
+    std::string quoted = "\"";
+
+    for (const char character: value) {
+        if (character == '"' || character == '\\') {
+            quoted += '\\';
+        }
+
+        quoted += character;
+    }
+
+    return quoted + "\"";
+}
+
+void printTimings(std::ostream &out, const std::vector<std::pair<std::string, Timing>> &timings) {
+    for (std::size_t idx = 0; idx < timings.size(); idx++) {
+        const auto &[name, timing] = timings[idx];
+
+        out << std::format("        {}: {{\"minUs\": {}, \"medianUs\": {}}}", quote(name), timing.min,
+                           timing.median)
+                << (idx + 1 < timings.size() ? ",\n" : "\n");
+    }
+}
+
+void printJson(std::ostream &out, const std::vector<ProgramResult> &results, const int repetitions,
+               const int optLevel, const bool withNasm) {
+    out << "{\n";
+    out << std::format("  \"repetitions\": {},\n", repetitions);
+    out << std::format("  \"optimizationLevel\": {},\n", optLevel);
+    out << std::format("  \"nasm\": {},\n", withNasm ? "true" : "false");
+    out << std::format("  \"jit\": {},\n", Jit::isAvailable() ? "true" : "false");
+    out << "  \"programs\": [\n";
+
+    for (std::size_t idx = 0; idx < results.size(); idx++) {
+        const auto &result = results[idx];
+
+        out << "    {\n";
+        out << std::format("      \"name\": {},\n", quote(result.name));
+        out << std::format("      \"sourceBytes\": {},\n", result.sourceBytes);
+        out << std::format("      \"parsedStatements\": {},\n", result.parsedStmts);
+        out << std::format("      \"optimizedStatements\": {},\n", result.optimizedStmts);
+        out << std::format("      \"outputBytes\": {},\n", result.outputBytes);
+        out << std::format("      \"outputsMatch\": {},\n", result.outputsMatch ? "true" : "false");
+
+        out << "      \"stages\": {\n";
+        printTimings(out, result.stages);
+        out << "      },\n";
+
+        out << "      \"engines\": {\n";
+        printTimings(out, result.engines);
+        out << "      }\n";
+
+        out << "    }" << (idx + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]\n";
+    out << "}" << std::endl;
+}
+
+int main(const int argc, char **argv) {
+    CLI::App app{"goo_bench measures the stages of goo and the execution of the compiled programs.", "goo_bench"};
+
+    int repetitions = 5;
+    int optLevel = DEFAULT_OPT_LEVEL;
+    std::string outputFile;
+    std::string corpusDir = GOO_EXAMPLES_DIR;
+    std::vector<std::string> extraPrograms;
+
+    app.add_option("-r,--repetitions", repetitions, "How often each stage and engine is run, defaults to 5.")
+            ->check(CLI::PositiveNumber);
+    app.add_option("-O", optLevel, "The optimization level of the optimizer stage and the engines.")
+            ->check(CLI::Range(0, 3));
+    app.add_option("-o,--output", outputFile, "Write the JSON results to this file instead of standard out.");
+    app.add_option("--corpus-dir", corpusDir, "The directory of the default corpus.");
+    app.add_option("programs", extraPrograms, "Further programs to run, without any input.");
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<Program> programs = {
+        // c-tree.bf reads the height of the tree as its first input.
+        {.path = corpusDir + "/c-tree.bf", .input = "9\n"},
+        {.path = corpusDir + "/primes.bf", .input = ""},
+        {.path = corpusDir + "/fibonacci.bf", .input = ""},
+        {.path = corpusDir + "/long-output.bf", .input = ""}
+    };
+
+    for (const auto &program: extraPrograms) {
+        programs.push_back(Program{.path = program, .input = ""});
+    }
+
+    const bool withNasm = std::system("command -v nasm > /dev/null 2>&1") == 0;
+    const auto optimizerConfig = OptimizerConfig{.level = optLevel};
+
+    auto workDir = (fs::temp_directory_path() / "goo_bench_XXXXXX").string();
+    if (mkdtemp(workDir.data()) == nullptr) {
+        std::cerr << "Failed to create a directory in " << fs::temp_directory_path() << std::endl;
+        return 1;
+    }
+
+    std::vector<ProgramResult> results;
+    for (const auto &program: programs) {
+        if (!fs::exists(program.path)) {
+            std::cerr << "Skipping missing program: " << program.path << std::endl;
+            continue;
+        }
+
+        std::cerr << "Benchmarking " << program.path << std::endl;
+        results.push_back(benchmark(program, repetitions, optimizerConfig, withNasm, workDir));
+    }
+
+    std::error_code error;
+    fs::remove_all(workDir, error);
+
+    if (outputFile.empty()) {
+        printJson(std::cout, results, repetitions, optLevel, withNasm);
+    } else {
+        std::ofstream out(outputFile);
+        printJson(out, results, repetitions, optLevel, withNasm);
+    }
+
+    const bool outputsMatch = std::ranges::all_of(results, &ProgramResult::outputsMatch);
+    return outputsMatch ? 0 : 1;
+}
@@ -0,0 +1,8 @@
+[long output: print every combination of three lowercase letters eight times
+Generated for goo_bench; every cell stays within 0 and 127 and no input is read]
+
+>>>>>>>>[-]++++++++++<<<<<<<[-]++++++++[>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++<[-]++++++++++++++++++++++++++[>>>[-]+++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++<[-]++++++++++++++++++++
+++++++[>>>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++<[-]++++++++++++++++++++++++++[<<<.>>.>>.>.<+<-]<+<-]<+<-]<-]
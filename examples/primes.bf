@@ -0,0 +1,18 @@
+[primes: print the primes below 128 using trial division
+Generated for goo_bench; every cell stays within 0 and 127 and no input is read]
+
+>[-]+>[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++[<+>>[-]+>[-]++>[-]<<<<[->>>>+>>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<
+<<<<<+>>>>>>>>>>]<<<<<<--[>[-]<<<<<[->>>>>+>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<[-
+]<<<[->>>+>>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<[-]<<[->>+<->>[-]+>[-]<<<[->>>+>+<<<<]>>>>[-<<<<+
+>>>>]<[[-]<[-]>]<[[-]<<<<<[->>>+>>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<[-]>]<<<]>[-]>>[-]+>[-]<<[-
+>>+>+<<<]>>>[-<<<+>>>]<[[-]<[-]>]<[[-]<<<<<<[-]>>>>>>]<[-]<<<<+>-]<<[[-]>>>[-]>>>>>>>>>[-]<[-]<[-]<<
+<<<<<<<<<<[->>>>>+>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<[-]++++++++++<[->>>>>>>>>+<
+<<<<<<<->>[-]+>[-]<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[[-]<[-]>]<[[-]<<[-]++++++++++>>>>>>>>[-]<+<<<<<]
+<<<]>>>>>>>>[-<<<<<<<<+>>>>>+>>>]<<<[->>>+<<<]>>>[-]<<<<<<<[-]++++++++++<[->>>>>>>>+<<<<<<<->>[-]+>[
+-]<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[[-]<[-]>]<[[-]<<[-]++++++++++>>>>>>>[-]<+<<<<]<<<]>[-]>>>>>>>>>[
+-]<<<<[-]>[-<+<+>>]<<[->>+<<]>[[-]>>>>[-]+<<<<][-]>>[-<<+<+>>>]<<<[->>>+<<<]>[[-]>>>>[-]+<<<<][-]>[-
+<+<+>>]<<[->>+<<]>[[-]>++++++++++++++++++++++++++++++++++++++++++++++++.----------------------------
+--------------------<]>>>>[[-]<<++++++++++++++++++++++++++++++++++++++++++++++++.-------------------
+----------------------------->>]<++++++++++++++++++++++++++++++++++++++++++++++++.[-]<[-]<[-]>>>>[-]
+++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<<<<]<-]>>>>>>>>>>>>>>>[-]++++++++++.[-]
@@ -7,89 +7,145 @@
 #include <format>
 
 namespace goo {
-    StringAsmBuilder::StringAsmBuilder() {
-        code = "bits 64\n\n";
-        code += "section .bss\n\n";
-        code += "\ttape: resb 30000\n\n";
-
-        code += "\tglobal _start\n\n";
-
-        code += "section .text\n\n";
+    StringAsmBuilder::StringAsmBuilder(const int tapeSize) {
+        // The padding directly precedes the tape, as .bss is laid out in order, and the end of the tape is padded by
+        // reserving additional cells.
+        resb("tapePadding", TAPE_PADDING);
+        resb("tape", tapeSize + TAPE_PADDING);
 
         label("_start");
         mov("rbx", "0");
     }
 
     std::string StringAsmBuilder::build() const {
-        return code;
+        std::string result = "bits 64\n\n";
+        result += "section .bss\n\n";
+        result += bss;
+
+        result += "\tglobal _start\n\n";
+
+        result += "section .text\n\n";
+        result += code;
+
+        if (!rodata.empty()) {
+            result += "\n\nsection .rodata\n\n";
+            result += rodata;
+        }
+
+        return result;
     }
 
-    AsmBuilder& StringAsmBuilder::mov(std::string dest, std::string src) {
+    AsmBuilder& StringAsmBuilder::mov(const std::string &dest, const std::string &src) {
         code += std::format("\n\tmov {}, {}", dest, src);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::label(std::string name) {
+    AsmBuilder &StringAsmBuilder::label(const std::string &name) {
         code += std::format("\n{}:", name);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::x_or(std::string dest, std::string src) {
+    AsmBuilder &StringAsmBuilder::x_or(const std::string &dest, const std::string &src) {
         code += std::format("\n\txor {}, {}", dest, src);
         return *this;
     }
 
+    AsmBuilder &StringAsmBuilder::a_nd(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tand {}, {}", dest, src);
+        return *this;
+    }
+
     AsmBuilder &StringAsmBuilder::syscall() {
         code += "\n\tsyscall";
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::add(std::string dest, std::string src) {
+    AsmBuilder &StringAsmBuilder::add(const std::string &dest, const std::string &src) {
         code += std::format("\n\tadd {}, {}", dest, src);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::sub(std::string dest, std::string src) {
+    AsmBuilder &StringAsmBuilder::sub(const std::string &dest, const std::string &src) {
         code += std::format("\n\tsub {}, {}", dest, src);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::mul(std::string src) {
+    AsmBuilder &StringAsmBuilder::mul(const std::string &src) {
         code += std::format("\n\tmul {}", src);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::lea(std::string dest, std::string src) {
+    AsmBuilder &StringAsmBuilder::lea(const std::string &dest, const std::string &src) {
         code += std::format("\n\tlea {}, {}", dest, src);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::cmp(std::string dest, std::string src) {
+    AsmBuilder &StringAsmBuilder::cmp(const std::string &dest, const std::string &src) {
         code += std::format("\n\tcmp {}, {}", dest, src);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::jmp(std::string label) {
+    AsmBuilder &StringAsmBuilder::jmp(const std::string &label) {
         code += std::format("\n\tjmp {}", label);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::jg(std::string label) {
+    AsmBuilder &StringAsmBuilder::je(const std::string &label) {
+        code += std::format("\n\tje {}", label);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::jne(const std::string &label) {
+        code += std::format("\n\tjne {}", label);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::jg(const std::string &label) {
         code += std::format("\n\tjg {}", label);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::jle(std::string label) {
+    AsmBuilder &StringAsmBuilder::jle(const std::string &label) {
         code += std::format("\n\tjle {}", label);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::jge(std::string label) {
+    AsmBuilder &StringAsmBuilder::jge(const std::string &label) {
         code += std::format("\n\tjge {}", label);
         return *this;
     }
 
-    AsmBuilder &StringAsmBuilder::comment(std::string comment) {
+    AsmBuilder &StringAsmBuilder::movdqu(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tmovdqu {}, {}", dest, src);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::pxor(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tpxor {}, {}", dest, src);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::pcmpeqb(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tpcmpeqb {}, {}", dest, src);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::pmovmskb(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tpmovmskb {}, {}", dest, src);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::bsf(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tbsf {}, {}", dest, src);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::bsr(const std::string &dest, const std::string &src) {
+        code += std::format("\n\tbsr {}, {}", dest, src);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::comment(const std::string &comment) {
         code += std::format(" ; {}", comment);
         return *this;
     }
@@ -98,4 +154,35 @@ namespace goo {
         code += "\n";
         return *this;
     }
+
+    AsmBuilder &StringAsmBuilder::align(const int alignment) {
+        code += std::format("\n\talign {}", alignment);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::resb(const std::string &name, const std::size_t size) {
+        bss += std::format("\t{}: resb {}\n\n", name, size);
+        return *this;
+    }
+
+    AsmBuilder &StringAsmBuilder::db(const std::string &name, const std::string &bytes) {
+        rodata += defineBytes(name, bytes);
+        return *this;
+    }
+
+    std::string defineBytes(const std::string &name, const std::string &bytes) {
+        std::string definition = std::format("\t{}:", name);
+
+        for (std::size_t idx = 0; idx < bytes.size(); idx++) {
+            if (idx % 16 == 0) {
+                definition += idx == 0 ? " db " : "\n\tdb ";
+            } else {
+                definition += ", ";
+            }
+
+            definition += std::to_string(static_cast<unsigned char>(bytes[idx]));
+        }
+
+        return definition + "\n\n";
+    }
 } // goo
\ No newline at end of file
@@ -4,8 +4,11 @@
 
 #ifndef ASMBUILDER_H
 #define ASMBUILDER_H
+#include <cstddef>
 #include <string>
 
+#include "Tape.h"
+
 namespace goo {
     /// A builder class that abstracts away the syntax and formatting of
     /// assembler code. Each method translates directly to its assembler
@@ -28,78 +31,139 @@ namespace goo {
         /// @return The complete assembler code produced by the builder.
         [[nodiscard]] virtual std::string build() const = 0;
 
-        virtual AsmBuilder &mov(std::string dest, std::string src) = 0;
+        virtual AsmBuilder &mov(const std::string &dest, const std::string &src) = 0;
+
+        virtual AsmBuilder &label(const std::string &name) = 0;
 
-        virtual AsmBuilder &label(std::string name) = 0;
+        virtual AsmBuilder &x_or(const std::string &dest, const std::string &src) = 0;
 
-        virtual AsmBuilder &x_or(std::string dest, std::string src) = 0;
+        virtual AsmBuilder &a_nd(const std::string &dest, const std::string &src) = 0;
 
         virtual AsmBuilder &syscall() = 0;
 
-        virtual AsmBuilder &add(std::string dest, std::string src) = 0;
+        virtual AsmBuilder &add(const std::string &dest, const std::string &src) = 0;
+
+        virtual AsmBuilder &sub(const std::string &dest, const std::string &src) = 0;
+
+        virtual AsmBuilder &mul(const std::string &src) = 0;
+
+        virtual AsmBuilder &lea(const std::string &dest, const std::string &src) = 0;
+
+        virtual AsmBuilder &cmp(const std::string &dest, const std::string &src) = 0;
+
+        virtual AsmBuilder &jmp(const std::string &label) = 0;
 
-        virtual AsmBuilder &sub(std::string dest, std::string src) = 0;
+        virtual AsmBuilder &je(const std::string &label) = 0;
 
-        virtual AsmBuilder &mul(std::string src) = 0;
+        virtual AsmBuilder &jne(const std::string &label) = 0;
 
-        virtual AsmBuilder &lea(std::string dest, std::string src) = 0;
+        virtual AsmBuilder &jg(const std::string &label) = 0;
 
-        virtual AsmBuilder &cmp(std::string dest, std::string src) = 0;
+        virtual AsmBuilder &jle(const std::string &label) = 0;
 
-        virtual AsmBuilder &jmp(std::string label) = 0;
+        virtual AsmBuilder &jge(const std::string &label) = 0;
 
-        virtual AsmBuilder &jg(std::string label) = 0;
+        /// Loads 16 unaligned bytes from memory into an xmm register.
+        virtual AsmBuilder &movdqu(const std::string &dest, const std::string &src) = 0;
 
-        virtual AsmBuilder &jle(std::string label) = 0;
+        virtual AsmBuilder &pxor(const std::string &dest, const std::string &src) = 0;
 
-        virtual AsmBuilder &jge(std::string label) = 0;
+        /// Compares the 16 bytes of two xmm registers, setting each byte of dest to 0xFF if they are equal, otherwise 0.
+        virtual AsmBuilder &pcmpeqb(const std::string &dest, const std::string &src) = 0;
+
+        /// Moves the most significant bit of each of the 16 bytes of an xmm register into the lower 16 bits of dest.
+        virtual AsmBuilder &pmovmskb(const std::string &dest, const std::string &src) = 0;
+
+        /// Stores the index of the lowest set bit of src in dest.
+        virtual AsmBuilder &bsf(const std::string &dest, const std::string &src) = 0;
+
+        /// Stores the index of the highest set bit of src in dest.
+        virtual AsmBuilder &bsr(const std::string &dest, const std::string &src) = 0;
 
         /// Adds a comment to the current line, appending it via a semicolon.
-        virtual AsmBuilder &comment(std::string comment) = 0;
+        virtual AsmBuilder &comment(const std::string &comment) = 0;
 
         virtual AsmBuilder &newLine() = 0;
+
+        /// Pads the code with NOPs, until its address is a multiple of `alignment`, which must be a power of 2.
+        virtual AsmBuilder &align(int alignment) = 0;
+
+        /// Reserves `size` uninitialized bytes in .bss, that can be referred to by `name`.
+        virtual AsmBuilder &resb(const std::string &name, std::size_t size) = 0;
+
+        /// Defines read-only bytes in .rodata, that can be referred to by `name`.
+        virtual AsmBuilder &db(const std::string &name, const std::string &bytes) = 0;
     };
 
+    /// Renders the definition of read-only bytes, as added by AsmBuilder::db, with at most 16 bytes per line.
+    std::string defineBytes(const std::string &name, const std::string &bytes);
+
     /// A concrete implementation of AsmBuilder that internally concatenates strings.
     /// The constructor already produces a boilerplate of assembler code, by providing
-    /// a tape of 30,000 byte size, as well as defining the _start label and clearing
-    /// rbx.
+    /// a tape of `tapeSize` bytes (30,000 by default), padded by TAPE_PADDING bytes on either
+    /// side, as well as defining the _start label and clearing rbx.
     class StringAsmBuilder final : public AsmBuilder {
+        std::string bss;
+        std::string rodata;
         std::string code;
     public:
-        StringAsmBuilder();
+        explicit StringAsmBuilder(int tapeSize = TAPE_SIZE);
 
         [[nodiscard]] std::string build() const override;
 
-        AsmBuilder &mov(std::string dest, std::string src) override;
+        AsmBuilder &mov(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &label(const std::string &name) override;
 
-        AsmBuilder &label(std::string name) override;
+        AsmBuilder &x_or(const std::string &dest, const std::string &src) override;
 
-        AsmBuilder &x_or(std::string dest, std::string src) override;
+        AsmBuilder &a_nd(const std::string &dest, const std::string &src) override;
 
         AsmBuilder &syscall() override;
 
-        AsmBuilder &add(std::string dest, std::string src) override;
+        AsmBuilder &add(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &sub(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &mul(const std::string &src) override;
+
+        AsmBuilder &lea(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &cmp(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &jmp(const std::string &label) override;
 
-        AsmBuilder &sub(std::string dest, std::string src) override;
+        AsmBuilder &je(const std::string &label) override;
 
-        AsmBuilder &mul(std::string src) override;
+        AsmBuilder &jne(const std::string &label) override;
 
-        AsmBuilder &lea(std::string dest, std::string src) override;
+        AsmBuilder &jg(const std::string &label) override;
 
-        AsmBuilder &cmp(std::string dest, std::string src) override;
+        AsmBuilder &jle(const std::string &label) override;
 
-        AsmBuilder &jmp(std::string label) override;
+        AsmBuilder &jge(const std::string &label) override;
 
-        AsmBuilder &jg(std::string label) override;
+        AsmBuilder &movdqu(const std::string &dest, const std::string &src) override;
 
-        AsmBuilder &jle(std::string label) override;
+        AsmBuilder &pxor(const std::string &dest, const std::string &src) override;
 
-        AsmBuilder &jge(std::string label) override;
+        AsmBuilder &pcmpeqb(const std::string &dest, const std::string &src) override;
 
-        AsmBuilder &comment(std::string comment) override;
+        AsmBuilder &pmovmskb(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &bsf(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &bsr(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &comment(const std::string &comment) override;
 
         AsmBuilder &newLine() override;
+
+        AsmBuilder &align(int alignment) override;
+
+        AsmBuilder &resb(const std::string &name, std::size_t size) override;
+
+        AsmBuilder &db(const std::string &name, const std::string &bytes) override;
     };
 
 
@@ -0,0 +1,292 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "AsmInstruction.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "Util.h"
+
+namespace goo {
+    namespace {
+        struct RegisterName {
+            const char *name;
+            X86Register reg;
+            std::uint8_t size;
+        };
+
+        constexpr RegisterName registerNames[] = {
+            {"rax", RAX, 8}, {"rcx", RCX, 8}, {"rdx", RDX, 8}, {"rbx", RBX, 8},
+            {"rsp", RSP, 8}, {"rbp", RBP, 8}, {"rsi", RSI, 8}, {"rdi", RDI, 8},
+            {"r8", R8, 8}, {"r9", R9, 8}, {"r10", R10, 8}, {"r11", R11, 8},
+            {"r12", R12, 8}, {"r13", R13, 8}, {"r14", R14, 8}, {"r15", R15, 8},
+            {"eax", RAX, 4}, {"ecx", RCX, 4}, {"edx", RDX, 4}, {"ebx", RBX, 4},
+            {"esp", RSP, 4}, {"ebp", RBP, 4}, {"esi", RSI, 4}, {"edi", RDI, 4},
+            {"r8d", R8, 4}, {"r9d", R9, 4}, {"r10d", R10, 4}, {"r11d", R11, 4},
+            {"r12d", R12, 4}, {"r13d", R13, 4}, {"r14d", R14, 4}, {"r15d", R15, 4},
+            {"al", RAX, 1}, {"cl", RCX, 1}, {"dl", RDX, 1}, {"bl", RBX, 1},
+            {"spl", RSP, 1}, {"bpl", RBP, 1}, {"sil", RSI, 1}, {"dil", RDI, 1},
+            {"r8b", R8, 1}, {"r9b", R9, 1}, {"r10b", R10, 1}, {"r11b", R11, 1},
+            {"r12b", R12, 1}, {"r13b", R13, 1}, {"r14b", R14, 1}, {"r15b", R15, 1},
+            {"xmm0", RAX, 16}, {"xmm1", RCX, 16}, {"xmm2", RDX, 16}, {"xmm3", RBX, 16},
+            {"xmm4", RSP, 16}, {"xmm5", RBP, 16}, {"xmm6", RSI, 16}, {"xmm7", RDI, 16},
+            {"xmm8", R8, 16}, {"xmm9", R9, 16}, {"xmm10", R10, 16}, {"xmm11", R11, 16},
+            {"xmm12", R12, 16}, {"xmm13", R13, 16}, {"xmm14", R14, 16}, {"xmm15", R15, 16},
+        };
+
+        const RegisterName *findRegister(const std::string &name) {
+            for (const auto &entry: registerNames) {
+                if (name == entry.name) {
+                    return &entry;
+                }
+            }
+
+            return nullptr;
+        }
+
+        const char *registerName(const X86Register reg, const std::uint8_t size) {
+            for (const auto &entry: registerNames) {
+                if (entry.reg == reg && entry.size == size) {
+                    return entry.name;
+                }
+            }
+
+            return "";
+        }
+
+        const char *sizePrefix(const std::uint8_t size) {
+            switch (size) {
+                case 1:
+                    return "byte ";
+                case 4:
+                    return "dword ";
+                case 8:
+                    return "qword ";
+                default:
+                    return "";
+            }
+        }
+
+        bool parseNumber(const std::string &value, std::int64_t &result) {
+            if (value.empty()) {
+                return false;
+            }
+
+            const std::size_t start = value[0] == '-' ? 1 : 0;
+            if (value.size() == start || !std::isdigit(static_cast<unsigned char>(value[start]))) {
+                return false;
+            }
+
+            char *end = nullptr;
+            result = std::strtoll(value.c_str(), &end, 0);
+            return *end == '\0';
+        }
+
+        /// Removes a size prefix such as "byte" from `operand` and returns the size in bytes, or 0 if there is none.
+        std::uint8_t takeSizePrefix(std::string &operand) {
+            constexpr std::pair<const char *, std::uint8_t> prefixes[] = {
+                {"byte ", 1}, {"dword ", 4}, {"qword ", 8}
+            };
+
+            for (const auto &[prefix, size]: prefixes) {
+                if (operand.starts_with(prefix)) {
+                    operand = stripWhitespace(operand.substr(strlen(prefix)));
+                    return size;
+                }
+            }
+
+            return 0;
+        }
+
+        /// Parses the content of brackets, for example "rax + rbx", "rel tape" or "tape + rbx".
+        bool parseMemory(std::string content, SymbolTable &symbols, AsmOperand &result) {
+            Memory mem;
+            X86Register registers[2] = {NO_REGISTER, NO_REGISTER};
+            int registerCount = 0;
+
+            if (content.starts_with("rel ")) {
+                mem.ripRelative = true;
+                content = content.substr(4);
+            }
+
+            std::size_t start = 0;
+            bool negative = false;
+
+            while (start <= content.size()) {
+                const auto end = content.find_first_of("+-", start);
+                const auto term = stripWhitespace(content.substr(start, end == std::string::npos ? end : end - start));
+
+                if (std::int64_t value; parseNumber(term, value)) {
+                    mem.disp += static_cast<std::int32_t>(negative ? -value : value);
+                } else if (const auto reg = findRegister(term); reg != nullptr && reg->size == 8 && !negative) {
+                    if (registerCount == 2) {
+                        return false;
+                    }
+
+                    registers[registerCount++] = reg->reg;
+                } else if (!term.empty() && !negative && result.symbol < 0) {
+                    result.symbol = symbols.intern(term);
+                } else {
+                    return false;
+                }
+
+                if (end == std::string::npos) {
+                    break;
+                }
+
+                negative = content[end] == '-';
+                start = end + 1;
+            }
+
+            if (mem.ripRelative && registerCount > 0) {
+                return false;
+            }
+
+            if (result.symbol >= 0 && !mem.ripRelative && registerCount == 1) {
+                // [symbol + reg] requires an absolute 32-bit address, therefor the register must be used as index.
+                mem.index = registers[0];
+            } else {
+                mem.base = registers[0];
+                mem.index = registers[1];
+            }
+
+            result.kind = OPERAND_MEMORY;
+            result.mem = mem;
+            return true;
+        }
+    }
+
+    int SymbolTable::intern(const std::string &name) {
+        if (const auto it = ids.find(name); it != ids.end()) {
+            return it->second;
+        }
+
+        names.push_back(name);
+        ids[name] = static_cast<int>(names.size() - 1);
+        return static_cast<int>(names.size() - 1);
+    }
+
+    bool parseOperand(const std::string &operand, SymbolTable &symbols, AsmOperand &result) {
+        result = AsmOperand{};
+
+        auto value = stripWhitespace(operand);
+        result.size = takeSizePrefix(value);
+
+        if (value.starts_with("[") && value.ends_with("]")) {
+            return parseMemory(stripWhitespace(value.substr(1, value.size() - 2)), symbols, result);
+        }
+
+        if (parseNumber(value, result.imm)) {
+            result.kind = OPERAND_IMMEDIATE;
+            return true;
+        }
+
+        if (const auto reg = findRegister(value); reg != nullptr) {
+            if (result.size != 0 && result.size != reg->size) {
+                return false;
+            }
+
+            result.kind = OPERAND_REGISTER;
+            result.reg = reg->reg;
+            result.size = reg->size;
+            return true;
+        }
+
+        if (value.empty() || value.find_first_of(" []") != std::string::npos) {
+            return false;
+        }
+
+        result.kind = OPERAND_SYMBOL;
+        result.symbol = symbols.intern(value);
+        return true;
+    }
+
+    std::string renderOperand(const AsmOperand &operand, const SymbolTable &symbols) {
+        switch (operand.kind) {
+            case OPERAND_REGISTER:
+                return registerName(operand.reg, operand.size);
+            case OPERAND_IMMEDIATE:
+                return sizePrefix(operand.size) + std::to_string(operand.imm);
+            case OPERAND_SYMBOL:
+                return symbols.name(operand.symbol);
+            case OPERAND_MEMORY:
+                break;
+            default:
+                return "";
+        }
+
+        const auto &mem = operand.mem;
+        std::string terms;
+
+        const auto addTerm = [&terms](const std::string &term) {
+            terms += terms.empty() ? term : " + " + term;
+        };
+
+        if (operand.symbol >= 0) addTerm(symbols.name(operand.symbol));
+        if (mem.base != NO_REGISTER) addTerm(registerName(mem.base, 8));
+        if (mem.index != NO_REGISTER) addTerm(registerName(mem.index, 8));
+
+        if (mem.disp < 0) {
+            terms += " - " + std::to_string(-static_cast<std::int64_t>(mem.disp));
+        } else if (mem.disp > 0 || terms.empty()) {
+            addTerm(std::to_string(mem.disp));
+        }
+
+        return std::string(sizePrefix(operand.size)) + "[" + (mem.ripRelative ? "rel " : "") + terms + "]";
+    }
+
+    const char *mnemonic(const AsmOpcode opcode) {
+        switch (opcode) {
+            case ASM_MOV:
+                return "mov";
+            case ASM_XOR:
+                return "xor";
+            case ASM_AND:
+                return "and";
+            case ASM_SYSCALL:
+                return "syscall";
+            case ASM_ADD:
+                return "add";
+            case ASM_SUB:
+                return "sub";
+            case ASM_MUL:
+                return "mul";
+            case ASM_LEA:
+                return "lea";
+            case ASM_CMP:
+                return "cmp";
+            case ASM_JMP:
+                return "jmp";
+            case ASM_JE:
+                return "je";
+            case ASM_JNE:
+                return "jne";
+            case ASM_JG:
+                return "jg";
+            case ASM_JLE:
+                return "jle";
+            case ASM_JGE:
+                return "jge";
+            case ASM_MOVDQU:
+                return "movdqu";
+            case ASM_PXOR:
+                return "pxor";
+            case ASM_PCMPEQB:
+                return "pcmpeqb";
+            case ASM_PMOVMSKB:
+                return "pmovmskb";
+            case ASM_BSF:
+                return "bsf";
+            case ASM_BSR:
+                return "bsr";
+            case ASM_ALIGN:
+                return "align";
+            default:
+                return "";
+        }
+    }
+} // goo
@@ -0,0 +1,109 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef ASMINSTRUCTION_H
+#define ASMINSTRUCTION_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "X86Encoder.h"
+
+namespace goo {
+    /// The instructions that can be produced by an AsmBuilder, plus pseudo instructions for labels, comments and
+    /// empty lines, which only matter for the textual representation, as well as the alignment of the code.
+    enum AsmOpcode : std::uint8_t {
+        ASM_LABEL,
+        ASM_COMMENT,
+        ASM_NEW_LINE,
+        ASM_ALIGN,
+        ASM_MOV,
+        ASM_XOR,
+        ASM_AND,
+        ASM_SYSCALL,
+        ASM_ADD,
+        ASM_SUB,
+        ASM_MUL,
+        ASM_LEA,
+        ASM_CMP,
+        ASM_JMP,
+        ASM_JE,
+        ASM_JNE,
+        ASM_JG,
+        ASM_JLE,
+        ASM_JGE,
+        ASM_MOVDQU,
+        ASM_PXOR,
+        ASM_PCMPEQB,
+        ASM_PMOVMSKB,
+        ASM_BSF,
+        ASM_BSR
+    };
+
+    enum AsmOperandKind : std::uint8_t {
+        OPERAND_NONE,
+        OPERAND_REGISTER,
+        OPERAND_MEMORY,
+        OPERAND_IMMEDIATE,
+        OPERAND_SYMBOL
+    };
+
+    /// A single typed operand of an instruction. Memory operands may refer to a symbol (for example the tape), in
+    /// which case the address of the symbol is added to the displacement once it is known. The xmm registers have a
+    /// size of 16 and share their number with the general purpose register of the same encoding, e.g. xmm1 with RCX.
+    struct AsmOperand {
+        AsmOperandKind kind = OPERAND_NONE;
+
+        /// The size of the operand in bytes, or 0 if it isn't specified (for example for immediates).
+        std::uint8_t size = 0;
+
+        X86Register reg = NO_REGISTER;
+        Memory mem;
+
+        /// The interned symbol of memory operands or the label of jumps, otherwise -1. For comments, this is the index
+        /// of the comment.
+        int symbol = -1;
+
+        std::int64_t imm = 0;
+    };
+
+    struct AsmInstruction {
+        AsmOpcode opcode;
+        AsmOperand dest;
+        AsmOperand src;
+    };
+
+    /// Interns the names of labels and symbols, so that instructions only need to store an integer per reference.
+    class SymbolTable {
+        std::vector<std::string> names;
+        std::unordered_map<std::string, int> ids;
+
+    public:
+        /// Returns the id of the symbol, adding it to the table if necessary.
+        int intern(const std::string &name);
+
+        [[nodiscard]] const std::string &name(const int id) const { return names[id]; }
+
+        [[nodiscard]] std::size_t size() const { return names.size(); }
+    };
+
+    /// Parses an operand in NASM syntax, as it is passed to an AsmBuilder, for example "rbx", "byte [rax + rbx]",
+    /// "[rel tape]", "[tape + rbx]", "byte 0" or "29999". Any other word is treated as a symbol, for example a label.
+    /// @param operand The textual operand.
+    /// @param symbols The table to intern referenced symbols in.
+    /// @param result The parsed operand.
+    /// @return False if the operand couldn't be parsed.
+    bool parseOperand(const std::string &operand, SymbolTable &symbols, AsmOperand &result);
+
+    /// The reverse of ::parseOperand, which returns the operand in NASM syntax.
+    std::string renderOperand(const AsmOperand &operand, const SymbolTable &symbols);
+
+    /// Returns the NASM mnemonic of an instruction, or an empty string for pseudo instructions. ASM_ALIGN is rendered
+    /// as the directive `align`.
+    const char *mnemonic(AsmOpcode opcode);
+} // goo
+
+#endif //ASMINSTRUCTION_H
@@ -7,7 +7,6 @@
 #include <filesystem>
 #include <format>
 #include <fstream>
-#include <iostream>
 
 #include "Reporter.h"
 
@@ -24,7 +23,7 @@ namespace goo {
         }
 
         if (config.verbose) {
-            std::cout << "Created tmp file at: " << tmpPath << std::endl;
+            reporter.output() << "Created tmp file at: " << tmpPath << std::endl;
         }
 
         std::string cmd;
@@ -36,7 +35,7 @@ namespace goo {
         }
 
         if (config.verbose) {
-            std::cout << "Executing: " << cmd << std::endl;
+            reporter.output() << "Executing: " << cmd << std::endl;
         }
 
         if (const int result = system(cmd.c_str()); result != 0) {
@@ -46,7 +45,7 @@ namespace goo {
 
         fs::remove(tmpPath);
 
-        std::cout << "[Finished]" << std::endl;
+        reporter.output() << "[Finished]" << std::endl;
 
         return nullptr;
     }
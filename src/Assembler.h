@@ -21,6 +21,8 @@ namespace goo {
         explicit Assembler(AssemblerConfig config, Reporter &reporter) : Phase(reporter), config(std::move(config)) {
         }
 
+        [[nodiscard]] std::string name() const override { return "assembler"; }
+
         /// Receives a payload of type StringPayload, writes the content of the payload to a temporary file and finally
         /// invokes nasm to create an ELF object-file.
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
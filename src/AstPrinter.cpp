@@ -15,19 +15,11 @@ namespace goo {
         output = "";
 
         const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
-        print(stmtPayload->stmts);
+        walk(stmtPayload->stmts);
 
         return std::make_shared<StringPayload>(StringPayload{.value = output});
     }
 
-    void AstPrinter::print(const std::vector<std::shared_ptr<Stmt> > &stmts) {
-        for (const auto &stmt: stmts) {
-            if (stmt != nullptr) {
-                stmt->accept(this);
-            }
-        }
-    }
-
     void AstPrinter::visitIncrementByte(IncrementByte *stmt) {
         output += std::format("{}<IncrementByte> {}:{}\n", indentation(), stmt->line, stmt->column);
     }
@@ -52,12 +44,16 @@ namespace goo {
         output += std::format("{}<Output> {}:{}\n", indentation(), stmt->line, stmt->column);
     }
 
-    void AstPrinter::visitConditional(Conditional *stmt) {
+    bool AstPrinter::enterConditional(Conditional *stmt) {
         output += std::format("{}<Conditional> {}:{}\n", indentation(), stmt->line, stmt->column);
 
         depth++;
-        print(stmt->stmts);
+        return true;
+    }
+
+    bool AstPrinter::leaveConditional(Conditional *) {
         depth--;
+        return false;
     }
 
     void AstPrinter::visitDebug(Debug *stmt) {
@@ -68,21 +64,33 @@ namespace goo {
         output += std::format("{}<Reset> {}:{}\n", indentation(), stmt->line, stmt->column);
     }
 
-    void AstPrinter::visitTransfer(Transfer *stmt) {
-        output += std::format("{}<Transfer> {}:{}\n", indentation(), stmt->line, stmt->column);
+    void AstPrinter::visitLinearLoop(LinearLoop *stmt) {
+        output += std::format("{}<LinearLoop> {}:{}\n", indentation(), stmt->line, stmt->column);
     }
 
-    void AstPrinter::visitMultiply(Multiply *stmt) {
-        output += std::format("{}<Multiply> {}:{}\n", indentation(), stmt->line, stmt->column);
+    void AstPrinter::visitScan(Scan *stmt) {
+        output += std::format("{}<Scan> {}:{}\n", indentation(), stmt->line, stmt->column);
+    }
+
+    void AstPrinter::visitConstOutput(ConstOutput *stmt) {
+        output += std::format("{}<ConstOutput> {}:{}\n", indentation(), stmt->line, stmt->column);
+    }
+
+    void AstPrinter::visitTapeInit(TapeInit *stmt) {
+        output += std::format("{}<TapeInit> {}:{}\n", indentation(), stmt->line, stmt->column);
     }
 
 
     std::string AstPrinter::indentation() const {
         std::string _indentation;
-        for (int i = 0; i < depth; i++) {
+        for (int i = 0; i < depth && i < MAX_INDENTATION; i++) {
             _indentation += "\t";
         }
 
+        if (depth > MAX_INDENTATION) {
+            _indentation += std::format("({}) ", depth);
+        }
+
         return _indentation;
     }
 } // goo
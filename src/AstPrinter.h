@@ -10,23 +10,32 @@
 #include "Stmt.h"
 
 namespace goo {
+    /// The deepest nesting that is indented by tabs alone, see AstPrinter::indentation.
+    constexpr int MAX_INDENTATION = 64;
+
     /// A debugging visitor that prints the abstract syntax tree to
     /// check for errors in transforming tokens to statements.
-    class AstPrinter final : public Phase, public Visitor {
+    class AstPrinter final : public Phase, public StmtWalker {
         /// The current depth of indentation, used primarily for
-        /// conditionals, which gets indented recursively.
+        /// conditionals, whose bodies get indented.
         int depth = 0;
         std::string output;
 
     public:
         explicit AstPrinter(Reporter &reporter) : Phase(reporter) {}
 
+        [[nodiscard]] std::string name() const override { return "ast-printer"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STRING; }
+
         /// Traverses a list of statements and prints the generated
         /// AST to standard out. Nullptr-entries are being ignored.
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
 
     private:
-        void print(const std::vector<std::shared_ptr<Stmt>>& stmts);
+        bool enterConditional(Conditional *stmt) override;
+
+        bool leaveConditional(Conditional *stmt) override;
 
         void visitIncrementByte(IncrementByte *stmt) override;
 
@@ -36,8 +45,6 @@ namespace goo {
 
         void visitDecrementPtr(DecrementPtr *stmt) override;
 
-        void visitConditional(Conditional *stmt) override;
-
         void visitOutput(Output *stmt) override;
 
         void visitInput(Input *stmt) override;
@@ -46,11 +53,16 @@ namespace goo {
 
         void visitReset(Reset *stmt) override;
 
-        void visitTransfer(Transfer *stmt) override;
+        void visitLinearLoop(LinearLoop *stmt) override;
+
+        void visitScan(Scan *stmt) override;
+
+        void visitConstOutput(ConstOutput *stmt) override;
 
-        void visitMultiply(Multiply *stmt) override;
+        void visitTapeInit(TapeInit *stmt) override;
 
-        /// Adds as many \t as the current value of depth holds to standard out.
+        /// Adds as many \t as the current value of depth holds to standard out, up to MAX_INDENTATION, followed by the
+        /// depth itself beyond it, as the output would grow quadratically with the depth otherwise.
         /// This method is called by every ::visitXYZ method and has thusly been moved to a separate function.
         std::string indentation() const;
     };
@@ -0,0 +1,124 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "Bytecode.h"
+
+namespace goo {
+    Bytecode BytecodeCompiler::compile(const StmtSpan stmts) {
+        bytecode = Bytecode{};
+        heads.clear();
+
+        walk(stmts);
+
+        bytecode.code.push_back(Instruction{.op = OP_HALT});
+        bytecode.positions.push_back(SourcePosition{});
+
+        return std::move(bytecode);
+    }
+
+    void BytecodeCompiler::emit(const Stmt *stmt, const OpCode op, const int arg, const int arg2) {
+        bytecode.code.push_back(Instruction{.op = op, .arg = arg, .arg2 = arg2});
+        bytecode.positions.push_back(SourcePosition{.line = stmt->line, .column = stmt->column});
+    }
+
+    void BytecodeCompiler::visitIncrementByte(IncrementByte *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            emit(stmt, OP_ADD_BYTE, stmt->count, stmt->offset);
+        } else {
+            emit(stmt, OP_INC_BYTE, stmt->count, stmt->offset);
+        }
+    }
+
+    void BytecodeCompiler::visitDecrementByte(DecrementByte *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            emit(stmt, OP_ADD_BYTE, -stmt->count, stmt->offset);
+        } else {
+            emit(stmt, OP_DEC_BYTE, stmt->count, stmt->offset);
+        }
+    }
+
+    void BytecodeCompiler::visitIncrementPtr(IncrementPtr *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            emit(stmt, OP_MOVE_PTR, stmt->count);
+        } else {
+            emit(stmt, OP_INC_PTR, stmt->count);
+        }
+    }
+
+    void BytecodeCompiler::visitDecrementPtr(DecrementPtr *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            emit(stmt, OP_MOVE_PTR, -stmt->count);
+        } else {
+            emit(stmt, OP_DEC_PTR, stmt->count);
+        }
+    }
+
+    bool BytecodeCompiler::enterConditional(Conditional *stmt) {
+        // The target of the head jump is only known after the body has been compiled, therefor we patch it afterward.
+        heads.push_back(static_cast<int>(bytecode.code.size()));
+        emit(stmt, OP_JUMP_IF_ZERO);
+
+        return true;
+    }
+
+    bool BytecodeCompiler::leaveConditional(Conditional *stmt) {
+        const int head = heads.back();
+        heads.pop_back();
+
+        // Jumping back to the first statement of the body instead of the head saves one check per iteration.
+        emit(stmt, OP_JUMP_IF_NOT_ZERO, head + 1);
+        bytecode.code[head].arg = static_cast<int>(bytecode.code.size());
+
+        return false;
+    }
+
+    void BytecodeCompiler::visitOutput(Output *stmt) {
+        emit(stmt, OP_OUTPUT, 0, stmt->offset);
+    }
+
+    void BytecodeCompiler::visitInput(Input *stmt) {
+        emit(stmt, OP_INPUT, 0, stmt->offset);
+    }
+
+    void BytecodeCompiler::visitDebug(Debug *stmt) {
+        emit(stmt, OP_DEBUG);
+    }
+
+    void BytecodeCompiler::visitReset(Reset *stmt) {
+        emit(stmt, OP_RESET, stmt->initialValue, stmt->tapePtrOffset);
+    }
+
+    void BytecodeCompiler::visitLinearLoop(LinearLoop *stmt) {
+        // A linear loop is lowered to one instruction per target, skipped entirely if the counter is 0.
+        const auto head = static_cast<int>(bytecode.code.size());
+        emit(stmt, OP_JUMP_IF_ZERO);
+
+        for (const auto &[offset, factor]: stmt->targets) {
+            emit(stmt, cellSemantics == CELLS_WRAP8 ? OP_MULTIPLY_ADD_WRAP8 : OP_MULTIPLY_ADD, offset, factor);
+        }
+
+        emit(stmt, OP_RESET, 0, 0);
+        bytecode.code[head].arg = static_cast<int>(bytecode.code.size());
+    }
+
+    void BytecodeCompiler::visitScan(Scan *stmt) {
+        emit(stmt, cellSemantics == CELLS_WRAP8 ? OP_SCAN_WRAP8 : OP_SCAN, stmt->stride);
+    }
+
+    void BytecodeCompiler::visitConstOutput(ConstOutput *stmt) {
+        emit(stmt, OP_OUTPUT_STRING, static_cast<int>(bytecode.strings.size()));
+        bytecode.strings.push_back(stmt->value);
+    }
+
+    void BytecodeCompiler::visitTapeInit(TapeInit *stmt) {
+        // With the tape pointer at 0, the offset of each cell is its position.
+        emit(stmt, OP_SET_PTR, 0);
+
+        for (const auto &[position, value]: stmt->cells) {
+            emit(stmt, OP_RESET, value, position);
+        }
+
+        emit(stmt, OP_SET_PTR, stmt->tapePtr);
+    }
+} // goo
@@ -0,0 +1,135 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Stmt.h"
+#include "Tape.h"
+
+namespace goo {
+    /// The operations understood by the BytecodeInterpreter. Most opcodes map directly to a statement type, except for
+    /// conditionals, which are lowered to a pair of jumps with precomputed targets.
+    enum OpCode : std::uint8_t {
+        OP_INC_BYTE,
+        OP_DEC_BYTE,
+        OP_INC_PTR,
+        OP_DEC_PTR,
+        OP_JUMP_IF_ZERO,
+        OP_JUMP_IF_NOT_ZERO,
+        OP_OUTPUT,
+        OP_INPUT,
+        OP_DEBUG,
+        OP_RESET,
+        OP_MULTIPLY_ADD,
+        OP_ADD_BYTE,
+        OP_MOVE_PTR,
+        OP_MULTIPLY_ADD_WRAP8,
+        OP_SCAN,
+        OP_SCAN_WRAP8,
+        OP_OUTPUT_STRING,
+        OP_SET_PTR,
+        OP_HALT
+    };
+
+    /// A single fixed-size instruction. The meaning of the arguments depends on the opcode:
+    ///
+    /// - OP_INC_BYTE, OP_DEC_BYTE: arg is the count, arg2 the tape pointer offset.
+    /// - OP_INC_PTR, OP_DEC_PTR: arg is the count.
+    /// - OP_OUTPUT, OP_INPUT: arg2 is the tape pointer offset.
+    /// - OP_JUMP_IF_ZERO, OP_JUMP_IF_NOT_ZERO: arg is the index of the instruction to jump to.
+    /// - OP_RESET: arg is the initial value, arg2 the tape pointer offset.
+    /// - OP_MULTIPLY_ADD: adds the byte at the tape pointer times arg2 to the byte at the offset arg.
+    /// - OP_SCAN: moves the tape pointer by the signed stride arg until the byte at it is 0.
+    /// - OP_OUTPUT_STRING: arg is the index of the string in Bytecode::strings to write.
+    /// - OP_SET_PTR: arg is the absolute position to move the tape pointer to.
+    ///
+    /// The opcodes OP_ADD_BYTE, OP_MOVE_PTR, OP_MULTIPLY_ADD_WRAP8 and OP_SCAN_WRAP8 are only used for CELLS_WRAP8,
+    /// as they rely on native 8-bit arithmetic and a masked tape pointer:
+    ///
+    /// - OP_ADD_BYTE: arg is the signed amount to add, arg2 the tape pointer offset.
+    /// - OP_MOVE_PTR: arg is the signed amount to add.
+    /// - OP_MULTIPLY_ADD_WRAP8: same as OP_MULTIPLY_ADD.
+    /// - OP_SCAN_WRAP8: same as OP_SCAN.
+    struct Instruction {
+        OpCode op;
+        int arg;
+        int arg2;
+    };
+
+    /// The location in code an instruction was compiled from. Kept separate from Instruction, as it is only needed
+    /// when reporting warnings or errors.
+    struct SourcePosition {
+        int line;
+        int column;
+    };
+
+    /// A flat program of instructions, always terminated by OP_HALT.
+    struct Bytecode {
+        std::vector<Instruction> code;
+        std::vector<SourcePosition> positions;
+
+        /// The constant strings written by OP_OUTPUT_STRING.
+        std::vector<std::string> strings;
+    };
+
+    /// Lowers a list of statements into a flat list of instructions. Conditionals are translated into an
+    /// OP_JUMP_IF_ZERO at the head and an OP_JUMP_IF_NOT_ZERO at the end of the loop, both pointing past each other,
+    /// so that no recursion is necessary during execution.
+    class BytecodeCompiler final : public StmtWalker {
+        Bytecode bytecode;
+
+        /// The index of the OP_JUMP_IF_ZERO at the head of each conditional that is being compiled, innermost last.
+        std::vector<int> heads;
+
+        const CellSemantics cellSemantics;
+
+    public:
+        explicit BytecodeCompiler(const CellSemantics cellSemantics = CELLS_COMPAT) : cellSemantics(cellSemantics) {
+        }
+
+        /// Compiles the statements into a new bytecode program. Nullptr-entries are being ignored.
+        /// @param stmts A list of statements to compile.
+        /// @return The compiled program, terminated by OP_HALT.
+        Bytecode compile(StmtSpan stmts);
+
+    private:
+        void emit(const Stmt *stmt, OpCode op, int arg = 0, int arg2 = 0);
+
+        void visitIncrementByte(IncrementByte *stmt) override;
+
+        void visitDecrementByte(DecrementByte *stmt) override;
+
+        void visitIncrementPtr(IncrementPtr *stmt) override;
+
+        void visitDecrementPtr(DecrementPtr *stmt) override;
+
+        bool enterConditional(Conditional *stmt) override;
+
+        bool leaveConditional(Conditional *stmt) override;
+
+        void visitOutput(Output *stmt) override;
+
+        void visitInput(Input *stmt) override;
+
+        void visitDebug(Debug *stmt) override;
+
+        void visitReset(Reset *stmt) override;
+
+        void visitLinearLoop(LinearLoop *stmt) override;
+
+        void visitScan(Scan *stmt) override;
+
+        void visitConstOutput(ConstOutput *stmt) override;
+
+        void visitTapeInit(TapeInit *stmt) override;
+    };
+} // goo
+
+#endif //BYTECODE_H
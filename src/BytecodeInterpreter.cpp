@@ -0,0 +1,193 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "BytecodeInterpreter.h"
+
+#include <format>
+
+#include "Interpreter.h"
+#include "Reporter.h"
+
+namespace goo {
+    BytecodeInterpreter::BytecodeInterpreter(Reporter &reporter, std::ostream &out,
+                                             const CellSemantics cellSemantics): Phase(reporter), tapePtr(0), io(out),
+        cellSemantics(cellSemantics), compiler(cellSemantics) {
+        tape = allocateTape(cellSemantics);
+    }
+
+    BytecodeInterpreter::~BytecodeInterpreter() {
+        freeTape(tape);
+        tape = nullptr;
+
+        tapePtr = 0;
+    }
+
+    std::shared_ptr<Payload> BytecodeInterpreter::run(const std::shared_ptr<Payload> payload) {
+        const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
+
+        execute(compiler.compile(stmtPayload->stmts));
+        io.flush();
+
+        return nullptr;
+    }
+
+    void BytecodeInterpreter::execute(const Bytecode &bytecode) {
+        // We keep the tape and the tape pointer in locals, so that the compiler is free to keep them in registers
+        // for the whole loop. The tape pointer is written back once the program halts.
+        char *const tape = this->tape;
+        const CellSemantics cellSemantics = this->cellSemantics;
+        int ptr = tapePtr;
+
+        const Instruction *code = bytecode.code.data();
+        std::size_t pc = 0;
+
+        while (true) {
+            const Instruction &instruction = code[pc];
+
+            switch (instruction.op) {
+                case OP_INC_BYTE: {
+                    char &cell = tape[cellPosition(ptr, instruction.arg2, CELLS_COMPAT)];
+                    cell += instruction.arg;
+                    if (cell < 0) {
+                        cell += 128;
+                    }
+                    break;
+                }
+                case OP_DEC_BYTE: {
+                    char &cell = tape[cellPosition(ptr, instruction.arg2, CELLS_COMPAT)];
+                    cell -= instruction.arg;
+                    if (cell < 0) {
+                        cell = 128 + cell;
+                    }
+                    break;
+                }
+                case OP_INC_PTR:
+                    ptr += instruction.arg;
+                    if (ptr >= TAPE_SIZE) {
+                        const auto &position = bytecode.positions[pc];
+                        reporter.warning(position.line, position.column,
+                            "Attempted to move the tape pointer beyond the bounds of 30,000. Wrapping back to 0.");
+                        ptr -= TAPE_SIZE;
+                    }
+                    break;
+                case OP_DEC_PTR:
+                    ptr -= instruction.arg;
+                    if (ptr < 0) {
+                        const auto &position = bytecode.positions[pc];
+                        reporter.warning(position.line, position.column,
+                            "Attempted to move the tape pointer below 0. Wrapping back to 29,999.");
+                        ptr = TAPE_SIZE + ptr;
+                    }
+                    break;
+                case OP_JUMP_IF_ZERO:
+                    if (tape[ptr] == 0) {
+                        pc = instruction.arg;
+                        continue;
+                    }
+                    break;
+                case OP_JUMP_IF_NOT_ZERO:
+                    if (tape[ptr] != 0) {
+                        pc = instruction.arg;
+                        continue;
+                    }
+                    break;
+                case OP_OUTPUT:
+                    io.write(tape[cellPosition(ptr, instruction.arg2, cellSemantics)]);
+                    break;
+                case OP_INPUT:
+                    if (io.read(tape[cellPosition(ptr, instruction.arg2, cellSemantics)]) == READ_ERROR) {
+                        const auto &position = bytecode.positions[pc];
+                        reporter.error(position.line, position.column, "Failed to read user input.");
+
+                        // Reading input is the only operation that can fail, so we only need to check here.
+                        tapePtr = ptr;
+                        return;
+                    }
+                    break;
+                case OP_DEBUG:
+                    tapePtr = ptr;
+                    debug(bytecode.positions[pc]);
+                    break;
+                case OP_RESET:
+                    tape[cellPosition(ptr, instruction.arg2, cellSemantics)] = static_cast<char>(instruction.arg);
+                    break;
+                case OP_MULTIPLY_ADD: {
+                    // Like the Interpreter, the result is kept between 0 and 127.
+                    char &cell = tape[cellPosition(ptr, instruction.arg, CELLS_COMPAT)];
+                    cell = static_cast<char>((cell + static_cast<unsigned char>(tape[ptr]) * instruction.arg2) & 127);
+                    break;
+                }
+                case OP_ADD_BYTE:
+                    tape[cellPosition(ptr, instruction.arg2, CELLS_WRAP8)] += instruction.arg;
+                    break;
+                case OP_MOVE_PTR:
+                    ptr = (ptr + instruction.arg) & (WRAP8_TAPE_SIZE - 1);
+                    break;
+                case OP_MULTIPLY_ADD_WRAP8: {
+                    const int copyAddr = cellPosition(ptr, instruction.arg, CELLS_WRAP8);
+                    tape[copyAddr] += static_cast<char>(static_cast<unsigned char>(tape[ptr]) * instruction.arg2);
+                    break;
+                }
+                case OP_SCAN:
+                    ptr = scanTape(tape, TAPE_SIZE, ptr, instruction.arg);
+
+                    // If the search reaches the end of the tape, we wrap around like OP_INC_PTR and OP_DEC_PTR and
+                    // execute the instruction once again, to continue at the other end of the tape.
+                    if (tape[ptr] != 0) {
+                        const auto &position = bytecode.positions[pc];
+
+                        if (instruction.arg > 0) {
+                            reporter.warning(position.line, position.column,
+                                "Attempted to move the tape pointer beyond the bounds of 30,000. Wrapping back to 0.");
+                            ptr += instruction.arg - TAPE_SIZE;
+                        } else {
+                            reporter.warning(position.line, position.column,
+                                "Attempted to move the tape pointer below 0. Wrapping back to 29,999.");
+                            ptr += instruction.arg + TAPE_SIZE;
+                        }
+
+                        continue;
+                    }
+                    break;
+                case OP_SCAN_WRAP8:
+                    ptr = scanTape(tape, WRAP8_TAPE_SIZE, ptr, instruction.arg);
+
+                    if (tape[ptr] != 0) {
+                        ptr = (ptr + instruction.arg) & (WRAP8_TAPE_SIZE - 1);
+                        continue;
+                    }
+                    break;
+                case OP_OUTPUT_STRING:
+                    for (const char c: bytecode.strings[instruction.arg]) {
+                        io.write(c);
+                    }
+                    break;
+                case OP_SET_PTR:
+                    ptr = instruction.arg;
+                    break;
+                case OP_HALT:
+                    tapePtr = ptr;
+                    return;
+            }
+
+            pc++;
+        }
+    }
+
+    void BytecodeInterpreter::debug(const SourcePosition &position) {
+        io.flush();
+
+        auto &out = io.stream();
+        out << std::format("DEBUG: line = {}, column = {}, ptr = {}, tape = ", position.line, position.column,
+                           tapePtr);
+
+        for (int idx = 0; idx < tapeSize(cellSemantics); idx++) {
+            if (tape[idx] != 0) {
+                out << std::format("[{} = {}]", idx, tape[idx]);
+            }
+        }
+
+        out << std::endl;
+    }
+} // goo
@@ -0,0 +1,56 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef BYTECODEINTERPRETER_H
+#define BYTECODEINTERPRETER_H
+
+#include <iostream>
+
+#include "Bytecode.h"
+#include "InterpreterIo.h"
+#include "Payload.h"
+#include "Pipeline.h"
+
+namespace goo {
+    /// An alternative to the Interpreter that doesn't walk the statement-tree. Instead, the statements are first
+    /// compiled into a flat Bytecode program, which is then executed by a single dispatch loop. This avoids a virtual
+    /// call per statement, as well as walking the tree for every iteration of a conditional.
+    ///
+    /// The semantics of the tape are identical to the ones of the Interpreter, including the wrap-around guards and
+    /// the warnings reported when the tape pointer wraps around, for both CellSemantics. Like the Interpreter, the tape
+    /// is kept between successive calls of ::run, which makes it suitable for the REPL, and I/O goes through an
+    /// InterpreterIo that is flushed at the end of ::run.
+    class BytecodeInterpreter final : public Phase {
+        char *tape;
+        int tapePtr;
+
+        InterpreterIo io;
+
+        const CellSemantics cellSemantics;
+
+        BytecodeCompiler compiler;
+
+    public:
+        explicit BytecodeInterpreter(Reporter &reporter, std::ostream &out = std::cout,
+                                     CellSemantics cellSemantics = CELLS_COMPAT);
+        ~BytecodeInterpreter() override;
+
+        [[nodiscard]] std::string name() const override { return "bytecode-interpreter"; }
+
+        /// Compiles the list of statements into bytecode and executes it, modifying (if applicable) the internal tape.
+        /// Like Interpreter::run, no status code is returned, but the warning or error flag may be set.
+        /// @param payload A payload of type StmtPayload. Nullptr-entries are being ignored.
+        std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
+
+        /// Executes an already compiled program. The program must be terminated by OP_HALT.
+        /// @param bytecode The program to execute.
+        void execute(const Bytecode &bytecode);
+
+    private:
+        /// Prints the same debugging information as Interpreter::visitDebug.
+        void debug(const SourcePosition &position);
+    };
+} // goo
+
+#endif //BYTECODEINTERPRETER_H
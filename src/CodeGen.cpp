@@ -4,7 +4,10 @@
 
 #include "CodeGen.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <format>
+#include <optional>
 
 /*
  * Some notes on register usage:
@@ -13,24 +16,101 @@
  * rdi is unused.
  * rdx is used by increment/decrement ops, therefor it is unsafe to use it in a different context.
  * r8 to r11 may be used for storing data.
+ * r9b, r10b, r11b and r15b cache cells within straight-line code (see CodeGen::cachedCell), which are written back
+ * before any other statement, therefor r9 to r11 remain usable by other statements.
+ * xmm0 and xmm1 are used by scans, which compare 16 bytes of the tape at once (SSE2 is part of every x86-64 CPU).
+ *
+ * With buffered I/O, r12 stores the number of bytes in the output buffer, r13 the position within the input buffer
+ * and r14 the number of bytes in the input buffer. As they are preserved by syscalls, they are reserved for this.
+ *
+ * With CELLS_WRAP8 the tape is WRAP8_TAPE_SIZE bytes long, which allows us to wrap the tape pointer by masking it
+ * instead of comparing it, and cells simply wrap around as bytes do, without any guards.
+ *
+ * Cells relative to the tape pointer (see OffsetPass) are addressed as [rax + rcx], with their position computed into
+ * rcx and wrapped around either end of the tape like the tape pointer (see CodeGen::cellIndex). As syscalls clobber
+ * rcx, the position is computed anew for every statement.
+ *
+ * When profiling, the counters are 64-bit integers in .bss, which are increased in memory, therefor no register is
+ * reserved for them.
  */
 
 namespace goo {
+    namespace {
+        /// The size of each the output and the input buffer.
+        constexpr int IO_BUFFER_SIZE = 65536;
+
+        /// The registers that cache cells. syscall clobbers r11, which is no issue, as the cells are written back before
+        /// any I/O.
+        constexpr const char *CACHE_REGISTERS[] = {"r9b", "r10b", "r11b", "r15b"};
+
+        /// The alignment of the head of hot loops, which lets the CPU fetch the head at once.
+        constexpr int LOOP_ALIGNMENT = 16;
+
+        /// The number of statements that are looked ahead for further modifications of a cell, see
+        /// CodeGen::beforeStmt.
+        constexpr std::size_t CELL_LOOKAHEAD = 16;
+
+        /// Returns the offset of the cell that is modified by an increase, decrease or reset statement, or nullopt for
+        /// any other statement.
+        std::optional<int> modifiedOffset(const Stmt *stmt) {
+            switch (stmt->type) {
+                case INC_BYTE:
+                    return static_cast<const IncrementByte *>(stmt)->offset;
+                case DEC_BYTE:
+                    return static_cast<const DecrementByte *>(stmt)->offset;
+                case RESET:
+                    return static_cast<const Reset *>(stmt)->tapePtrOffset;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        /// The maximum number of statements of the body of a hot loop, which is unrolled if it doesn't contain any
+        /// further loops.
+        constexpr std::size_t UNROLL_MAX_STMTS = 8;
+
+        /// Returns the memory operand [base + offset], or [base - offset] for negative offsets.
+        std::string memory(const std::string &base, const int offset) {
+            if (offset > 0) {
+                return std::format("[{} + {}]", base, offset);
+            } else if (offset < 0) {
+                return std::format("[{} - {}]", base, -offset);
+            }
+
+            return std::format("[{}]", base);
+        }
+    }
+
     std::shared_ptr<Payload> CodeGen::run(const std::shared_ptr<Payload> payload) {
         // We always keep the address of the tape in rax
         builder->lea("rax", "[rel tape]");
 
+        if (config.bufferedIo) {
+            builder->resb("outBuf", IO_BUFFER_SIZE)
+                    .resb("inBuf", IO_BUFFER_SIZE)
+                    .mov("r12", "0")
+                    .mov("r13", "0")
+                    .mov("r14", "0");
+        }
+
         const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
+        loopProfile = stmtPayload->profile;
 
-        for (const auto stmts = stmtPayload->stmts; auto &stmt: stmts) {
-            if (stmt != nullptr) {
-                stmt->accept(this);
-            }
-        }
+        walk(stmtPayload->stmts);
+        writeBackCells();
 
         // After executing all commands we want to finalize our asm code by adding the exit syscall.
         // This also prevents successive calls to ::execute from creating an inconsistent state, as this exit command
         // kills the process.
+        // Programs that only write constant output, as computed by the PartialEvaluator, never use the buffer.
+        if (config.bufferedIo && usesOutputBuffer) {
+            flushOutput();
+        }
+
+        if (profiling()) {
+            writeProfile();
+        }
+
         const auto code = builder->mov("rax", "60")
                 .x_or("rdi", "rdi")
                 .syscall()
@@ -40,50 +120,74 @@ namespace goo {
     }
 
     void CodeGen::visitIncrementByte(IncrementByte *stmt) {
+        const auto cell = modifiedCell(stmt->offset);
+
+        if (wrap8()) {
+            builder->add(cell, std::to_string(stmt->count & 0xFF));
+
+            if (config.debugBuild) {
+                builder->comment(stmt->debugInfo());
+            }
+
+            return;
+        }
+
         const auto incGuard = std::format("incGuard{}", ++labelCounter);
 
         if (stmt->count == 1) {
-            builder->add("byte [rax + rbx]", "1");
+            builder->add(cell, "1");
 
             if (config.debugBuild) {
                 builder->comment(stmt->debugInfo());
             }
 
-            builder->cmp("byte [rax + rbx]", "0")
+            builder->cmp(cell, "0")
                     .jge(incGuard)
-                    .add("byte [rax + rbx]", "127");
+                    .add(cell, "127");
         } else {
             // We simply add [tape + rbx] + moves. In case of an overflow we wrap around and end up with a negative
             // number. Then we simply add 127 to make the number positive again.
-            builder->add("byte [rax + rbx]", std::to_string(stmt->count));
+            builder->add(cell, std::to_string(stmt->count));
 
             if (config.debugBuild) {
                 builder->comment(stmt->debugInfo());
             }
 
-            builder->cmp("byte [rax + rbx]", "0")
+            builder->cmp(cell, "0")
                     .jge(incGuard);
 
             // Now rbx is smaller than 0, we had an overflow. Therefor we add 128 to move to positive values.
-            builder->add("byte [rax + rbx]", "128");
+            builder->add(cell, "128");
         }
 
         builder->label(incGuard);
     }
 
     void CodeGen::visitDecrementByte(DecrementByte *stmt) {
+        const auto cell = modifiedCell(stmt->offset);
+
+        if (wrap8()) {
+            builder->sub(cell, std::to_string(stmt->count & 0xFF));
+
+            if (config.debugBuild) {
+                builder->comment(stmt->debugInfo());
+            }
+
+            return;
+        }
+
         const auto decGuard = std::format("decGuard{}", ++labelCounter);
 
         if (stmt->count == 1) {
-            builder->sub("byte [rax + rbx]", "1");
+            builder->sub(cell, "1");
 
             if (config.debugBuild) {
                 builder->comment(stmt->debugInfo());
             }
 
-            builder->cmp("byte [rax + rbx]", "0")
+            builder->cmp(cell, "0")
                     .jge(decGuard)
-                    .mov("byte [rax + rbx]", "127");
+                    .mov(cell, "127");
         } else {
             // There are two possible outcomes. First, moves is smaller or equal to the value in rbx. In this case we simply
             // subtract rbx-moves. Otherwise, we calculate 128 - (moves-rbx) and store this in rbx.
@@ -95,22 +199,35 @@ namespace goo {
                 builder->comment(stmt->debugInfo());
             }
 
-            builder->cmp("r8b", "byte [rax + rbx]")
+            builder->cmp("r8b", cell)
                     .jle(underflowGuard);
 
             // Now rdx is larger. Therefor we subtract rbx from rdx, write 128 into rbx and subtract rdx from rbx.
-            builder->sub("r8b", "byte [rax + rbx]")
-                    .mov("byte [rax + rbx]", "128")
+            builder->sub("r8b", cell)
+                    .mov(cell, "128")
                     .label(underflowGuard);
 
             // In any case we must subtract rdx from rbx, therefor we either jump directly to here or 'fall' through.
-            builder->sub("byte [rax + rbx]", "r8b");
+            builder->sub(cell, "r8b");
         }
 
         builder->label(decGuard);
     }
 
     void CodeGen::visitIncrementPtr(IncrementPtr *stmt) {
+        writeBackCells();
+
+        if (wrap8()) {
+            builder->add("rbx", std::to_string(stmt->count));
+
+            if (config.debugBuild) {
+                builder->comment(stmt->debugInfo());
+            }
+
+            builder->a_nd("rbx", std::to_string(WRAP8_TAPE_SIZE - 1));
+            return;
+        }
+
         const auto labelCounter = ++this->labelCounter;
         const auto ptrGuard = std::format("ptrGuard{}", labelCounter);
 
@@ -125,11 +242,8 @@ namespace goo {
 
             builder->cmp("rbx", "29999")
                     .jle(ptrGuard)
-                    .sub("rbx", "29999");
+                    .sub("rbx", std::to_string(TAPE_SIZE));
         } else {
-            // There are two possible outcomes. First, moves is smaller or equal to the value in rbx. In this case we simply
-            // subtract rbx-moves. Otherwise, we calculate 29,999 - (moves-rbx) and store this in rbx.
-
             builder->add("rbx", std::to_string(stmt->count));
 
             if (config.debugBuild) {
@@ -139,14 +253,27 @@ namespace goo {
             builder->cmp("rbx", "29999")
                     .jle(ptrGuard);
 
-            // Now rbx is larger than 29,999. Therefor we subtract 29,999 from rbx.
-            builder->sub("rbx", "29999");
+            // Now rbx is larger than 29,999. Therefor we subtract the size of the tape, like the Interpreter does.
+            builder->sub("rbx", std::to_string(TAPE_SIZE));
         }
 
         builder->label(ptrGuard);
     }
 
     void CodeGen::visitDecrementPtr(DecrementPtr *stmt) {
+        writeBackCells();
+
+        if (wrap8()) {
+            builder->sub("rbx", std::to_string(stmt->count));
+
+            if (config.debugBuild) {
+                builder->comment(stmt->debugInfo());
+            }
+
+            builder->a_nd("rbx", std::to_string(WRAP8_TAPE_SIZE - 1));
+            return;
+        }
+
         const auto ptrGuard = std::format("ptrGuard{}", ++labelCounter);
 
         if (stmt->count == 1) {
@@ -161,7 +288,7 @@ namespace goo {
                     .mov("rbx", "29999");
         } else {
             // There are two possible outcomes. First, moves is smaller or equal to the value in rbx. In this case we simply
-            // subtract rbx-moves. Otherwise, we calculate 29,999 - (moves-rbx) and store this in rbx.
+            // subtract rbx-moves. Otherwise, we calculate 30,000 - (moves-rbx) and store this in rbx.
             const auto underflowGuard = std::format("underflowGuard{}", labelCounter);
 
             builder->mov("rdx", std::to_string(stmt->count));
@@ -173,9 +300,9 @@ namespace goo {
             builder->cmp("rdx", "rbx")
                     .jle(underflowGuard);
 
-            // Now rdx is larger. Therefor we subtract rbx from rdx, write 29,999 into rbx and subtract rdx from rbx.
+            // Now rdx is larger. Therefor we subtract rbx from rdx, write 30,000 into rbx and subtract rdx from rbx.
             builder->sub("rdx", "rbx")
-                    .mov("rbx", "29999")
+                    .mov("rbx", std::to_string(TAPE_SIZE))
                     .label(underflowGuard);
 
             // In any case we must subtract rdx from rbx, therefor we either jump directly to here or 'fall' through.
@@ -186,6 +313,19 @@ namespace goo {
     }
 
     void CodeGen::visitInput(Input *stmt) {
+        writeBackCells();
+
+        if (profiling()) {
+            countProfile(INPUTS, stmt);
+        }
+
+        if (config.bufferedIo) {
+            bufferedInput(stmt);
+            return;
+        }
+
+        const auto index = cellIndex(stmt->offset);
+
         builder->mov("rax", "0");
 
         if (config.debugBuild) {
@@ -193,7 +333,7 @@ namespace goo {
         }
 
         builder->mov("rdi", "0")
-                .lea("rsi", "[tape + rbx]")
+                .lea("rsi", "[tape + " + index + "]")
                 .mov("rdx", "1")
                 .syscall()
                 .lea("rax", "[rel tape]")
@@ -201,6 +341,19 @@ namespace goo {
     }
 
     void CodeGen::visitOutput(Output *stmt) {
+        writeBackCells();
+
+        if (profiling()) {
+            countProfile(OUTPUTS, stmt);
+        }
+
+        if (config.bufferedIo) {
+            bufferedOutput(stmt);
+            return;
+        }
+
+        const auto index = cellIndex(stmt->offset);
+
         builder->mov("rax", "1");
 
         if (config.debugBuild) {
@@ -208,21 +361,32 @@ namespace goo {
         }
 
         builder->mov("rdi", "1")
-                .lea("rsi", "[tape + rbx]")
+                .lea("rsi", "[tape + " + index + "]")
                 .mov("rdx", "1")
                 .syscall()
                 .lea("rax", "[rel tape]")
                 .newLine();
     }
 
-    /// Creates the base structure of a loop and recursively calls
-    /// resolve for each statement. Because it is possible to have multiple
-    /// conditionals, even recursively so, we track the number of loops
-    /// and use it as a label.
-    void CodeGen::visitConditional(Conditional *stmt) {
+    /// Creates the head of a loop, whose body is translated next and followed by the tail added by
+    /// ::leaveConditional. Because it is possible to have multiple conditionals, even nested ones, we track the number
+    /// of loops and use it as a label.
+    bool CodeGen::enterConditional(Conditional *stmt) {
+        writeBackCells();
+
+        // Profiled programs keep the plain loops, so that each iteration is counted once.
+        if (isHotLoop(stmt)) {
+            return enterHotConditional(stmt);
+        }
+
         const auto loopLabel = std::format("loop{}", ++labelCounter);
         const auto exitLoopLabel = loopLabel + "Exit";
 
+        // The entries are counted before the loop label, as jumping back to it is an iteration.
+        if (profiling()) {
+            countProfile(LOOP_ENTRIES, stmt);
+        }
+
         // As we need to perform the loop-condition check first, we add it before translating any of the children
         // code.
         builder->newLine()
@@ -232,19 +396,102 @@ namespace goo {
             builder->comment(stmt->debugInfo());
         }
 
-        builder->cmp("byte [rax + rbx]", "byte 0")
-                .jle(exitLoopLabel)
-                .newLine();
+        // With wrapping cells, values above 127 are negative when compared as signed bytes, therefor we only check
+        // for zero.
+        builder->cmp("byte [rax + rbx]", "byte 0");
+
+        if (wrap8()) {
+            builder->je(exitLoopLabel);
+        } else {
+            builder->jle(exitLoopLabel);
+        }
+
+        builder->newLine();
+
+        if (profiling()) {
+            countProfile(LOOP_ITERATIONS, stmt);
+        }
 
-        for (const auto &s: stmt->stmts) {
-            s->accept(this);
+        loopLabels.push_back(loopLabel);
+        return true;
+    }
+
+    bool CodeGen::leaveConditional(Conditional *stmt) {
+        const auto loopLabel = loopLabels.back();
+        loopLabels.pop_back();
+
+        if (isHotLoop(stmt)) {
+            leaveHotConditional(loopLabel);
+            return false;
         }
 
+        writeBackCells();
+
         builder->jmp(loopLabel)
-                .label(exitLoopLabel);
+                .label(loopLabel + "Exit");
+
+        return false;
+    }
+
+    bool CodeGen::enterHotConditional(const Conditional *stmt) {
+        const auto loopLabel = std::format("hotLoop{}", ++labelCounter);
+        const auto exitLoopLabel = loopLabel + "Exit";
+
+        // Labels within the body are numbered on each translation, therefor the body may be translated twice.
+        const bool unrolled = stmt->stmts.size() <= UNROLL_MAX_STMTS && std::ranges::none_of(
+                                  stmt->stmts, [](const Stmt *s) { return s->type == IF; });
+
+        const auto exitIfZero = [&] {
+            writeBackCells();
+            builder->cmp("byte [rax + rbx]", "byte 0");
+
+            if (wrap8()) {
+                builder->je(exitLoopLabel);
+            } else {
+                builder->jle(exitLoopLabel);
+            }
+        };
+
+        builder->newLine();
+        exitIfZero();
+
+        if (config.debugBuild) {
+            builder->comment(stmt->debugInfo());
+        }
+
+        builder->align(LOOP_ALIGNMENT)
+                .label(loopLabel);
+
+        if (!unrolled) {
+            loopLabels.push_back(loopLabel);
+            return true;
+        }
+
+        // Without any nested loops, both copies of the body are translated right away.
+        walk(stmt->stmts);
+        exitIfZero();
+        walk(stmt->stmts);
+
+        leaveHotConditional(loopLabel);
+        return false;
+    }
+
+    void CodeGen::leaveHotConditional(const std::string &loopLabel) {
+        writeBackCells();
+        builder->cmp("byte [rax + rbx]", "byte 0");
+
+        if (wrap8()) {
+            builder->jne(loopLabel);
+        } else {
+            builder->jg(loopLabel);
+        }
+
+        builder->label(loopLabel + "Exit");
     }
 
     void CodeGen::visitDebug(Debug *stmt) {
+        writeBackCells();
+
         if (config.debugBuild) {
             builder->label(std::format("debug{}", ++labelCounter))
                     .mov("r8b", "byte [tape + rbx]")
@@ -253,98 +500,447 @@ namespace goo {
     }
 
     void CodeGen::visitReset(Reset *stmt) {
-        builder->mov("byte [rax + rbx]", std::to_string(stmt->initialValue));
+        builder->mov(modifiedCell(stmt->tapePtrOffset, false), std::to_string(stmt->initialValue));
 
         if (config.debugBuild) {
             builder->comment(stmt->debugInfo());
         }
     }
 
-    void CodeGen::visitTransfer(Transfer *stmt) {
-        // We store the original pointer in rax
-        builder->mov("r8", "rbx");
+    void CodeGen::visitLinearLoop(LinearLoop *stmt) {
+        writeBackCells();
+
+        const auto linearLoopExit = std::format("linearLoopExit{}", ++labelCounter);
+
+        if (profiling()) {
+            countProfile(LOOP_ENTRIES, stmt);
+        }
+
+        // Like any other loop, a linear loop doesn't run at all if the counter is 0.
+        builder->cmp("byte [rax + rbx]", "byte 0");
 
         if (config.debugBuild) {
             builder->comment(stmt->debugInfo());
         }
 
-        // We copy the current value in [tape + rbx] to r9b
-        builder->mov("r9b", "byte [rax + rbx]")
-                .mov("byte [rax + rbx]", "0");
+        if (wrap8()) {
+            builder->je(linearLoopExit);
+        } else {
+            builder->jle(linearLoopExit);
+        }
+
+        // We keep the counter in r9b, while the product of each target is computed in r10b.
+        builder->mov("r9b", "byte [rax + rbx]");
+
+        for (const auto &[offset, factor]: stmt->targets) {
+            std::string amount = "r9b";
+
+            if (factor != 1) {
+                // As multiply works like this: rax = rax * src, we move the factor to rax. Only the lower byte of the
+                // product is relevant, therefor an 8-bit multiplication suffices.
+                builder->mov("rax", std::to_string(factor & 0xFF))
+                        .mul("r9b")
+                        .mov("r10", "rax")
+                        .lea("rax", "[rel tape]");
+                amount = "r10b";
+            }
+
+            if (wrap8()) {
+                addToCellWrap8(offset, amount);
+            } else {
+                // Every iteration keeps the cell between 0 and 127, therefor the result is the sum modulo 128.
+                const auto target = cellAt(offset);
 
-        // Then we (ab)use our pointer inc/dec logic to move the pointer to the proper offset where to copy data to
-        if (stmt->offset > 0) {
-            const auto incPtr = new IncrementPtr(stmt->column, stmt->line, stmt->offset);
-            visitIncrementPtr(incPtr);
-            delete incPtr;
-        } else if (stmt->offset < 0) {
-            const auto decPtr = new DecrementPtr(stmt->column, stmt->line, -stmt->offset);
-            visitDecrementPtr(decPtr);
-            delete decPtr;
+                builder->add(target, amount)
+                        .a_nd(target, "127");
+            }
         }
 
-        const auto incGuard = std::format("incGuard{}", ++labelCounter);
+        builder->mov("byte [rax + rbx]", "0")
+                .label(linearLoopExit);
+    }
 
-        // rbx now points to the tape location where we want to copy the value in r9b to
-        builder->add("byte [rax + rbx]", "r9b")
-                .cmp("byte [rax + rbx]", "0")
-                .jge(incGuard);
+    void CodeGen::visitScan(Scan *stmt) {
+        writeBackCells();
+
+        const auto labelCounter = ++this->labelCounter;
+        const auto scan = std::format("scan{}", labelCounter);
+        const auto scanFound = std::format("scanFound{}", labelCounter);
+        const auto scanStep = std::format("scanStep{}", labelCounter);
+        const auto scanExit = std::format("scanExit{}", labelCounter);
+
+        const bool forward = stmt->stride > 0;
+        const int stride = std::abs(stmt->stride);
+
+        if (profiling()) {
+            countProfile(LOOP_ENTRIES, stmt);
+        }
+
+        // We compare 16 bytes at once, of which only every stride-th byte is visited by the loop. Therefor, larger
+        // strides are searched byte by byte, as are scans that are never reached according to the profile, as the
+        // byte by byte search takes less code.
+        const bool vectorized = stride < 16 && heat(stmt) != HEAT_COLD;
+
+        if (vectorized) {
+            builder->pxor("xmm1", "xmm1");
+        }
 
-        // Now rbx is smaller than 0, we had an overflow. Therefor we add 127 to move to positive values.
-        builder->add("byte [rax + rbx]", "127");
+        builder->label(scan)
+                .cmp("byte [rax + rbx]", "byte 0");
 
-        // Finally we reset our tape pointer to the original value, as a copy statement doesn't move the pointer.
-        builder->label(incGuard)
-                .mov("rbx", "r8");
+        if (config.debugBuild) {
+            builder->comment(stmt->debugInfo());
+        }
+
+        builder->je(scanExit);
+
+        if (vectorized) {
+            // The mask selects the bytes visited by the loop, starting at the tape pointer: bit 0, stride, 2 * stride
+            // etc. when searching forward, and bit 15, 15 - stride etc. when searching backward.
+            int mask = 0;
+            int visited = 0;
+
+            for (int lane = 0; lane < 16; lane += stride) {
+                mask |= 1 << (forward ? lane : 15 - lane);
+                visited++;
+            }
+
+            // All 16 bytes must be part of the tape, as the padding is 0, too. Otherwise, we take a single step.
+            if (forward) {
+                builder->cmp("rbx", std::to_string(tapeSize(config.cellSemantics) - 16))
+                        .jg(scanStep)
+                        .movdqu("xmm0", "[rax + rbx]");
+            } else {
+                builder->cmp("rbx", "14")
+                        .jle(scanStep)
+                        .movdqu("xmm0", "[rax + rbx - 15]");
+            }
+
+            builder->pcmpeqb("xmm0", "xmm1")
+                    .pmovmskb("r9d", "xmm0")
+                    .a_nd("r9d", std::to_string(mask))
+                    .cmp("r9d", "0")
+                    .jg(scanFound);
+
+            if (forward) {
+                builder->add("rbx", std::to_string(visited * stride));
+            } else {
+                builder->sub("rbx", std::to_string(visited * stride));
+            }
+
+            builder->jmp(scan)
+                    .label(scanFound);
+
+            // The index of the first visited byte that is 0 is relative to the start of the 16 bytes.
+            if (forward) {
+                builder->bsf("r9d", "r9d");
+            } else {
+                builder->bsr("r9d", "r9d")
+                        .sub("rbx", "15");
+            }
+
+            builder->add("rbx", "r9")
+                    .jmp(scanExit);
+        }
+
+        // A single step of the loop, which wraps the tape pointer around at either end of the tape.
+        builder->label(scanStep);
+
+        if (forward) {
+            IncrementPtr step(stmt->column, stmt->line, stride);
+            visitIncrementPtr(&step);
+        } else {
+            DecrementPtr step(stmt->column, stmt->line, stride);
+            visitDecrementPtr(&step);
+        }
+
+        builder->jmp(scan)
+                .label(scanExit);
+    }
+
+    void CodeGen::visitConstOutput(ConstOutput *stmt) {
+        writeBackCells();
+
+        const auto labelCounter = ++this->labelCounter;
+        const auto constOutput = std::format("constOutput{}", labelCounter);
+
+        builder->db(constOutput, stmt->value);
+
+        // Any buffered output precedes the constant output, therefor it must be written first. ConstOutput only
+        // appears at the top level, where any Output that may have been executed before has been translated already.
+        if (config.bufferedIo && usesOutputBuffer) {
+            const auto outputFlushed = std::format("outputFlushed{}", labelCounter);
+
+            builder->cmp("r12", "0")
+                    .jle(outputFlushed);
+
+            flushOutput();
+
+            builder->label(outputFlushed);
+        }
+
+        builder->mov("rax", "1");
+
+        if (config.debugBuild) {
+            builder->comment(stmt->debugInfo());
+        }
+
+        builder->mov("rdi", "1")
+                .lea("rsi", std::format("[rel {}]", constOutput))
+                .mov("rdx", std::to_string(stmt->value.size()))
+                .syscall()
+                .lea("rax", "[rel tape]")
+                .newLine();
     }
 
-    void CodeGen::visitMultiply(Multiply *stmt) {
-        // We store the original pointer in rax
-        builder->mov("r8", "rbx");
+    void CodeGen::visitTapeInit(TapeInit *stmt) {
+        writeBackCells();
+
+        // The tape is still empty, therefor we only set the cells that aren't 0, at their absolute positions.
+        for (const auto &[position, value]: stmt->cells) {
+            builder->mov("byte " + memory("rax", position), std::to_string(static_cast<unsigned char>(value)));
+        }
+
+        builder->mov("rbx", std::to_string(stmt->tapePtr));
 
         if (config.debugBuild) {
             builder->comment(stmt->debugInfo());
         }
+    }
+
+    void CodeGen::addToCellWrap8(const int offset, const std::string &value) const {
+        if (offset > 0) {
+            builder->lea("r8", std::format("[rbx + {}]", offset));
+        } else if (offset < 0) {
+            builder->lea("r8", std::format("[rbx - {}]", -offset));
+        } else {
+            builder->mov("r8", "rbx");
+        }
 
-        const auto incByte = new IncrementByte(stmt->column, stmt->line, stmt->times);
-        visitIncrementByte(incByte);
-        delete incByte;
+        builder->a_nd("r8", std::to_string(WRAP8_TAPE_SIZE - 1))
+                .add("byte [rax + r8]", value);
+    }
 
-        // We copy the current value in [tape + rbx] to r9b
-        // As multiply works like this: rax = rax * src, we move our count to rax
-        builder->mov("r9b", "byte [rax + rbx]")
-                .mov("byte [rax + rbx]", "0")
-                .mov("rax", std::to_string(stmt->count))
-                .mul("r9b")
-                .mov("r9", "rax")
+    void CodeGen::flushOutput() const {
+        builder->mov("rax", "1")
+                .mov("rdi", "1")
+                .lea("rsi", "[rel outBuf]")
+                .mov("rdx", "r12")
+                .syscall()
+                .mov("r12", "0")
                 .lea("rax", "[rel tape]");
+    }
+
+    void CodeGen::bufferedOutput(const Output *stmt) {
+        usesOutputBuffer = true;
 
-        // In r9b we have the multiplied value we then add to the offset location
+        const auto outputFlushed = std::format("outputFlushed{}", ++labelCounter);
 
-        // Then we (ab)use our pointer inc/dec logic to move the pointer to the proper offset where to copy data to
-        if (stmt->offset > 0) {
-            const auto incPtr = new IncrementPtr(stmt->column, stmt->line, stmt->offset);
-            visitIncrementPtr(incPtr);
-            delete incPtr;
-        } else if (stmt->offset < 0) {
-            const auto decPtr = new DecrementPtr(stmt->column, stmt->line, -stmt->offset);
-            visitDecrementPtr(decPtr);
-            delete decPtr;
+        builder->mov("r8b", cellAt(stmt->offset));
+
+        if (config.debugBuild) {
+            builder->comment(stmt->debugInfo());
         }
-        // rbx now points to the tape location
 
-        const auto incGuard = std::format("incGuard{}", ++labelCounter);
+        builder->mov("byte [outBuf + r12]", "r8b")
+                .add("r12", "1")
+                .cmp("r12", std::to_string(IO_BUFFER_SIZE - 1))
+                .jle(outputFlushed);
+
+        // The buffer is full, therefor we write it before appending any further bytes.
+        flushOutput();
+
+        builder->label(outputFlushed)
+                .newLine();
+    }
 
-        builder->add("byte [rax + rbx]", "r9b")
-                .cmp("byte [rax + rbx]", "0")
-                .jge(incGuard);
+    void CodeGen::bufferedInput(const Input *stmt) {
+        const auto labelCounter = ++this->labelCounter;
+        const auto inputAvailable = std::format("inputAvailable{}", labelCounter);
+        const auto inputFlushed = std::format("inputFlushed{}", labelCounter);
+        const auto inputDone = std::format("inputDone{}", labelCounter);
 
-        // Now rbx is smaller than 0, we had an overflow. Therefor we add 127 to move to positive values.
-        builder->add("byte [rax + rbx]", "127");
+        builder->cmp("r14", "r13");
 
-        // Finally we reset our tape pointer to the original value, as a copy statement doesn't move the pointer.
-        builder->label(incGuard)
-                .mov("rbx", "r8");
+        if (config.debugBuild) {
+            builder->comment(stmt->debugInfo());
+        }
+
+        builder->jg(inputAvailable);
+
+        // The input buffer is exhausted. As reading may block, e.g. in an interactive session, any pending output
+        // must be written first.
+        builder->cmp("r12", "0")
+                .jle(inputFlushed);
+
+        flushOutput();
+
+        builder->label(inputFlushed)
+                .mov("rax", "0")
+                .mov("rdi", "0")
+                .lea("rsi", "[rel inBuf]")
+                .mov("rdx", std::to_string(IO_BUFFER_SIZE))
+                .syscall()
+                .mov("r14", "rax")
+                .mov("r13", "0")
+                .lea("rax", "[rel tape]");
+
+        // Like with unbuffered input, the cell is left untouched at the end of the input or in case of an error.
+        builder->cmp("r14", "0")
+                .jle(inputDone);
+
+        builder->label(inputAvailable)
+                .mov("r8b", "byte [inBuf + r13]");
+
+        builder->mov(cellAt(stmt->offset), "r8b")
+                .add("r13", "1")
+                .label(inputDone)
+                .newLine();
+    }
+
+    void CodeGen::countProfile(const ProfileCounterKind kind, const Stmt *stmt) {
+        const auto offset = profileCounters.size() * sizeof(std::uint64_t);
+        profileCounters.push_back(ProfileCounter{.kind = kind, .line = stmt->line, .column = stmt->column});
+
+        builder->add(std::format("qword [rel profCounters + {}]", offset), "1");
+    }
+
+    void CodeGen::writeProfile() {
+        const auto profileWritten = std::format("profileWritten{}", ++labelCounter);
+        const auto header = Profile::header(profileCounters);
+
+        builder->db("profHeader", header)
+                .db("profFile", config.profileFile + '\0');
+
+        // open(profileFile, O_WRONLY | O_CREAT | O_TRUNC, 0644), which returns the file descriptor in rax.
+        builder->newLine()
+                .mov("rax", "2")
+                .lea("rdi", "[rel profFile]")
+                .mov("rsi", "577")
+                .mov("rdx", "420")
+                .syscall()
+                .cmp("rax", "-1")
+                .jle(profileWritten)
+                .mov("rdi", "rax")
+                .mov("rax", "1")
+                .lea("rsi", "[rel profHeader]")
+                .mov("rdx", std::to_string(header.size()))
+                .syscall();
+
+        if (!profileCounters.empty()) {
+            const auto size = profileCounters.size() * sizeof(std::uint64_t);
+
+            builder->resb("profCounters", size)
+                    .mov("rax", "1")
+                    .lea("rsi", "[rel profCounters]")
+                    .mov("rdx", std::to_string(size))
+                    .syscall();
+        }
+
+        // close(fd), as rdi still holds the file descriptor.
+        builder->mov("rax", "3")
+                .syscall()
+                .label(profileWritten);
     }
 
+    std::string CodeGen::cellIndex(const int offset) {
+        if (offset == 0) {
+            return "rbx";
+        }
+
+        builder->lea("rcx", memory("rbx", offset));
+
+        if (wrap8()) {
+            builder->a_nd("rcx", std::to_string(WRAP8_TAPE_SIZE - 1));
+            return "rcx";
+        }
+
+        // As the offset is known, only the end of the tape it points to needs to be checked.
+        const auto cellInside = std::format("cellInside{}", ++labelCounter);
+
+        if (offset < 0) {
+            builder->cmp("rcx", "0")
+                    .jge(cellInside)
+                    .add("rcx", std::to_string(TAPE_SIZE));
+        } else {
+            builder->cmp("rcx", "29999")
+                    .jle(cellInside)
+                    .sub("rcx", std::to_string(TAPE_SIZE));
+        }
+
+        builder->label(cellInside);
+        return "rcx";
+    }
+
+    void CodeGen::beforeStmt(const StmtSpan stmts, const std::size_t idx) {
+        // A cell is only worth loading into a register, if it's modified again before the cache is written back.
+        cellModifiedAgain = false;
+
+        if (const auto offset = modifiedOffset(stmts[idx]); offset.has_value()) {
+            for (std::size_t next = idx + 1; next < stmts.size() && next <= idx + CELL_LOOKAHEAD; next++) {
+                const auto nextOffset = stmts[next] != nullptr ? modifiedOffset(stmts[next]) : std::nullopt;
+
+                if (!nextOffset.has_value()) {
+                    break;
+                }
+
+                if (*nextOffset == *offset) {
+                    cellModifiedAgain = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::string CodeGen::cachedCell(const int offset, const bool load) {
+        cellUses++;
+
+        for (auto &cell: cachedCells) {
+            if (cell.offset == offset) {
+                cell.lastUse = cellUses;
+                return cell.reg;
+            }
+        }
+
+        if (cachedCells.size() == std::size(CACHE_REGISTERS)) {
+            const auto leastRecentlyUsed = std::ranges::min_element(cachedCells, {}, &CachedCell::lastUse);
+
+            builder->mov(cellAt(leastRecentlyUsed->offset), leastRecentlyUsed->reg);
+            cachedCells.erase(leastRecentlyUsed);
+        }
+
+        // The first register that doesn't cache any cell.
+        std::string reg;
+        for (const auto &candidate: CACHE_REGISTERS) {
+            if (std::ranges::none_of(cachedCells, [&](const CachedCell &cell) { return cell.reg == candidate; })) {
+                reg = candidate;
+                break;
+            }
+        }
+
+        if (load) {
+            builder->mov(reg, cellAt(offset));
+        }
+
+        cachedCells.push_back(CachedCell{.offset = offset, .reg = reg, .lastUse = cellUses});
+        return reg;
+    }
+
+    std::string CodeGen::modifiedCell(const int offset, const bool load) {
+        if (!cachingCells() || (!cellModifiedAgain && std::ranges::none_of(cachedCells, [offset](const CachedCell &cell) {
+            return cell.offset == offset;
+        }))) {
+            return cellAt(offset);
+        }
+
+        return cachedCell(offset, load);
+    }
+
+    void CodeGen::writeBackCells() {
+        for (const auto &[offset, reg, lastUse]: cachedCells) {
+            builder->mov(cellAt(offset), reg);
+        }
+
+        cachedCells.clear();
+    }
 }
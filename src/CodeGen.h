@@ -5,15 +5,31 @@
 #ifndef CODEGEN_H
 #define CODEGEN_H
 
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "Stmt.h"
 #include "AsmBuilder.h"
 #include "Pipeline.h"
+#include "Profile.h"
+#include "Tape.h"
 
 namespace goo {
     struct CodeGenConfig {
         const bool debugBuild;
+
+        /// With CELLS_WRAP8, the guards around every cell and pointer modification are dropped in favour of plain
+        /// byte arithmetic and masking the tape pointer.
+        const CellSemantics cellSemantics = CELLS_COMPAT;
+
+        /// If set, output is collected in a buffer in .bss and written once it's full, before reading input and at
+        /// exit. Likewise, input is read in blocks. Otherwise, every `.` and `,` results in a syscall.
+        const bool bufferedIo = true;
+
+        /// If set, the generated code counts how often each loop is entered and iterated, as well as how often each
+        /// output and input statement is executed, and writes the counters to this file at exit, see Profile.
+        const std::string profileFile;
     };
 
     /// The core feature of goo, CodeGen traverses a list of statements and produces corresponding assembler code.
@@ -22,9 +38,37 @@ namespace goo {
     ///
     /// Note that it is unsafe to call ::execute more than once, as CodeGen doesn't reset the AsmBuilder instance,
     /// thusly keeping the created code, as well as keeping the internal label counter.
-    class CodeGen final : public Phase, public Visitor {
+    class CodeGen final : public Phase, public StmtWalker {
         int labelCounter = 0;
 
+        /// Set once an Output has been translated with buffered I/O, as only then the buffer must be written at exit.
+        bool usesOutputBuffer = false;
+
+        /// The counters of the profile, in the order they are stored in .bss.
+        std::vector<ProfileCounter> profileCounters;
+
+        /// The profile of the statements, as passed on by the Optimizer, if any.
+        std::shared_ptr<const LoopProfile> loopProfile;
+
+        /// A cell that is cached in a register, see ::cachedCell.
+        struct CachedCell {
+            int offset;
+            std::string reg;
+
+            /// The value of cellUses when the cell was last used, to evict the least recently used cell.
+            int lastUse;
+        };
+
+        std::vector<CachedCell> cachedCells;
+        int cellUses = 0;
+
+        /// Set by ::beforeStmt, if the cell modified by the current statement is modified again by one of the next
+        /// statements, before the cache is written back.
+        bool cellModifiedAgain = false;
+
+        /// The label of each loop that is being translated, innermost last.
+        std::vector<std::string> loopLabels;
+
         const CodeGenConfig config;
         std::shared_ptr<AsmBuilder> builder;
 
@@ -32,10 +76,13 @@ namespace goo {
         explicit CodeGen(const CodeGenConfig config, std::shared_ptr<AsmBuilder> builder, Reporter &reporter) : Phase(reporter), config(config), builder(std::move(builder)) {};
         ~CodeGen() override = default;
 
+        [[nodiscard]] std::string name() const override { return "codegen"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STRING; }
+
         /// Translates the provided statements into assembler code.
         /// Note, that this function must not be called recursively, as it appends the terminate statement
-        /// at the end of the function call. In order to process statements recursively, use a for-loop
-        /// and call ::accept(this).
+        /// at the end of the function call. In order to process nested statements, use ::walk.
         ///
         /// Additionally, after having processed all statements, an exit syscall is added to the code. Therefore,
         /// although it is possible to call execute more than once, it wouldn't have any effect, as the code
@@ -54,7 +101,9 @@ namespace goo {
 
         void visitDecrementPtr(DecrementPtr *stmt) override;
 
-        void visitConditional(Conditional *stmt) override;
+        bool enterConditional(Conditional *stmt) override;
+
+        bool leaveConditional(Conditional *stmt) override;
 
         void visitOutput(Output *stmt) override;
 
@@ -64,9 +113,83 @@ namespace goo {
 
         void visitReset(Reset *stmt) override;
 
-        void visitTransfer(Transfer *stmt) override;
+        void visitLinearLoop(LinearLoop *stmt) override;
+
+        void visitScan(Scan *stmt) override;
+
+        /// Writes the value, which is stored in .rodata, with a single syscall, after any buffered output.
+        void visitConstOutput(ConstOutput *stmt) override;
+
+        void visitTapeInit(TapeInit *stmt) override;
+
+        /// Returns the index of the cell at `offset` relative to the tape pointer, for a memory operand based on rax or
+        /// tape. Like the tape pointer, the position of the cell wraps around either end of the tape (see cellPosition),
+        /// therefor it is computed into rcx, unless `offset` is 0.
+        std::string cellIndex(int offset);
+
+        /// Returns the operand of the byte at `offset` relative to the tape pointer, see ::cellIndex.
+        std::string cellAt(const int offset) { return "byte [rax + " + cellIndex(offset) + "]"; }
+
+        /// Looks ahead for cells that are worth caching before each statement is translated, see ::cachedCell.
+        void beforeStmt(StmtSpan stmts, std::size_t idx) override;
+
+        [[nodiscard]] bool wrap8() const { return config.cellSemantics == CELLS_WRAP8; }
+
+        [[nodiscard]] bool profiling() const { return !config.profileFile.empty(); }
+
+        /// Cells are only cached in registers in release builds, so that the tape is up-to-date in a debugger.
+        [[nodiscard]] bool cachingCells() const { return !config.debugBuild; }
+
+        /// Returns the register that caches the cell at `offset` relative to the tape pointer, loading the cell into
+        /// it unless `load` is false, for example as the cell is overwritten. Cached cells are expected to be modified,
+        /// therefor each of them is written back by ::writeBackCells. If every register is taken, the least recently
+        /// used cell is written back first.
+        std::string cachedCell(int offset, bool load = true);
+
+        /// Returns the operand that increase, decrease and reset statements modify, which is the cached cell if it is
+        /// cached already or modified again (see ::cellModifiedAgain), otherwise the cell itself.
+        std::string modifiedCell(int offset, bool load = true);
+
+        /// Writes every cached cell back to the tape and empties the cache. This must precede any code that accesses
+        /// the tape directly or moves the tape pointer, as well as any label that is jumped to, as the cache only
+        /// describes straight-line code.
+        void writeBackCells();
+
+        [[nodiscard]] LoopHeat heat(const Stmt *stmt) const {
+            return loopProfile != nullptr ? loopProfile->heat(stmt) : HEAT_UNKNOWN;
+        }
+
+        /// Loops that are hot according to the profile are translated by ::enterHotConditional, unless the program is
+        /// profiled itself.
+        [[nodiscard]] bool isHotLoop(const Stmt *stmt) const { return heat(stmt) == HEAT_HOT && !profiling(); }
+
+        /// Creates the head of a loop that is hot according to the profile. The condition is checked once before the
+        /// loop and at the end of each iteration, so that an iteration takes a single jump, the head of the loop is
+        /// aligned to LOOP_ALIGNMENT and small bodies are unrolled once, see UNROLL_MAX_STMTS. Unrolled loops are
+        /// translated completely.
+        /// @return True if the body is left to be translated, followed by ::leaveHotConditional.
+        bool enterHotConditional(const Conditional *stmt);
+
+        /// Creates the tail of a hot loop, which checks the condition at the end of each iteration.
+        void leaveHotConditional(const std::string &loopLabel);
+
+        /// Adds a counter of the given kind for the statement to the profile, and increases it. Changes the flags.
+        void countProfile(ProfileCounterKind kind, const Stmt *stmt);
+
+        /// Writes the header and the counters of the profile to CodeGenConfig::profileFile. If the file can't be
+        /// opened, the profile is silently dropped, as the program itself ran successfully.
+        void writeProfile();
+
+        /// Adds `value` to the cell at rbx + offset, with the address masked to the size of the tape.
+        /// Only used with CELLS_WRAP8, as it neither guards the cell nor moves the tape pointer. Clobbers r8.
+        void addToCellWrap8(int offset, const std::string &value) const;
+
+        /// Writes the content of the output buffer to stdout and empties it. Restores rax to the address of the tape.
+        void flushOutput() const;
+
+        void bufferedOutput(const Output *stmt);
 
-        void visitMultiply(Multiply *stmt) override;
+        void bufferedInput(const Input *stmt);
     };
 }
 
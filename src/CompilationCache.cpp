@@ -0,0 +1,143 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "CompilationCache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Sha256.h"
+
+namespace fs = std::filesystem;
+
+namespace goo {
+    /// The extension of the entries, which distinguishes them from files that are still being written.
+    constexpr std::string_view ENTRY_EXTENSION = ".bin";
+
+    CompilationCache::CompilationCache(CompilationCacheConfig config) : config(std::move(config)) {
+        std::error_code error;
+        fs::create_directories(this->config.directory, error);
+    }
+
+    std::string CompilationCache::key(const std::string_view source, const std::string_view options) {
+        // A collision would restore the compiled file of another source, therefor the digest is cryptographic.
+        Sha256 digest;
+
+        // The lengths separate the source from the options, therefor their boundary can't shift.
+        digest.update(std::format("{}:{}:{}:", CACHE_VERSION, source.size(), options.size()));
+        digest.update(source);
+        digest.update(options);
+
+        return digest.hexDigest();
+    }
+
+    bool CompilationCache::restore(const std::string &key, const std::string &outputFile) {
+        const auto entry = entryPath(key);
+
+        std::error_code error;
+        if (!fs::is_regular_file(entry, error)) {
+            ++misses;
+            return false;
+        }
+
+        // The output is a copy rather than a hard link, as tools such as strip may modify the output in place, which
+        // would damage the entry for every later hit.
+        if (!fs::copy_file(entry, outputFile, fs::copy_options::overwrite_existing, error)) {
+            ++misses;
+            return false;
+        }
+
+        // The modification time marks the entry as recently used.
+        fs::last_write_time(entry, fs::file_time_type::clock::now(), error);
+
+        ++hits;
+        return true;
+    }
+
+    void CompilationCache::store(const std::string &key, const std::string &outputFile) {
+        const auto entry = entryPath(key);
+
+        // The temporary file gets a name that no other thread or process uses, as they may store the same key.
+        auto tmpEntry = (fs::path(config.directory) / (key + ".tmp.XXXXXX")).string();
+        const int fd = mkstemp(tmpEntry.data());
+        if (fd < 0) {
+            return;
+        }
+
+        close(fd);
+
+        std::error_code error;
+        if (!fs::copy_file(outputFile, tmpEntry, fs::copy_options::overwrite_existing, error)) {
+            fs::remove(tmpEntry, error);
+            return;
+        }
+
+        fs::last_write_time(tmpEntry, fs::file_time_type::clock::now(), error);
+        fs::rename(tmpEntry, entry, error);
+
+        if (error) {
+            fs::remove(tmpEntry, error);
+            return;
+        }
+
+        evict();
+    }
+
+    void CompilationCache::printStats(std::ostream &out) const {
+        out << std::format("Cache: {} hit(s), {} miss(es)", hits.load(), misses.load()) << std::endl;
+    }
+
+    std::string CompilationCache::entryPath(const std::string &key) const {
+        return (fs::path(config.directory) / (key + std::string(ENTRY_EXTENSION))).string();
+    }
+
+    void CompilationCache::evict() {
+        const std::lock_guard lock(evictionMutex);
+
+        struct Entry {
+            fs::path path;
+            std::uintmax_t size;
+            fs::file_time_type lastUsed;
+        };
+
+        std::vector<Entry> entries;
+        std::uintmax_t totalSize = 0;
+
+        std::error_code error;
+        for (const auto &file: fs::directory_iterator(config.directory, error)) {
+            if (!file.is_regular_file(error) || file.path().extension() != ENTRY_EXTENSION) {
+                continue;
+            }
+
+            const auto size = file.file_size(error);
+            const auto lastUsed = file.last_write_time(error);
+
+            if (!error) {
+                entries.push_back(Entry{.path = file.path(), .size = size, .lastUsed = lastUsed});
+                totalSize += size;
+            }
+        }
+
+        if (totalSize <= config.maxBytes) {
+            return;
+        }
+
+        std::ranges::sort(entries, {}, &Entry::lastUsed);
+
+        for (const auto &entry: entries) {
+            if (totalSize <= config.maxBytes) {
+                break;
+            }
+
+            if (fs::remove(entry.path, error)) {
+                totalSize -= entry.size;
+            }
+        }
+    }
+} // goo
@@ -0,0 +1,78 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef COMPILATIONCACHE_H
+#define COMPILATIONCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace goo {
+    /// The size limit of the cache by default, see CompilationCacheConfig::maxBytes.
+    constexpr std::uintmax_t DEFAULT_CACHE_SIZE = 512 * 1024 * 1024;
+
+    /// The version of the compiled code. Entries of other versions are never hit, therefor this must be increased
+    /// whenever the same source and options produce different code than before.
+    constexpr int CACHE_VERSION = 2;
+
+    struct CompilationCacheConfig {
+        /// The directory of the cache, which is created if necessary.
+        const std::string directory;
+
+        /// Once the entries of the cache exceed this size, the least recently used ones are removed.
+        const std::uintmax_t maxBytes = DEFAULT_CACHE_SIZE;
+    };
+
+    /// An on-disk cache of compiled files, which is keyed by the content of the source and the options that affect the
+    /// compiled code. A hit restores the compiled file without running the pipeline at all.
+    ///
+    /// Each entry is a file of its own, whose modification time tracks when it was last used. Entries are written
+    /// to a temporary file, whose name is unique across processes (see mkstemp), and renamed afterward, therefor
+    /// several threads or processes may share the same cache.
+    class CompilationCache {
+        const CompilationCacheConfig config;
+
+        std::atomic<int> hits = 0;
+        std::atomic<int> misses = 0;
+
+        /// Serializes the eviction of entries within this process.
+        std::mutex evictionMutex;
+
+    public:
+        explicit CompilationCache(CompilationCacheConfig config);
+
+        /// Computes the key of a compiled file.
+        /// @param source The content of the source file.
+        /// @param options A description of all options that affect the compiled code.
+        /// @return The hexadecimal SHA-256 digest of the source, the options and CACHE_VERSION.
+        static std::string key(std::string_view source, std::string_view options);
+
+        /// Restores the compiled file of the key to the output file, as a copy of the entry. Counts as hit or miss.
+        /// @return True if the cache contains the key, otherwise false.
+        bool restore(const std::string &key, const std::string &outputFile);
+
+        /// Adds the compiled output file to the cache and evicts the least recently used entries, if the cache
+        /// exceeds its size limit. Failures to write the cache are ignored, as they only cost a later hit.
+        void store(const std::string &key, const std::string &outputFile);
+
+        /// Prints the number of hits and misses.
+        void printStats(std::ostream &out) const;
+
+        [[nodiscard]] int getHits() const { return hits; }
+
+        [[nodiscard]] int getMisses() const { return misses; }
+
+    private:
+        [[nodiscard]] std::string entryPath(const std::string &key) const;
+
+        /// Removes the least recently used entries, until the entries fit into the size limit.
+        void evict();
+    };
+} // goo
+
+#endif //COMPILATIONCACHE_H
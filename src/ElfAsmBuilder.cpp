@@ -0,0 +1,520 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "ElfAsmBuilder.h"
+
+#include <cstring>
+#include <elf.h>
+#include <format>
+#include <iterator>
+
+#include "Reporter.h"
+
+namespace goo {
+    namespace {
+        /// Executables are loaded to the same address as the ones produced by `ld`.
+        constexpr std::uint64_t BASE_ADDRESS = 0x400000;
+        constexpr std::uint64_t PAGE_ALIGNMENT = 0x1000;
+        constexpr std::uint64_t BSS_ALIGNMENT = 16;
+
+        /// The sections of a relocatable object file, in the order of their section headers.
+        enum Section : std::uint16_t {
+            SECTION_NULL,
+            SECTION_TEXT,
+            SECTION_BSS,
+            SECTION_SYMTAB,
+            SECTION_STRTAB,
+            SECTION_RELA_TEXT,
+            SECTION_SHSTRTAB,
+            SECTION_COUNT
+        };
+
+        std::uint64_t alignUp(const std::uint64_t value, const std::uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        template<typename T>
+        void append(std::string &out, const T &value) {
+            out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        void pad(std::string &out, const std::uint64_t alignment) {
+            out.resize(alignUp(out.size(), alignment), '\0');
+        }
+
+        /// Appends `name` to a string table and returns its offset within the table.
+        std::uint32_t addString(std::string &table, const std::string &name) {
+            const auto offset = static_cast<std::uint32_t>(table.size());
+            table += name;
+            table += '\0';
+            return offset;
+        }
+
+        Elf64_Ehdr elfHeader(const std::uint16_t type) {
+            Elf64_Ehdr header{};
+            memcpy(header.e_ident, ELFMAG, SELFMAG);
+            header.e_ident[EI_CLASS] = ELFCLASS64;
+            header.e_ident[EI_DATA] = ELFDATA2LSB;
+            header.e_ident[EI_VERSION] = EV_CURRENT;
+            header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+            header.e_type = type;
+            header.e_machine = EM_X86_64;
+            header.e_version = EV_CURRENT;
+            header.e_ehsize = sizeof(Elf64_Ehdr);
+            return header;
+        }
+
+        Elf64_Sym elfSymbol(const std::uint32_t name, const unsigned char info, const std::uint16_t section,
+                            const std::uint64_t value, const std::uint64_t size) {
+            Elf64_Sym symbol{};
+            symbol.st_name = name;
+            symbol.st_info = info;
+            symbol.st_other = STV_DEFAULT;
+            symbol.st_shndx = section;
+            symbol.st_value = value;
+            symbol.st_size = size;
+            return symbol;
+        }
+
+        Elf64_Shdr sectionHeader(const std::uint32_t name, const std::uint32_t type, const std::uint64_t flags,
+                                 const std::uint64_t offset, const std::uint64_t size, const std::uint64_t alignment) {
+            Elf64_Shdr header{};
+            header.sh_name = name;
+            header.sh_type = type;
+            header.sh_flags = flags;
+            header.sh_offset = offset;
+            header.sh_size = size;
+            header.sh_addralign = alignment;
+            return header;
+        }
+
+        Elf64_Phdr programHeader(const std::uint32_t type, const std::uint32_t flags, const std::uint64_t address,
+                                 const std::uint64_t fileSize, const std::uint64_t memorySize,
+                                 const std::uint64_t alignment) {
+            Elf64_Phdr header{};
+            header.p_type = type;
+            header.p_flags = flags;
+            header.p_offset = 0;
+            header.p_vaddr = address;
+            header.p_paddr = address;
+            header.p_filesz = fileSize;
+            header.p_memsz = memorySize;
+            header.p_align = alignment;
+            return header;
+        }
+
+        bool fitsImmediate(const int size, const std::int64_t imm) {
+            if (size == 1) {
+                return imm >= INT8_MIN && imm <= UINT8_MAX;
+            }
+
+            return imm >= INT32_MIN && imm <= INT32_MAX;
+        }
+
+        bool isValidSize(const int size) {
+            return size == 1 || size == 4 || size == 8;
+        }
+
+        Condition condition(const AsmOpcode opcode) {
+            switch (opcode) {
+                case ASM_JE:
+                    return COND_E;
+                case ASM_JNE:
+                    return COND_NE;
+                case ASM_JG:
+                    return COND_G;
+                case ASM_JLE:
+                    return COND_LE;
+                default:
+                    return COND_GE;
+            }
+        }
+
+        bool aluOp(const AsmOpcode opcode, AluOp &op) {
+            switch (opcode) {
+                case ASM_ADD:
+                    op = ALU_ADD;
+                    return true;
+                case ASM_SUB:
+                    op = ALU_SUB;
+                    return true;
+                case ASM_XOR:
+                    op = ALU_XOR;
+                    return true;
+                case ASM_AND:
+                    op = ALU_AND;
+                    return true;
+                case ASM_CMP:
+                    op = ALU_CMP;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    ElfAsmBuilder::ElfAsmBuilder(const ElfType type, Reporter &reporter, const int tapeSize): IrAsmBuilder(reporter,
+        tapeSize), type(type) {
+    }
+
+    std::string ElfAsmBuilder::build() const {
+        X86Encoder encoder;
+
+        // Every symbol gets a label, even though only the ones used by jumps are ever bound.
+        std::vector<int> labels(symbols.size());
+        for (auto &label: labels) {
+            label = encoder.newLabel();
+        }
+
+        std::vector<Relocation> relocations;
+
+        for (const auto &instruction: instructions) {
+            if (!encode(instruction, encoder, labels, relocations)) {
+                reporter.error("Internal Error: ElfAsmBuilder encountered an instruction with unsupported operands.");
+                return "";
+            }
+        }
+
+        if (!encoder.finish()) {
+            reporter.error("Internal Error: ElfAsmBuilder produced a jump to an unknown label.");
+            return "";
+        }
+
+        std::size_t bssSize;
+        const auto offsets = layoutBss(bssSize);
+
+        // Constant data directly follows the code, therefor any reference to it is resolved right away.
+        auto text = encoder.bytes();
+        std::vector<std::int64_t> dataOffsets(symbols.size(), -1);
+
+        for (const auto &[symbol, bytes]: rodata) {
+            dataOffsets[symbol] = static_cast<std::int64_t>(text.size());
+            text.insert(text.end(), bytes.begin(), bytes.end());
+        }
+
+        std::vector<Relocation> bssRelocations;
+
+        for (const auto &relocation: relocations) {
+            if (const auto dataOffset = dataOffsets[relocation.symbol]; dataOffset >= 0) {
+                if (!relocation.pcRelative) {
+                    reporter.error("Internal Error: Constant data must be referred to relative to rip.");
+                    return "";
+                }
+
+                const auto value = static_cast<std::int32_t>(dataOffset + relocation.addend -
+                                                             static_cast<std::int64_t>(relocation.position));
+                memcpy(&text[relocation.position], &value, sizeof(value));
+                continue;
+            }
+
+            if (offsets[relocation.symbol] < 0) {
+                reporter.error(std::format("Internal Error: Reference to the unknown symbol '{}'.",
+                                           symbols.name(relocation.symbol)));
+                return "";
+            }
+
+            bssRelocations.push_back(relocation);
+        }
+
+        const auto entry = encoder.labelPosition(labels[startSymbol]);
+
+        if (type == ELF_EXECUTABLE) {
+            return writeExecutable(text, entry, bssRelocations);
+        }
+
+        return writeRelocatable(text, entry, bssRelocations);
+    }
+
+    bool ElfAsmBuilder::encode(const AsmInstruction &instruction, X86Encoder &encoder, const std::vector<int> &labels,
+                               std::vector<Relocation> &relocations) const {
+        const auto &[opcode, dest, src] = instruction;
+        const int size = dest.size != 0 ? dest.size : src.size;
+
+        switch (opcode) {
+            case ASM_LABEL:
+                encoder.bind(labels[dest.symbol]);
+                return true;
+            case ASM_COMMENT:
+            case ASM_NEW_LINE:
+                return true;
+            case ASM_ALIGN:
+                if (dest.kind != OPERAND_IMMEDIATE || dest.imm <= 0 || (dest.imm & (dest.imm - 1)) != 0) {
+                    return false;
+                }
+
+                encoder.align(dest.imm);
+                return true;
+            case ASM_SYSCALL:
+                encoder.syscall();
+                return true;
+            case ASM_JMP:
+            case ASM_JE:
+            case ASM_JNE:
+            case ASM_JG:
+            case ASM_JLE:
+            case ASM_JGE:
+                if (dest.kind != OPERAND_SYMBOL) {
+                    return false;
+                }
+
+                if (opcode == ASM_JMP) {
+                    encoder.jmp(labels[dest.symbol]);
+                } else {
+                    encoder.jcc(condition(opcode), labels[dest.symbol]);
+                }
+
+                return true;
+            case ASM_MUL:
+                if (dest.kind != OPERAND_REGISTER) {
+                    return false;
+                }
+
+                encoder.mul(size, dest.reg);
+                return true;
+            case ASM_LEA:
+                if (dest.kind != OPERAND_REGISTER || dest.size != 8 || src.kind != OPERAND_MEMORY) {
+                    return false;
+                }
+
+                encoder.lea(dest.reg, src.mem);
+                break;
+            case ASM_BSF:
+            case ASM_BSR:
+                if (dest.kind != OPERAND_REGISTER || src.kind != OPERAND_REGISTER || dest.size != src.size ||
+                    dest.size < 4) {
+                    return false;
+                }
+
+                encoder.bitScan(opcode == ASM_BSR, size, dest.reg, src.reg);
+                return true;
+            case ASM_MOVDQU:
+                if (dest.kind != OPERAND_REGISTER || dest.size != 16 || src.kind != OPERAND_MEMORY) {
+                    return false;
+                }
+
+                encoder.sse(SSE_MOVDQU, dest.reg, src.mem);
+                break;
+            case ASM_PXOR:
+            case ASM_PCMPEQB:
+                if (dest.kind != OPERAND_REGISTER || dest.size != 16 || src.kind != OPERAND_REGISTER ||
+                    src.size != 16) {
+                    return false;
+                }
+
+                encoder.sse(opcode == ASM_PXOR ? SSE_PXOR : SSE_PCMPEQB, dest.reg, src.reg);
+                return true;
+            case ASM_PMOVMSKB:
+                if (dest.kind != OPERAND_REGISTER || dest.size != 4 || src.kind != OPERAND_REGISTER ||
+                    src.size != 16) {
+                    return false;
+                }
+
+                encoder.sse(SSE_PMOVMSKB, dest.reg, src.reg);
+                return true;
+            default: {
+                if (!isValidSize(size) || (dest.size != 0 && src.size != 0 && dest.size != src.size &&
+                                           src.kind != OPERAND_IMMEDIATE)) {
+                    return false;
+                }
+
+                if (src.kind == OPERAND_IMMEDIATE && dest.kind == OPERAND_REGISTER && opcode == ASM_MOV) {
+                    // Like nasm, we use the shorter 32-bit move for positive values, which clears the upper half.
+                    encoder.mov(size == 8 && src.imm >= 0 && src.imm <= UINT32_MAX ? 4 : size, dest.reg, src.imm);
+                    return true;
+                }
+
+                if (src.kind == OPERAND_IMMEDIATE && !fitsImmediate(size, src.imm)) {
+                    return false;
+                }
+
+                const auto imm = static_cast<std::int32_t>(src.imm);
+                AluOp op = ALU_ADD;
+
+                if (opcode != ASM_MOV && !aluOp(opcode, op)) {
+                    return false;
+                }
+
+                if (dest.kind == OPERAND_REGISTER && src.kind == OPERAND_IMMEDIATE) {
+                    encoder.alu(op, size, dest.reg, imm);
+                } else if (dest.kind == OPERAND_MEMORY && src.kind == OPERAND_IMMEDIATE) {
+                    opcode == ASM_MOV ? encoder.mov(size, dest.mem, imm) : encoder.alu(op, size, dest.mem, imm);
+                } else if (dest.kind == OPERAND_REGISTER && src.kind == OPERAND_REGISTER) {
+                    opcode == ASM_MOV ? encoder.mov(size, dest.reg, src.reg) : encoder.alu(op, size, dest.reg, src.reg);
+                } else if (dest.kind == OPERAND_MEMORY && src.kind == OPERAND_REGISTER) {
+                    opcode == ASM_MOV ? encoder.mov(size, dest.mem, src.reg) : encoder.alu(op, size, dest.mem, src.reg);
+                } else if (dest.kind == OPERAND_REGISTER && src.kind == OPERAND_MEMORY) {
+                    opcode == ASM_MOV ? encoder.mov(size, dest.reg, src.mem) : encoder.alu(op, size, dest.reg, src.mem);
+                } else {
+                    return false;
+                }
+
+                break;
+            }
+        }
+
+        // The displacement of memory operands referring to a symbol is patched once the address of the symbol is
+        // known. For rip-relative operands, the displacement is relative to the end of the instruction.
+        const auto &memory = dest.kind == OPERAND_MEMORY ? dest : src;
+        if (memory.kind == OPERAND_MEMORY && memory.symbol >= 0) {
+            const auto position = encoder.lastDisplacement();
+            const auto end = static_cast<std::int64_t>(encoder.size());
+
+            relocations.push_back(Relocation{
+                .position = position,
+                .symbol = memory.symbol,
+                .pcRelative = memory.mem.ripRelative,
+                .addend = memory.mem.disp + (memory.mem.ripRelative ? static_cast<std::int64_t>(position) - end : 0)
+            });
+        }
+
+        return true;
+    }
+
+    std::vector<std::int64_t> ElfAsmBuilder::layoutBss(std::size_t &size) const {
+        std::vector<std::int64_t> offsets(symbols.size(), -1);
+        size = 0;
+
+        for (const auto &[symbol, symbolSize]: bss) {
+            size = alignUp(size, BSS_ALIGNMENT);
+            offsets[symbol] = static_cast<std::int64_t>(size);
+            size += symbolSize;
+        }
+
+        return offsets;
+    }
+
+    std::string ElfAsmBuilder::writeRelocatable(const std::vector<std::uint8_t> &text, const std::int64_t entry,
+                                                const std::vector<Relocation> &relocations) const {
+        std::size_t bssSize;
+        const auto offsets = layoutBss(bssSize);
+
+        // Local symbols must precede global ones, therefor the symbols of .bss are followed by _start.
+        std::string strtab(1, '\0');
+        std::vector<Elf64_Sym> symtab(1);
+        std::vector<std::uint32_t> symbolIndices(symbols.size(), 0);
+
+        for (const auto &[symbol, size]: bss) {
+            symbolIndices[symbol] = static_cast<std::uint32_t>(symtab.size());
+            symtab.push_back(elfSymbol(addString(strtab, symbols.name(symbol)), ELF64_ST_INFO(STB_LOCAL, STT_OBJECT),
+                                       SECTION_BSS, offsets[symbol], size));
+        }
+
+        const auto firstGlobal = static_cast<std::uint32_t>(symtab.size());
+        symtab.push_back(elfSymbol(addString(strtab, "_start"), ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE), SECTION_TEXT,
+                                   entry, 0));
+
+        std::vector<Elf64_Rela> rela;
+        for (const auto &[position, symbol, pcRelative, addend]: relocations) {
+            Elf64_Rela relocation{};
+            relocation.r_offset = position;
+            relocation.r_info = ELF64_R_INFO(symbolIndices[symbol], pcRelative ? R_X86_64_PC32 : R_X86_64_32S);
+            relocation.r_addend = addend;
+            rela.push_back(relocation);
+        }
+
+        std::string shstrtab(1, '\0');
+        std::vector<Elf64_Shdr> sections(SECTION_COUNT);
+        std::string out;
+
+        append(out, Elf64_Ehdr{});
+
+        pad(out, 16);
+        sections[SECTION_TEXT] = sectionHeader(addString(shstrtab, ".text"), SHT_PROGBITS,
+                                               SHF_ALLOC | SHF_EXECINSTR, out.size(), text.size(), 16);
+        out.append(text.begin(), text.end());
+
+        sections[SECTION_BSS] = sectionHeader(addString(shstrtab, ".bss"), SHT_NOBITS, SHF_ALLOC | SHF_WRITE,
+                                              out.size(), bssSize, BSS_ALIGNMENT);
+
+        pad(out, 8);
+        sections[SECTION_SYMTAB] = sectionHeader(addString(shstrtab, ".symtab"), SHT_SYMTAB, 0, out.size(),
+                                                 symtab.size() * sizeof(Elf64_Sym), 8);
+        sections[SECTION_SYMTAB].sh_link = SECTION_STRTAB;
+        sections[SECTION_SYMTAB].sh_info = firstGlobal;
+        sections[SECTION_SYMTAB].sh_entsize = sizeof(Elf64_Sym);
+        for (const auto &symbol: symtab) {
+            append(out, symbol);
+        }
+
+        sections[SECTION_STRTAB] = sectionHeader(addString(shstrtab, ".strtab"), SHT_STRTAB, 0, out.size(),
+                                                 strtab.size(), 1);
+        out += strtab;
+
+        pad(out, 8);
+        sections[SECTION_RELA_TEXT] = sectionHeader(addString(shstrtab, ".rela.text"), SHT_RELA, SHF_INFO_LINK,
+                                                    out.size(), rela.size() * sizeof(Elf64_Rela), 8);
+        sections[SECTION_RELA_TEXT].sh_link = SECTION_SYMTAB;
+        sections[SECTION_RELA_TEXT].sh_info = SECTION_TEXT;
+        sections[SECTION_RELA_TEXT].sh_entsize = sizeof(Elf64_Rela);
+        for (const auto &relocation: rela) {
+            append(out, relocation);
+        }
+
+        const auto shstrtabName = addString(shstrtab, ".shstrtab");
+        sections[SECTION_SHSTRTAB] = sectionHeader(shstrtabName, SHT_STRTAB, 0, out.size(), shstrtab.size(), 1);
+        out += shstrtab;
+
+        pad(out, 8);
+        auto header = elfHeader(ET_REL);
+        header.e_shoff = out.size();
+        header.e_shentsize = sizeof(Elf64_Shdr);
+        header.e_shnum = SECTION_COUNT;
+        header.e_shstrndx = SECTION_SHSTRTAB;
+
+        for (const auto &section: sections) {
+            append(out, section);
+        }
+
+        memcpy(out.data(), &header, sizeof(header));
+        return out;
+    }
+
+    std::string ElfAsmBuilder::writeExecutable(std::vector<std::uint8_t> text, const std::int64_t entry,
+                                               const std::vector<Relocation> &relocations) const {
+        std::size_t bssSize;
+        const auto offsets = layoutBss(bssSize);
+
+        // The first page contains the headers, followed by the code. .bss starts at the next free page.
+        const auto textAddress = BASE_ADDRESS + PAGE_ALIGNMENT;
+        const auto bssAddress = alignUp(textAddress + text.size(), PAGE_ALIGNMENT);
+
+        for (const auto &[position, symbol, pcRelative, addend]: relocations) {
+            const auto address = static_cast<std::int64_t>(bssAddress + offsets[symbol]);
+            const auto value = address + addend - (pcRelative ? static_cast<std::int64_t>(textAddress + position) : 0);
+
+            if (value < INT32_MIN || value > INT32_MAX) {
+                reporter.error("Internal Error: The address of a symbol doesn't fit into 32 bits.");
+                return "";
+            }
+
+            const auto value32 = static_cast<std::int32_t>(value);
+            memcpy(&text[position], &value32, sizeof(value32));
+        }
+
+        const Elf64_Phdr segments[] = {
+            programHeader(PT_LOAD, PF_R | PF_X, BASE_ADDRESS, PAGE_ALIGNMENT + text.size(), PAGE_ALIGNMENT + text.size(),
+                          PAGE_ALIGNMENT),
+            programHeader(PT_LOAD, PF_R | PF_W, bssAddress, 0, bssSize, PAGE_ALIGNMENT),
+            programHeader(PT_GNU_STACK, PF_R | PF_W, 0, 0, 0, 16)
+        };
+
+        auto header = elfHeader(ET_EXEC);
+        header.e_entry = textAddress + entry;
+        header.e_phoff = sizeof(Elf64_Ehdr);
+        header.e_phentsize = sizeof(Elf64_Phdr);
+        header.e_phnum = std::size(segments);
+
+        std::string out;
+        append(out, header);
+
+        for (const auto &segment: segments) {
+            append(out, segment);
+        }
+
+        out.resize(PAGE_ALIGNMENT, '\0');
+        out.append(text.begin(), text.end());
+
+        return out;
+    }
+} // goo
@@ -0,0 +1,66 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef ELFASMBUILDER_H
+#define ELFASMBUILDER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AsmInstruction.h"
+#include "IrAsmBuilder.h"
+
+namespace goo {
+    /// The kind of ELF file produced by an ElfAsmBuilder.
+    enum ElfType : std::uint8_t {
+        /// A relocatable object file, which must be linked (for example using `ld`), like the ones produced by nasm.
+        ELF_RELOCATABLE,
+
+        /// A statically linked executable, that can be run directly.
+        ELF_EXECUTABLE
+    };
+
+    /// An IrAsmBuilder that encodes the recorded instructions to x86-64 machine code and produces a complete ELF64
+    /// file, therefor removing the need to invoke nasm. The encoding takes place in ::build, once all labels are known.
+    ///
+    /// References to the tape become relocations in an object file and absolute addresses in an executable. Constant
+    /// data, as defined by ::db, is placed at the end of .text instead of a section of its own.
+    /// Instructions that can't be encoded are reported as internal errors to the Reporter, in which case ::build
+    /// returns an empty string.
+    class ElfAsmBuilder final : public IrAsmBuilder {
+        const ElfType type;
+
+    public:
+        ElfAsmBuilder(ElfType type, Reporter &reporter, int tapeSize = TAPE_SIZE);
+
+        /// Encodes all recorded instructions and returns the bytes of the ELF file.
+        [[nodiscard]] std::string build() const override;
+
+    private:
+        /// A reference to a symbol within .text, that must be patched once the address of the symbol is known.
+        struct Relocation {
+            std::size_t position;
+            int symbol;
+            bool pcRelative;
+            std::int64_t addend;
+        };
+
+        /// Encodes a single instruction, adding any references to symbols to `relocations`.
+        /// @return False if the combination of operands isn't supported.
+        bool encode(const AsmInstruction &instruction, X86Encoder &encoder, const std::vector<int> &labels,
+                    std::vector<Relocation> &relocations) const;
+
+        /// Returns the offset of each symbol within .bss, or -1 for symbols that aren't part of .bss.
+        [[nodiscard]] std::vector<std::int64_t> layoutBss(std::size_t &size) const;
+
+        [[nodiscard]] std::string writeRelocatable(const std::vector<std::uint8_t> &text, std::int64_t entry,
+                                                   const std::vector<Relocation> &relocations) const;
+
+        [[nodiscard]] std::string writeExecutable(std::vector<std::uint8_t> text, std::int64_t entry,
+                                                  const std::vector<Relocation> &relocations) const;
+    };
+} // goo
+
+#endif //ELFASMBUILDER_H
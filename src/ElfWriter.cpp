@@ -0,0 +1,51 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "ElfWriter.h"
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "Reporter.h"
+
+namespace fs = std::filesystem;
+
+namespace goo {
+
+    std::shared_ptr<Payload> ElfWriter::run(const std::shared_ptr<Payload> payload) {
+        const auto stringPayload = std::static_pointer_cast<StringPayload>(payload);
+
+        if (config.verbose) {
+            reporter.output() << std::format("Writing {} bytes to: {}", stringPayload->value.size(),
+                                             config.outputFile) << std::endl;
+        }
+
+        std::ofstream out(config.outputFile, std::ios::binary | std::ios::trunc);
+        out.write(stringPayload->value.data(), static_cast<std::streamsize>(stringPayload->value.size()));
+        out.close();
+
+        if (!out) {
+            reporter.error(std::format("Error: Failed to write to file: {}", config.outputFile));
+            return nullptr;
+        }
+
+        if (config.executable) {
+            std::error_code error;
+            fs::permissions(config.outputFile,
+                            fs::perms::owner_exec | fs::perms::group_exec | fs::perms::others_exec,
+                            fs::perm_options::add, error);
+
+            if (error) {
+                reporter.error(std::format("Error: Failed to make file executable: {}", config.outputFile));
+                return nullptr;
+            }
+        }
+
+        reporter.output() << "[Finished]" << std::endl;
+
+        return nullptr;
+    }
+
+} // goo
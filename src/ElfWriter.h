@@ -0,0 +1,35 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef ELFWRITER_H
+#define ELFWRITER_H
+#include <string>
+#include <utility>
+
+#include "Pipeline.h"
+
+namespace goo {
+    struct ElfWriterConfig {
+        const bool verbose;
+        const bool executable;
+        const std::string outputFile;
+    };
+
+    /// The counterpart of the Assembler for code produced by an ElfAsmBuilder. As the payload already contains a
+    /// complete ELF file, this phase merely writes it to disk, without invoking any external tools.
+    class ElfWriter final : public Phase {
+        const ElfWriterConfig config;
+    public:
+        explicit ElfWriter(ElfWriterConfig config, Reporter &reporter) : Phase(reporter), config(std::move(config)) {
+        }
+
+        [[nodiscard]] std::string name() const override { return "elf-writer"; }
+
+        /// Receives a payload of type StringPayload containing the bytes of an ELF file and writes it to the output
+        /// file. Executables are additionally marked as such.
+        std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
+    };
+} // goo
+
+#endif //ELFWRITER_H
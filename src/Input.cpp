@@ -6,6 +6,13 @@
 
 #include <fstream>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "Reporter.h"
 
 namespace goo {
@@ -13,18 +20,93 @@ namespace goo {
         const auto filePayload = std::static_pointer_cast<FilePayload>(payload);
 
         auto ifs = std::ifstream(filePayload->filepath);
-        const auto fileContent = std::string(std::istreambuf_iterator{ifs}, {});
+        const auto stringPayload = std::make_shared<StringPayload>(StringPayload{
+            .value = std::string(std::istreambuf_iterator{ifs}, {})
+        });
 
-        reporter.setCode(fileContent);
+        reporter.setCode(stringPayload->value, stringPayload);
 
-        return std::make_shared<StringPayload>(StringPayload{.value = fileContent});
+        return stringPayload;
+    }
+
+    std::shared_ptr<Payload> MmapFileInput::run(std::shared_ptr<Payload> payload) {
+        const auto filePayload = std::static_pointer_cast<FilePayload>(payload);
+
+        const auto file = MappedFile::open(filePayload->filepath);
+        if (file == nullptr) {
+            reporter.error("Could not open file " + filePayload->filepath);
+            return nullptr;
+        }
+
+        reporter.setCode(file->content(), file);
+
+        return std::make_shared<SourcePayload>(SourcePayload{.source = file->content(), .owner = file});
     }
 
     std::shared_ptr<Payload> StringInput::run(std::shared_ptr<Payload> payload) {
         const auto stringPayload = std::static_pointer_cast<StringPayload>(payload);
-        reporter.setCode(stringPayload->value);
+        reporter.setCode(stringPayload->value, stringPayload);
 
         // as we expected only StringPayload as input, we simply return it.
         return payload;
     }
+
+    //
+    // MappedFile
+    //
+
+    MappedFile::~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (data != nullptr && data != buffer.data()) {
+            munmap(const_cast<char *>(data), size);
+        }
+#endif
+    }
+
+    std::shared_ptr<MappedFile> MappedFile::open(const std::string &filepath) {
+        auto file = std::make_shared<MappedFile>();
+
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat stats{};
+        if (fstat(fd, &stats) != 0) {
+            close(fd);
+            return nullptr;
+        }
+
+        // An empty file can't be mapped, but doesn't need to be either.
+        if (stats.st_size > 0) {
+            void *memory = mmap(nullptr, stats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (memory != MAP_FAILED) {
+                // The source is scanned once from start to end.
+                madvise(memory, stats.st_size, MADV_SEQUENTIAL);
+
+                file->data = static_cast<const char *>(memory);
+                file->size = stats.st_size;
+                close(fd);
+
+                return file;
+            }
+        }
+
+        close(fd);
+#endif
+
+        // Either the file is empty, or it can't be mapped, e.g. because it is a pipe, therefor it is read instead.
+        auto ifs = std::ifstream(filepath);
+        if (!ifs) {
+            return nullptr;
+        }
+
+        file->buffer = std::string(std::istreambuf_iterator{ifs}, {});
+        file->data = file->buffer.data();
+        file->size = file->buffer.size();
+
+        return file;
+    }
 } // goo
@@ -5,17 +5,61 @@
 #ifndef INPUT_H
 #define INPUT_H
 
+#include <string>
+#include <string_view>
+
 #include "Payload.h"
 #include "Pipeline.h"
 
 namespace goo {
 
+    /// A file that is mapped read-only into memory, as long as the instance exists. On platforms without mmap, the
+    /// file is read into memory instead.
+    class MappedFile {
+        const char *data = nullptr;
+        std::size_t size = 0;
+
+        /// The content of the file, if it couldn't be mapped.
+        std::string buffer;
+
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /// Maps the file at the given path.
+        /// @return The mapped file, or nullptr if the file can't be opened.
+        static std::shared_ptr<MappedFile> open(const std::string &filepath);
+
+        [[nodiscard]] std::string_view content() const { return {data, size}; }
+    };
+
     /// An initial compiler phase that reads a file and returns its contents as payload for the next phase.
     class FileInput final : public Phase {
     public:
         explicit FileInput(Reporter &reporter) : Phase(reporter) {
         }
 
+        [[nodiscard]] std::string name() const override { return "file-input"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STRING; }
+
+        std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
+    };
+
+    /// An initial compiler phase that maps a file into memory, instead of reading it, and returns a SourcePayload of
+    /// its contents. Use StreamingParser to process the payload.
+    class MmapFileInput final : public Phase {
+    public:
+        explicit MmapFileInput(Reporter &reporter) : Phase(reporter) {
+        }
+
+        [[nodiscard]] std::string name() const override { return "mmap-file-input"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return SOURCE; }
+
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
     };
 
@@ -25,6 +69,10 @@ namespace goo {
         explicit StringInput(Reporter &reporter) : Phase(reporter) {
         }
 
+        [[nodiscard]] std::string name() const override { return "string-input"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STRING; }
+
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
     };
 } // goo
@@ -4,27 +4,23 @@
 
 #include "Interpreter.h"
 
-#include <cstring>
 #include <format>
 #include <iostream>
 #include <ostream>
 #include <utility>
-#include <unistd.h>
 
 #include "Payload.h"
 #include "Pipeline.h"
 #include "Reporter.h"
 
-#define TAPE_SIZE 30000
-
 namespace goo {
-    Interpreter::Interpreter(Reporter &reporter, std::ostream &out): Phase(reporter), tapePtr(0), out(out) {
-        tape = new char[TAPE_SIZE];
-        memset(tape, 0, TAPE_SIZE);
+    Interpreter::Interpreter(Reporter &reporter, std::ostream &out, const CellSemantics cellSemantics): Phase(reporter),
+        tapePtr(0), io(out), cellSemantics(cellSemantics) {
+        tape = allocateTape(cellSemantics);
     }
 
     Interpreter::~Interpreter() {
-        delete[] tape;
+        freeTape(tape);
         tape = nullptr;
 
         tapePtr = 0;
@@ -33,36 +29,46 @@ namespace goo {
     std::shared_ptr<Payload> Interpreter::run(const std::shared_ptr<Payload> payload) {
         const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
 
-        interpret(stmtPayload->stmts);
+        walk(stmtPayload->stmts);
+        io.flush();
 
         return nullptr;
     }
 
-    void Interpreter::interpret(const std::vector<std::shared_ptr<Stmt>> &stmts) {
-        for (const auto &stmt : stmts) {
-            if (stmt != nullptr) {
-                stmt->accept(this);
+    bool Interpreter::enterConditional(Conditional *) {
+        return tape[tapePtr] != 0;
+    }
 
-                if (reporter.hasError()) return;
-            }
-        }
+    bool Interpreter::leaveConditional(Conditional *) {
+        return tape[tapePtr] != 0;
+    }
+
+    bool Interpreter::isDone() const {
+        return reporter.hasError();
     }
 
     void Interpreter::visitIncrementByte(IncrementByte *stmt) {
-        tape[tapePtr] += stmt->count;
-        if (tape[tapePtr] < 0) {
-            tape[tapePtr] += 128;
+        char &cell = tape[cellPosition(tapePtr, stmt->offset, cellSemantics)];
+        cell += stmt->count;
+        if (cellSemantics == CELLS_COMPAT && cell < 0) {
+            cell += 128;
         }
     }
 
     void Interpreter::visitDecrementByte(DecrementByte *stmt) {
-        tape[tapePtr] -= stmt->count;
-        if (tape[tapePtr] < 0) {
-            tape[tapePtr] = 128 + tape[tapePtr];
+        char &cell = tape[cellPosition(tapePtr, stmt->offset, cellSemantics)];
+        cell -= stmt->count;
+        if (cellSemantics == CELLS_COMPAT && cell < 0) {
+            cell = 128 + cell;
         }
     }
 
     void Interpreter::visitIncrementPtr(IncrementPtr *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            tapePtr = (tapePtr + stmt->count) & (WRAP8_TAPE_SIZE - 1);
+            return;
+        }
+
         tapePtr += stmt->count;
 
         if (tapePtr >= TAPE_SIZE) {
@@ -73,6 +79,11 @@ namespace goo {
     }
 
     void Interpreter::visitDecrementPtr(DecrementPtr *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            tapePtr = (tapePtr - stmt->count) & (WRAP8_TAPE_SIZE - 1);
+            return;
+        }
+
         tapePtr -= stmt->count;
 
         if (tapePtr < 0) {
@@ -83,29 +94,23 @@ namespace goo {
     }
 
     void Interpreter::visitInput(Input *stmt) {
-        char buffer[1];
-        if (read(STDIN_FILENO, buffer, 1) == -1) {
+        if (io.read(tape[cellPosition(tapePtr, stmt->offset, cellSemantics)]) == READ_ERROR) {
             reporter.error(stmt->line, stmt->column,
                 "Failed to read user input.");
         }
-
-        tape[tapePtr] = buffer[0];
     }
 
     void Interpreter::visitOutput(Output *stmt) {
-        out << std::to_string(tape[tapePtr]) << std::flush;
-    }
-
-    void Interpreter::visitConditional(Conditional *stmt) {
-        while (tape[tapePtr] != 0 && !reporter.hasError()) {
-            interpret(stmt->stmts);
-        }
+        io.write(tape[cellPosition(tapePtr, stmt->offset, cellSemantics)]);
     }
 
     void Interpreter::visitDebug(Debug *stmt) {
+        io.flush();
+
+        auto &out = io.stream();
         out << std::format("DEBUG: line = {}, column = {}, ptr = {}, tape = ", stmt->line, stmt->column, tapePtr);
 
-        for (int idx = 0; idx < TAPE_SIZE; idx++) {
+        for (int idx = 0; idx < tapeSize(cellSemantics); idx++) {
             if (tape[idx] != 0) {
                 std::cout << std::format("[{} = {}]", idx, tape[idx]);
             }
@@ -115,27 +120,59 @@ namespace goo {
     }
 
     void Interpreter::visitReset(Reset *stmt) {
-        tape[tapePtr] = stmt->initialValue;
+        tape[cellPosition(tapePtr, stmt->tapePtrOffset, cellSemantics)] = stmt->initialValue;
     }
 
-    void Interpreter::visitTransfer(Transfer *stmt) {
-        int copyAddr = tapePtr + stmt->offset;
-        tape[copyAddr] += tape[tapePtr];
-        tape[tapePtr] = 0;
+    void Interpreter::visitLinearLoop(LinearLoop *stmt) {
+        // Like any other loop, a linear loop doesn't run at all if the counter is 0.
+        const auto counter = static_cast<unsigned char>(tape[tapePtr]);
+        if (counter == 0) {
+            return;
+        }
+
+        for (const auto &[offset, factor]: stmt->targets) {
+            char &cell = tape[cellPosition(tapePtr, offset, cellSemantics)];
 
-        if (tape[copyAddr] < 0) {
-            tape[copyAddr] += 128;
+            if (cellSemantics == CELLS_WRAP8) {
+                cell += static_cast<char>(counter * factor);
+            } else {
+                // Every iteration keeps the cell between 0 and 127, therefor the result is the sum modulo 128.
+                cell = static_cast<char>((cell + counter * factor) & 127);
+            }
         }
+
+        tape[tapePtr] = 0;
     }
 
-    void Interpreter::visitMultiply(Multiply *stmt) {
-        const int copyAddr = tapePtr + stmt->offset;
-        tape[copyAddr] += stmt->times * (tape[tapePtr] + stmt->count);
+    void Interpreter::visitScan(Scan *stmt) {
+        tapePtr = scanTape(tape, tapeSize(cellSemantics), tapePtr, stmt->stride);
+
+        // If no byte is 0 until the end of the tape, the loop moves beyond it, therefor we take this single step like
+        // the loop would, including the wrap-around, and continue the search at the other end of the tape.
+        while (tape[tapePtr] != 0) {
+            if (stmt->stride > 0) {
+                IncrementPtr step(stmt->column, stmt->line, stmt->stride);
+                visitIncrementPtr(&step);
+            } else {
+                DecrementPtr step(stmt->column, stmt->line, -stmt->stride);
+                visitDecrementPtr(&step);
+            }
+
+            tapePtr = scanTape(tape, tapeSize(cellSemantics), tapePtr, stmt->stride);
+        }
+    }
 
-        if (tape[copyAddr] < 0) {
-            tape[copyAddr] += 128;
+    void Interpreter::visitConstOutput(ConstOutput *stmt) {
+        for (const char c: stmt->value) {
+            io.write(c);
         }
     }
 
+    void Interpreter::visitTapeInit(TapeInit *stmt) {
+        for (const auto &[position, value]: stmt->cells) {
+            tape[position] = value;
+        }
 
+        tapePtr = stmt->tapePtr;
+    }
 } // goo
@@ -7,9 +7,11 @@
 
 #include <iostream>
 
+#include "InterpreterIo.h"
 #include "Payload.h"
 #include "Pipeline.h"
 #include "Stmt.h"
+#include "Tape.h"
 
 namespace goo {
     /// The core part of the REPL-mode. The interpreter walks the
@@ -26,20 +28,34 @@ namespace goo {
     /// they wrap around to their corresponding opposite, so 0-1 becomes 29,998
     /// and vice versa.
     ///
+    /// With CELLS_WRAP8, cells instead wrap around natively between 0 and 255 and the tape pointer wraps around the
+    /// 32,768 cells of the tape without any warning, matching the code generated by CodeGen for these semantics.
+    ///
+    /// Output is written as raw bytes and, like input, goes through an InterpreterIo. Buffered output is flushed at
+    /// the end of ::run, which is also the end of every line in the REPL, and before blocking on input.
+    ///
     /// A special debugging command has been added to the brainfuck command set,
     /// symbolized by the exclamation point (!). Using this command prints useful
     /// debug information about the current state of the Interpreter, such as the
     /// tape pointer and the tape itself.
-    class Interpreter final : public Phase, public Visitor {
+    class Interpreter final : public Phase, public StmtWalker {
         char *tape;
         int tapePtr;
 
-        std::ostream &out;
+        InterpreterIo io;
+
+        const CellSemantics cellSemantics;
+
+        /// The PartialEvaluator drives an interpreter statement by statement and needs to save and restore its state.
+        friend class PartialEvaluator;
 
     public:
-        explicit Interpreter(Reporter &reporter, std::ostream &out = std::cout);
+        explicit Interpreter(Reporter &reporter, std::ostream &out = std::cout,
+                             CellSemantics cellSemantics = CELLS_COMPAT);
         ~Interpreter() override;
 
+        [[nodiscard]] std::string name() const override { return "interpreter"; }
+
         /// Interprets a list of statements, modifying (if applicable) the internal type.
         /// This function returns no status code, but may set the warning or error flag.
         /// It is recommended to check both flags after execution to inform the user.
@@ -49,7 +65,13 @@ namespace goo {
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
 
     private:
-        void interpret(const std::vector<std::shared_ptr<Stmt>> &stmts);
+        /// Enters and repeats the body of a conditional as long as the byte at the tape pointer isn't 0.
+        bool enterConditional(Conditional *stmt) override;
+
+        bool leaveConditional(Conditional *stmt) override;
+
+        /// Execution stops after an error.
+        [[nodiscard]] bool isDone() const override;
 
         void visitIncrementByte(IncrementByte *stmt) override;
 
@@ -59,8 +81,6 @@ namespace goo {
 
         void visitDecrementPtr(DecrementPtr *stmt) override;
 
-        void visitConditional(Conditional *stmt) override;
-
         void visitOutput(Output *stmt) override;
 
         void visitInput(Input *stmt) override;
@@ -72,9 +92,13 @@ namespace goo {
 
         void visitReset(Reset *stmt) override;
 
-        void visitTransfer(Transfer *stmt) override;
+        void visitLinearLoop(LinearLoop *stmt) override;
+
+        void visitScan(Scan *stmt) override;
+
+        void visitConstOutput(ConstOutput *stmt) override;
 
-        void visitMultiply(Multiply *stmt) override;
+        void visitTapeInit(TapeInit *stmt) override;
     };
 } // goo
 
@@ -0,0 +1,42 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "InterpreterIo.h"
+
+namespace goo {
+    InterpreterIo::InterpreterIo(std::ostream &out, const int inputFd): out(out), inputFd(inputFd),
+                                                                       outBuffer(BUFFER_SIZE), inBuffer(BUFFER_SIZE) {
+    }
+
+    ReadResult InterpreterIo::read(char &byte) {
+        if (inPosition == inSize) {
+            // Reading may block, for example in an interactive session, therefor any pending output must be visible.
+            flush();
+
+            const auto count = ::read(inputFd, inBuffer.data(), inBuffer.size());
+            if (count < 0) {
+                return READ_ERROR;
+            }
+
+            inPosition = 0;
+            inSize = static_cast<std::size_t>(count);
+
+            if (count == 0) {
+                return READ_EOF;
+            }
+        }
+
+        byte = inBuffer[inPosition++];
+        return READ_OK;
+    }
+
+    void InterpreterIo::flush() {
+        if (outSize > 0) {
+            out.write(outBuffer.data(), static_cast<std::streamsize>(outSize));
+            outSize = 0;
+        }
+
+        out.flush();
+    }
+} // goo
@@ -0,0 +1,69 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef INTERPRETERIO_H
+#define INTERPRETERIO_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+
+namespace goo {
+    /// The outcome of InterpreterIo::read.
+    enum ReadResult : std::uint8_t {
+        READ_OK,
+
+        /// The end of the input has been reached. The byte remains untouched, like in the code generated by CodeGen.
+        READ_EOF,
+
+        READ_ERROR
+    };
+
+    /// The I/O layer shared by the Interpreter, the BytecodeInterpreter and the Jit. Output bytes are collected in a
+    /// buffer and only passed on to the stream once it is full or ::flush is called. Input is read in blocks from a
+    /// file descriptor, rather than byte by byte.
+    ///
+    /// Output is flushed before blocking on input, so that prompts are visible to the user. Any other flush, such as
+    /// at the end of a run, is the responsibility of the owner.
+    class InterpreterIo {
+        std::ostream &out;
+        const int inputFd;
+
+        std::vector<char> outBuffer;
+        std::size_t outSize = 0;
+
+        std::vector<char> inBuffer;
+        std::size_t inPosition = 0;
+        std::size_t inSize = 0;
+
+    public:
+        /// The size of each the output and the input buffer.
+        static constexpr std::size_t BUFFER_SIZE = 65536;
+
+        explicit InterpreterIo(std::ostream &out, int inputFd = STDIN_FILENO);
+
+        /// Appends a raw byte to the output buffer, flushing it first if it is full.
+        void write(const char byte) {
+            if (outSize == outBuffer.size()) {
+                flush();
+            }
+
+            outBuffer[outSize++] = byte;
+        }
+
+        /// Reads the next byte of the input, refilling the input buffer if it is exhausted.
+        /// @param byte Receives the byte, but only if READ_OK is returned.
+        ReadResult read(char &byte);
+
+        /// Passes any buffered output on to the stream and flushes it.
+        void flush();
+
+        /// Returns the underlying stream, for output that doesn't go through the buffer. Flush first to retain the
+        /// order of the output.
+        [[nodiscard]] std::ostream &stream() const { return out; }
+    };
+} // goo
+
+#endif //INTERPRETERIO_H
@@ -0,0 +1,222 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "IrAsmBuilder.h"
+
+#include <format>
+
+#include "Reporter.h"
+
+namespace goo {
+    IrAsmBuilder::IrAsmBuilder(Reporter &reporter, const int tapeSize): reporter(reporter) {
+        resb("tapePadding", TAPE_PADDING);
+        resb("tape", tapeSize + TAPE_PADDING);
+        startSymbol = symbols.intern("_start");
+
+        label("_start");
+        mov("rbx", "0");
+    }
+
+    std::string IrAsmBuilder::build() const {
+        std::string code;
+
+        // Most instructions render to less than 32 characters, therefor this avoids nearly all reallocations.
+        code.reserve(instructions.size() * 32 + 128);
+
+        code += "bits 64\n\n";
+        code += "section .bss\n\n";
+
+        for (const auto &[symbol, size]: bss) {
+            code += std::format("\t{}: resb {}\n\n", symbols.name(symbol), size);
+        }
+
+        code += std::format("\tglobal {}\n\n", symbols.name(startSymbol));
+
+        code += "section .text\n\n";
+
+        for (const auto &[opcode, dest, src]: instructions) {
+            switch (opcode) {
+                case ASM_LABEL:
+                    code += "\n";
+                    code += symbols.name(dest.symbol);
+                    code += ":";
+                    break;
+                case ASM_COMMENT:
+                    code += " ; ";
+                    code += comments[dest.symbol];
+                    break;
+                case ASM_NEW_LINE:
+                    code += "\n";
+                    break;
+                default:
+                    code += "\n\t";
+                    code += mnemonic(opcode);
+
+                    if (dest.kind != OPERAND_NONE) {
+                        code += " ";
+                        code += renderOperand(dest, symbols);
+                    }
+
+                    if (src.kind != OPERAND_NONE) {
+                        code += ", ";
+                        code += renderOperand(src, symbols);
+                    }
+
+                    break;
+            }
+        }
+
+        if (!rodata.empty()) {
+            code += "\n\nsection .rodata\n\n";
+
+            for (const auto &[symbol, bytes]: rodata) {
+                code += defineBytes(symbols.name(symbol), bytes);
+            }
+        }
+
+        return code;
+    }
+
+    AsmBuilder &IrAsmBuilder::mov(const std::string &dest, const std::string &src) {
+        return record(ASM_MOV, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::label(const std::string &name) {
+        instructions.push_back(AsmInstruction{
+            .opcode = ASM_LABEL,
+            .dest = AsmOperand{.kind = OPERAND_SYMBOL, .symbol = symbols.intern(name)}
+        });
+
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::x_or(const std::string &dest, const std::string &src) {
+        return record(ASM_XOR, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::a_nd(const std::string &dest, const std::string &src) {
+        return record(ASM_AND, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::syscall() {
+        instructions.push_back(AsmInstruction{.opcode = ASM_SYSCALL});
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::add(const std::string &dest, const std::string &src) {
+        return record(ASM_ADD, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::sub(const std::string &dest, const std::string &src) {
+        return record(ASM_SUB, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::mul(const std::string &src) {
+        return record(ASM_MUL, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::lea(const std::string &dest, const std::string &src) {
+        return record(ASM_LEA, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::cmp(const std::string &dest, const std::string &src) {
+        return record(ASM_CMP, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::jmp(const std::string &label) {
+        return record(ASM_JMP, label);
+    }
+
+    AsmBuilder &IrAsmBuilder::je(const std::string &label) {
+        return record(ASM_JE, label);
+    }
+
+    AsmBuilder &IrAsmBuilder::jne(const std::string &label) {
+        return record(ASM_JNE, label);
+    }
+
+    AsmBuilder &IrAsmBuilder::jg(const std::string &label) {
+        return record(ASM_JG, label);
+    }
+
+    AsmBuilder &IrAsmBuilder::jle(const std::string &label) {
+        return record(ASM_JLE, label);
+    }
+
+    AsmBuilder &IrAsmBuilder::jge(const std::string &label) {
+        return record(ASM_JGE, label);
+    }
+
+    AsmBuilder &IrAsmBuilder::movdqu(const std::string &dest, const std::string &src) {
+        return record(ASM_MOVDQU, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::pxor(const std::string &dest, const std::string &src) {
+        return record(ASM_PXOR, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::pcmpeqb(const std::string &dest, const std::string &src) {
+        return record(ASM_PCMPEQB, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::pmovmskb(const std::string &dest, const std::string &src) {
+        return record(ASM_PMOVMSKB, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::bsf(const std::string &dest, const std::string &src) {
+        return record(ASM_BSF, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::bsr(const std::string &dest, const std::string &src) {
+        return record(ASM_BSR, dest, src);
+    }
+
+    AsmBuilder &IrAsmBuilder::comment(const std::string &comment) {
+        comments.push_back(comment);
+
+        instructions.push_back(AsmInstruction{
+            .opcode = ASM_COMMENT,
+            .dest = AsmOperand{.symbol = static_cast<int>(comments.size() - 1)}
+        });
+
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::newLine() {
+        instructions.push_back(AsmInstruction{.opcode = ASM_NEW_LINE});
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::align(const int alignment) {
+        instructions.push_back(AsmInstruction{
+            .opcode = ASM_ALIGN,
+            .dest = AsmOperand{.kind = OPERAND_IMMEDIATE, .imm = alignment}
+        });
+
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::resb(const std::string &name, const std::size_t size) {
+        bss.push_back(BssSymbol{.symbol = symbols.intern(name), .size = size});
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::db(const std::string &name, const std::string &bytes) {
+        rodata.push_back(DataSymbol{.symbol = symbols.intern(name), .bytes = bytes});
+        return *this;
+    }
+
+    AsmBuilder &IrAsmBuilder::record(const AsmOpcode opcode, const std::string &dest, const std::string &src) {
+        AsmInstruction instruction{.opcode = opcode};
+
+        if (!parseOperand(dest, symbols, instruction.dest) ||
+            (!src.empty() && !parseOperand(src, symbols, instruction.src))) {
+            reporter.error(std::format("Internal Error: Unable to parse the operands '{}' and '{}'.", dest, src));
+            return *this;
+        }
+
+        instructions.push_back(instruction);
+        return *this;
+    }
+} // goo
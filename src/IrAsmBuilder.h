@@ -0,0 +1,121 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef IRASMBUILDER_H
+#define IRASMBUILDER_H
+
+#include <string>
+#include <vector>
+
+#include "AsmBuilder.h"
+#include "AsmInstruction.h"
+
+namespace goo {
+    class Reporter;
+
+    /// An implementation of AsmBuilder that records each call as a typed AsmInstruction, with labels and symbols
+    /// interned in a SymbolTable, instead of concatenating strings. The assembler code is only rendered by ::build and
+    /// is identical to the one produced by the StringAsmBuilder, including the boilerplate for the tape and _start.
+    ///
+    /// The recorded instructions are available via ::getInstructions, for stages that operate on the instructions
+    /// themselves. For example, the ElfAsmBuilder encodes them to machine code instead of rendering them.
+    ///
+    /// Operands that can't be parsed are reported as internal errors to the Reporter and the instruction is dropped.
+    class IrAsmBuilder : public AsmBuilder {
+    protected:
+        Reporter &reporter;
+
+        SymbolTable symbols;
+        std::vector<AsmInstruction> instructions;
+        std::vector<std::string> comments;
+
+        /// A symbol in .bss, which is only reserved, but not initialized.
+        struct BssSymbol {
+            int symbol;
+            std::size_t size;
+        };
+
+        std::vector<BssSymbol> bss;
+
+        /// A symbol in .rodata, which holds constant bytes.
+        struct DataSymbol {
+            int symbol;
+            std::string bytes;
+        };
+
+        std::vector<DataSymbol> rodata;
+
+        int startSymbol;
+
+    public:
+        explicit IrAsmBuilder(Reporter &reporter, int tapeSize = TAPE_SIZE);
+
+        /// Renders the recorded instructions as assembler code.
+        [[nodiscard]] std::string build() const override;
+
+        [[nodiscard]] const std::vector<AsmInstruction> &getInstructions() const { return instructions; }
+
+        [[nodiscard]] const SymbolTable &getSymbols() const { return symbols; }
+
+        AsmBuilder &mov(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &label(const std::string &name) override;
+
+        AsmBuilder &x_or(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &a_nd(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &syscall() override;
+
+        AsmBuilder &add(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &sub(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &mul(const std::string &src) override;
+
+        AsmBuilder &lea(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &cmp(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &jmp(const std::string &label) override;
+
+        AsmBuilder &je(const std::string &label) override;
+
+        AsmBuilder &jne(const std::string &label) override;
+
+        AsmBuilder &jg(const std::string &label) override;
+
+        AsmBuilder &jle(const std::string &label) override;
+
+        AsmBuilder &jge(const std::string &label) override;
+
+        AsmBuilder &movdqu(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &pxor(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &pcmpeqb(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &pmovmskb(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &bsf(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &bsr(const std::string &dest, const std::string &src) override;
+
+        AsmBuilder &comment(const std::string &comment) override;
+
+        AsmBuilder &newLine() override;
+
+        AsmBuilder &align(int alignment) override;
+
+        AsmBuilder &resb(const std::string &name, std::size_t size) override;
+
+        AsmBuilder &db(const std::string &name, const std::string &bytes) override;
+
+    protected:
+        /// Parses the operands and records the instruction.
+        AsmBuilder &record(AsmOpcode opcode, const std::string &dest, const std::string &src = "");
+    };
+} // goo
+
+#endif //IRASMBUILDER_H
@@ -0,0 +1,417 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "Jit.h"
+
+#include <cstring>
+#include <format>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Interpreter.h"
+#include "Reporter.h"
+
+/*
+ * Some notes on register usage of the generated code:
+ * rbx stores the address of the tape.
+ * r12 stores the tape pointer.
+ * r13 stores the address of the Jit instance, which is passed to every helper function.
+ * r14 stores the address of Jit::tapePtr, to write the tape pointer back on exit.
+ * rax, rcx, rdi, rsi and rdx are used as scratch registers and for calling helper functions.
+ *
+ * All of rbx and r12 to r15 are callee-saved, therefor calls to helper functions don't clobber our state.
+ */
+
+namespace goo {
+    namespace {
+        typedef void (*JitFunction)(char *tape, std::int64_t *tapePtr, Jit *jit);
+
+        /// Returns the memory operand of the cell at the tape pointer.
+        Memory cell() {
+            return Memory{.base = RBX, .index = R12};
+        }
+    }
+
+    Jit::Jit(Reporter &reporter, std::ostream &out, const CellSemantics cellSemantics): Phase(reporter), tapePtr(0),
+        io(out), cellSemantics(cellSemantics) {
+        tape = allocateTape(cellSemantics);
+    }
+
+    Jit::~Jit() {
+        freeTape(tape);
+        tape = nullptr;
+
+        tapePtr = 0;
+    }
+
+    bool Jit::isAvailable() {
+#if defined(__x86_64__) && defined(__linux__)
+        // Some systems forbid executable memory, therefor we try to allocate a page once to see if it is possible.
+        static const bool available = [] {
+            const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            void *memory = mmap(nullptr, pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                return false;
+            }
+
+            const bool executable = mprotect(memory, pageSize, PROT_READ | PROT_EXEC) == 0;
+            munmap(memory, pageSize);
+
+            return executable;
+        }();
+
+        return available;
+#else
+        return false;
+#endif
+    }
+
+    std::shared_ptr<Payload> Jit::run(const std::shared_ptr<Payload> payload) {
+        const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
+
+        encoder.reset();
+        positions.clear();
+        loopLabels.clear();
+        exitLabel = encoder.newLabel();
+
+        // Five pushes keep the stack aligned to 16 bytes, as required for calls to helper functions.
+        encoder.push(RBX);
+        encoder.push(R12);
+        encoder.push(R13);
+        encoder.push(R14);
+        encoder.push(R15);
+
+        encoder.mov(8, RBX, RDI);
+        encoder.mov(8, R14, RSI);
+        encoder.mov(8, R13, RDX);
+        encoder.mov(8, R12, Memory{.base = R14});
+
+        walk(stmtPayload->stmts);
+
+        encoder.bind(exitLabel);
+        encoder.mov(8, Memory{.base = R14}, R12);
+
+        encoder.pop(R15);
+        encoder.pop(R14);
+        encoder.pop(R13);
+        encoder.pop(R12);
+        encoder.pop(RBX);
+        encoder.ret();
+
+        if (!encoder.finish()) {
+            reporter.error("Internal Error: JIT produced a jump to an unknown label.");
+            return nullptr;
+        }
+
+        execute();
+
+        return nullptr;
+    }
+
+    void Jit::execute() {
+        const auto &code = encoder.bytes();
+        const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const auto size = (code.size() + pageSize - 1) / pageSize * pageSize;
+
+        // The memory is never writable and executable at the same time.
+        void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            reporter.error("Failed to allocate memory for the JIT.");
+            return;
+        }
+
+        memcpy(memory, code.data(), code.size());
+
+        if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+            reporter.error("Failed to make the JIT code executable.");
+            munmap(memory, size);
+            return;
+        }
+
+        const auto function = reinterpret_cast<JitFunction>(memory);
+        function(tape, &tapePtr, this);
+
+        munmap(memory, size);
+        io.flush();
+    }
+
+    void Jit::callHelper(const Stmt *stmt, const void *helper) {
+        encoder.mov(8, RDI, R13);
+        encoder.mov(4, RDX, static_cast<std::int64_t>(positions.size()));
+        encoder.mov(8, RAX, reinterpret_cast<std::int64_t>(helper));
+        encoder.call(RAX);
+
+        positions.push_back(SourcePosition{.line = stmt->line, .column = stmt->column});
+    }
+
+    Memory Jit::cellAt(const std::int32_t offset) {
+        if (offset == 0) {
+            return cell();
+        }
+
+        encoder.lea(RCX, Memory{.base = R12, .disp = offset});
+
+        if (cellSemantics == CELLS_WRAP8) {
+            encoder.alu(ALU_AND, 8, RCX, WRAP8_TAPE_SIZE - 1);
+            return Memory{.base = RBX, .index = RCX};
+        }
+
+        // As the offset is known, only the end of the tape it points to needs to be checked.
+        const auto inside = encoder.newLabel();
+
+        if (offset < 0) {
+            encoder.test(8, RCX, RCX);
+            encoder.jcc(COND_NS, inside);
+            encoder.alu(ALU_ADD, 8, RCX, TAPE_SIZE);
+        } else {
+            encoder.alu(ALU_CMP, 8, RCX, TAPE_SIZE);
+            encoder.jcc(COND_L, inside);
+            encoder.alu(ALU_SUB, 8, RCX, TAPE_SIZE);
+        }
+
+        encoder.bind(inside);
+        return Memory{.base = RBX, .index = RCX};
+    }
+
+    void Jit::addToCell(const std::int32_t offset, const X86Register amount) {
+        const auto target = cellAt(offset);
+
+        encoder.alu(ALU_ADD, 1, target, amount);
+        encoder.alu(ALU_AND, 1, target, 127);
+    }
+
+    void Jit::addToCellWrap8(const std::int32_t offset, const X86Register amount) {
+        encoder.lea(RCX, Memory{.base = R12, .disp = offset});
+        encoder.alu(ALU_AND, 8, RCX, WRAP8_TAPE_SIZE - 1);
+        encoder.alu(ALU_ADD, 1, Memory{.base = RBX, .index = RCX}, amount);
+    }
+
+    void Jit::output(Jit *jit, const char value, int) {
+        jit->io.write(value);
+    }
+
+    void Jit::outputString(Jit *jit, const std::string *value, int) {
+        for (const char c: *value) {
+            jit->io.write(c);
+        }
+    }
+
+    int Jit::input(Jit *jit, char *cell, const int position) {
+        if (jit->io.read(*cell) == READ_ERROR) {
+            const auto &[line, column] = jit->positions[position];
+            jit->reporter.error(line, column, "Failed to read user input.");
+            return 1;
+        }
+
+        return 0;
+    }
+
+    void Jit::warnIncrementPtr(Jit *jit, std::int64_t, const int position) {
+        const auto &[line, column] = jit->positions[position];
+        jit->reporter.warning(line, column,
+            "Attempted to move the tape pointer beyond the bounds of 30,000. Wrapping back to 0.");
+    }
+
+    void Jit::warnDecrementPtr(Jit *jit, std::int64_t, const int position) {
+        const auto &[line, column] = jit->positions[position];
+        jit->reporter.warning(line, column,
+            "Attempted to move the tape pointer below 0. Wrapping back to 29,999.");
+    }
+
+    void Jit::debug(Jit *jit, const std::int64_t tapePtr, const int position) {
+        const auto &[line, column] = jit->positions[position];
+        jit->io.flush();
+
+        auto &out = jit->io.stream();
+        out << std::format("DEBUG: line = {}, column = {}, ptr = {}, tape = ", line, column, tapePtr);
+
+        for (int idx = 0; idx < tapeSize(jit->cellSemantics); idx++) {
+            if (jit->tape[idx] != 0) {
+                out << std::format("[{} = {}]", idx, jit->tape[idx]);
+            }
+        }
+
+        out << std::endl;
+    }
+
+    std::int64_t Jit::scan(Jit *jit, const std::int64_t tapePtr, const int position, const int stride) {
+        const auto size = tapeSize(jit->cellSemantics);
+        auto ptr = scanTape(jit->tape, size, static_cast<int>(tapePtr), stride);
+
+        // Like the loop, we wrap around at the end of the tape and continue the search at the other end.
+        while (jit->tape[ptr] != 0) {
+            if (jit->cellSemantics == CELLS_WRAP8) {
+                ptr = (ptr + stride) & (WRAP8_TAPE_SIZE - 1);
+            } else if (stride > 0) {
+                warnIncrementPtr(jit, ptr, position);
+                ptr += stride - TAPE_SIZE;
+            } else {
+                warnDecrementPtr(jit, ptr, position);
+                ptr += stride + TAPE_SIZE;
+            }
+
+            ptr = scanTape(jit->tape, size, ptr, stride);
+        }
+
+        return ptr;
+    }
+
+    void Jit::visitIncrementByte(IncrementByte *stmt) {
+        const auto target = cellAt(stmt->offset);
+
+        if (cellSemantics == CELLS_WRAP8) {
+            encoder.alu(ALU_ADD, 1, target, static_cast<std::int8_t>(stmt->count));
+            return;
+        }
+
+        const auto guard = encoder.newLabel();
+
+        encoder.alu(ALU_ADD, 1, target, static_cast<std::int8_t>(stmt->count));
+        encoder.jcc(COND_NS, guard);
+        encoder.alu(ALU_ADD, 1, target, 128);
+        encoder.bind(guard);
+    }
+
+    void Jit::visitDecrementByte(DecrementByte *stmt) {
+        const auto target = cellAt(stmt->offset);
+
+        if (cellSemantics == CELLS_WRAP8) {
+            encoder.alu(ALU_SUB, 1, target, static_cast<std::int8_t>(stmt->count));
+            return;
+        }
+
+        const auto guard = encoder.newLabel();
+
+        encoder.alu(ALU_SUB, 1, target, static_cast<std::int8_t>(stmt->count));
+        encoder.jcc(COND_NS, guard);
+        encoder.alu(ALU_ADD, 1, target, 128);
+        encoder.bind(guard);
+    }
+
+    void Jit::visitIncrementPtr(IncrementPtr *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            encoder.alu(ALU_ADD, 8, R12, stmt->count);
+            encoder.alu(ALU_AND, 8, R12, WRAP8_TAPE_SIZE - 1);
+            return;
+        }
+
+        const auto guard = encoder.newLabel();
+
+        encoder.alu(ALU_ADD, 8, R12, stmt->count);
+        encoder.alu(ALU_CMP, 8, R12, TAPE_SIZE);
+        encoder.jcc(COND_L, guard);
+        encoder.alu(ALU_SUB, 8, R12, TAPE_SIZE);
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::warnIncrementPtr));
+        encoder.bind(guard);
+    }
+
+    void Jit::visitDecrementPtr(DecrementPtr *stmt) {
+        if (cellSemantics == CELLS_WRAP8) {
+            encoder.alu(ALU_SUB, 8, R12, stmt->count);
+            encoder.alu(ALU_AND, 8, R12, WRAP8_TAPE_SIZE - 1);
+            return;
+        }
+
+        const auto guard = encoder.newLabel();
+
+        encoder.alu(ALU_SUB, 8, R12, stmt->count);
+        encoder.jcc(COND_NS, guard);
+        encoder.alu(ALU_ADD, 8, R12, TAPE_SIZE);
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::warnDecrementPtr));
+        encoder.bind(guard);
+    }
+
+    bool Jit::enterConditional(Conditional *) {
+        const auto body = encoder.newLabel();
+        const auto exit = encoder.newLabel();
+
+        encoder.alu(ALU_CMP, 1, cell(), 0);
+        encoder.jcc(COND_E, exit);
+        encoder.bind(body);
+
+        loopLabels.emplace_back(body, exit);
+        return true;
+    }
+
+    bool Jit::leaveConditional(Conditional *) {
+        const auto [body, exit] = loopLabels.back();
+        loopLabels.pop_back();
+
+        // Checking the condition at the end of the loop saves a jump per iteration.
+        encoder.alu(ALU_CMP, 1, cell(), 0);
+        encoder.jcc(COND_NE, body);
+        encoder.bind(exit);
+
+        return false;
+    }
+
+    void Jit::visitOutput(Output *stmt) {
+        encoder.movzxByte(RSI, cellAt(stmt->offset));
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::output));
+    }
+
+    void Jit::visitInput(Input *stmt) {
+        encoder.lea(RSI, cellAt(stmt->offset));
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::input));
+
+        // In case of an error we stop the execution immediately, like the Interpreter.
+        encoder.test(4, RAX, RAX);
+        encoder.jcc(COND_NE, exitLabel);
+    }
+
+    void Jit::visitDebug(Debug *stmt) {
+        encoder.mov(8, RSI, R12);
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::debug));
+    }
+
+    void Jit::visitReset(Reset *stmt) {
+        encoder.mov(1, cellAt(stmt->tapePtrOffset), static_cast<std::int8_t>(stmt->initialValue));
+    }
+
+    void Jit::visitLinearLoop(LinearLoop *stmt) {
+        const auto exit = encoder.newLabel();
+
+        // Like any other loop, a linear loop doesn't run at all if the counter is 0.
+        encoder.alu(ALU_CMP, 1, cell(), 0);
+        encoder.jcc(COND_E, exit);
+        encoder.movzxByte(RAX, cell());
+
+        for (const auto &[offset, factor]: stmt->targets) {
+            // Only the low byte of counter * factor is relevant, which is the same for signed and unsigned factors.
+            encoder.imul(4, RDX, RAX, factor);
+
+            if (cellSemantics == CELLS_WRAP8) {
+                addToCellWrap8(offset, RDX);
+            } else {
+                addToCell(offset, RDX);
+            }
+        }
+
+        encoder.mov(1, cell(), 0);
+        encoder.bind(exit);
+    }
+
+    void Jit::visitScan(Scan *stmt) {
+        // The search itself is left to scanTape, which compares many bytes at once. The stride is passed as the fourth
+        // argument in rcx, which isn't touched by callHelper.
+        encoder.mov(8, RSI, R12);
+        encoder.mov(4, RCX, stmt->stride);
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::scan));
+        encoder.mov(8, R12, RAX);
+    }
+
+    void Jit::visitConstOutput(ConstOutput *stmt) {
+        // The statement outlives the execution of the machine code, therefor we can pass its value directly.
+        encoder.mov(8, RSI, reinterpret_cast<std::int64_t>(&stmt->value));
+        callHelper(stmt, reinterpret_cast<const void *>(&Jit::outputString));
+    }
+
+    void Jit::visitTapeInit(TapeInit *stmt) {
+        for (const auto &[position, value]: stmt->cells) {
+            encoder.mov(1, Memory{.base = RBX, .disp = position}, static_cast<std::int8_t>(value));
+        }
+
+        encoder.mov(8, R12, static_cast<std::int64_t>(stmt->tapePtr));
+    }
+} // goo
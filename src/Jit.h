@@ -0,0 +1,132 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef JIT_H
+#define JIT_H
+
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "Bytecode.h"
+#include "InterpreterIo.h"
+#include "Payload.h"
+#include "Pipeline.h"
+#include "Stmt.h"
+#include "Tape.h"
+#include "X86Encoder.h"
+
+namespace goo {
+    /// A just-in-time compiler that translates statements directly into x86-64 machine code, which is then executed
+    /// in-process. Compared to the interpreters, each statement turns into a handful of native instructions, without
+    /// any dispatch overhead.
+    ///
+    /// The semantics of the tape are identical to the ones of the Interpreter, for both CellSemantics. Operations that
+    /// need to interact with the rest of goo, such as printing a byte, reading input or reporting a wrap-around of the
+    /// tape pointer, call back into static helper functions of this class, so that output and warnings end up in the
+    /// same places as with the Interpreter. Like the Interpreter, the tape is kept between successive calls of ::run and
+    /// buffered output is flushed at the end of it.
+    ///
+    /// The JIT is only available on x86-64 Linux. Use ::isAvailable to check whether the current platform supports
+    /// it before adding it to a pipeline.
+    class Jit final : public Phase, public StmtWalker {
+        char *tape;
+        std::int64_t tapePtr;
+
+        InterpreterIo io;
+
+        const CellSemantics cellSemantics;
+
+        X86Encoder encoder;
+
+        /// The location in code of each call back into a helper function, to be able to report warnings and errors.
+        std::vector<SourcePosition> positions;
+
+        /// The label of the epilogue, which is jumped to in case of an error.
+        int exitLabel = 0;
+
+        /// The labels of the body and the exit of each conditional that is being translated, innermost last.
+        std::vector<std::pair<int, int>> loopLabels;
+
+    public:
+        explicit Jit(Reporter &reporter, std::ostream &out = std::cout, CellSemantics cellSemantics = CELLS_COMPAT);
+        ~Jit() override;
+
+        /// Returns true if the current platform supports executing generated machine code.
+        static bool isAvailable();
+
+        [[nodiscard]] std::string name() const override { return "jit"; }
+
+        /// Translates the statements into machine code and executes it, modifying (if applicable) the internal tape.
+        /// Like Interpreter::run, no status code is returned, but the warning or error flag may be set.
+        /// @param payload A payload of type StmtPayload. Nullptr-entries are being ignored.
+        std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
+
+    private:
+        /// Executes the machine code currently held by the encoder.
+        void execute();
+
+        /// Adds a call to a helper function. The first argument is always the Jit instance, the second one is loaded
+        /// by the caller into rsi and the third one is the index into ::positions for `stmt`.
+        void callHelper(const Stmt *stmt, const void *helper);
+
+        /// Returns the memory operand of the cell at `offset` relative to the tape pointer, which wraps around either end
+        /// of the tape like the tape pointer, see cellPosition. Clobbers rcx, unless `offset` is 0.
+        Memory cellAt(std::int32_t offset);
+
+        /// Adds the low byte of `amount` to the cell at `offset`, keeping the value between 0 and 127 (modulo 128).
+        /// Clobbers rcx.
+        void addToCell(std::int32_t offset, X86Register amount);
+
+        /// Adds the low byte of `amount` to the cell at `offset` with wrap8 semantics, wrapping the address around the
+        /// tape. Clobbers rcx.
+        void addToCellWrap8(std::int32_t offset, X86Register amount);
+
+        static void output(Jit *jit, char value, int position);
+
+        static void outputString(Jit *jit, const std::string *value, int position);
+
+        static int input(Jit *jit, char *cell, int position);
+
+        static void warnIncrementPtr(Jit *jit, std::int64_t unused, int position);
+
+        static void warnDecrementPtr(Jit *jit, std::int64_t unused, int position);
+
+        static void debug(Jit *jit, std::int64_t tapePtr, int position);
+
+        /// Searches the tape for the next byte that is 0, like Interpreter::visitScan, and returns its position.
+        static std::int64_t scan(Jit *jit, std::int64_t tapePtr, int position, int stride);
+
+        void visitIncrementByte(IncrementByte *stmt) override;
+
+        void visitDecrementByte(DecrementByte *stmt) override;
+
+        void visitIncrementPtr(IncrementPtr *stmt) override;
+
+        void visitDecrementPtr(DecrementPtr *stmt) override;
+
+        bool enterConditional(Conditional *stmt) override;
+
+        bool leaveConditional(Conditional *stmt) override;
+
+        void visitOutput(Output *stmt) override;
+
+        void visitInput(Input *stmt) override;
+
+        void visitDebug(Debug *stmt) override;
+
+        void visitReset(Reset *stmt) override;
+
+        void visitLinearLoop(LinearLoop *stmt) override;
+
+        void visitScan(Scan *stmt) override;
+
+        void visitConstOutput(ConstOutput *stmt) override;
+
+        void visitTapeInit(TapeInit *stmt) override;
+    };
+} // goo
+
+#endif //JIT_H
@@ -4,62 +4,403 @@
 
 #include "Optimizer.h"
 
-typedef std::vector<goo::OptimizationPass *> PassVector;
+#include <cstdlib>
+#include <format>
+#include <map>
+
+#include "Profile.h"
+#include "Reporter.h"
+#include "Tape.h"
 
 namespace goo {
+    /// Returns the number of statements, including the ones nested within conditionals.
+    static std::size_t countStmts(const StmtSpan stmts) {
+        std::size_t count = 0;
+        std::vector<StmtSpan> pending = {stmts};
+
+        while (!pending.empty()) {
+            const auto current = pending.back();
+            pending.pop_back();
+
+            count += current.size();
+
+            for (const auto &stmt: current) {
+                if (stmt->type == IF) {
+                    pending.push_back(static_cast<const Conditional *>(stmt)->stmts);
+                }
+            }
+        }
+
+        return count;
+    }
+
+    /// Returns the offset relative to the tape pointer of the byte a statement addresses, or 0 if it addresses none.
+    static int stmtOffset(const Stmt *stmt) {
+        switch (stmt->type) {
+            case INC_BYTE:
+                return static_cast<const IncrementByte *>(stmt)->offset;
+            case DEC_BYTE:
+                return static_cast<const DecrementByte *>(stmt)->offset;
+            case OUT:
+                return static_cast<const Output *>(stmt)->offset;
+            case IN:
+                return static_cast<const Input *>(stmt)->offset;
+            case RESET:
+                return static_cast<const Reset *>(stmt)->tapePtrOffset;
+            default:
+                return 0;
+        }
+    }
+
+    /// Returns the count of a byte or pointer increase/decrease, negated for decreases, or 0 for any other statement.
+    static int signedCount(const Stmt *stmt) {
+        switch (stmt->type) {
+            case INC_BYTE:
+                return static_cast<const IncrementByte *>(stmt)->count;
+            case DEC_BYTE:
+                return -static_cast<const DecrementByte *>(stmt)->count;
+            case INC_PTR:
+                return static_cast<const IncrementPtr *>(stmt)->count;
+            case DEC_PTR:
+                return -static_cast<const DecrementPtr *>(stmt)->count;
+            default:
+                return 0;
+        }
+    }
+
     std::shared_ptr<Payload> Optimizer::run(const std::shared_ptr<Payload> payload) {
-        // Add new passes to this list in the required order.
-        const PassVector passes = {
-            new GroupPass,
-            new ResetPass,
-            new TransferPass,
-            new MultiplyPass
-        };
+        // reset state for further reuse
+        stats.clear();
+        iterations = 0;
+        loopProfile = nullptr;
+        optimizedHotLoops = 0;
+
+        OptimizationVector passes;
+        for (const auto &name: config.passes.empty() ? passNames(config.level) : config.passes) {
+            const auto pass = createPass(name);
+
+            if (pass == nullptr) {
+                reporter.error(std::format("Unknown optimization pass: {}", name));
+                return payload;
+            }
+
+            passes.push_back(pass);
+            stats.push_back(PassStats{.name = name});
+        }
 
         const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
 
+        auto &arena = *stmtPayload->arena;
         auto stmts = stmtPayload->stmts;
 
-        for (const auto &it: passes) {
-            stmts = it->run(stmts);
-            delete it;
+        const int maxIterations = config.level >= 3 ? MAX_OPT_ITERATIONS : 1;
+        const bool countingStmts = config.statsOut != nullptr;
+
+        // Once none of the passes changes anything, further iterations won't either.
+        for (bool changed = true; changed && !passes.empty() && iterations < maxIterations;) {
+            changed = false;
+            iterations++;
+
+            for (std::size_t idx = 0; idx < passes.size(); idx++) {
+                auto &passStats = stats[idx];
+                passStats.runs++;
+
+                if (countingStmts) {
+                    passStats.stmtsBefore += countStmts(stmts);
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                const bool passChanged = passes[idx]->rewrite(stmts, arena);
+                passStats.duration += std::chrono::steady_clock::now() - start;
+
+                if (countingStmts) {
+                    passStats.stmtsAfter += countStmts(stmts);
+                }
+
+                if (passChanged) {
+                    passStats.changes++;
+                    changed = true;
+                }
+            }
+        }
+
+        if (config.profile != nullptr) {
+            // The loops are matched once the passes ran, as the profiled program was optimized likewise.
+            loopProfile = std::make_shared<const LoopProfile>(LoopProfile::match(*config.profile, stmts));
+
+            if (const auto matched = loopProfile->getLoopCount() - loopProfile->count(HEAT_UNKNOWN);
+                matched * 2 < loopProfile->getProfileLoopCount()) {
+                reporter.warning(std::format("Only {} of the {} loops of the profile match the program, as it changed "
+                                             "since it was profiled.", matched, loopProfile->getProfileLoopCount()));
+            }
+
+            if (config.level > 0 && maxIterations < MAX_OPT_ITERATIONS) {
+                OptimizationVector hotPasses;
+                for (const auto &name: config.passes.empty() ? passNames(3) : config.passes) {
+                    hotPasses.push_back(createPass(name));
+                }
+
+                // ReSharper disable once CppDFAUnusedValue
+                auto _ = optimizeHotLoops(stmts, hotPasses, arena);
+            }
+        }
+
+        if (config.statsOut != nullptr) {
+            printStats();
+        }
+
+        return std::make_shared<StmtPayload>(StmtPayload{
+            .stmts = stmts, .arena = stmtPayload->arena, .profile = loopProfile
+        });
+    }
+
+    std::vector<std::string> Optimizer::passNames(const int level) {
+        if (level <= 0) {
+            return {};
+        }
+
+        if (level == 1) {
+            return {"group", "reset"};
+        }
+
+        // Add new passes to this list in the required order.
+        return {"group", "reset", "linear-loop", "scan", "offset"};
+    }
+
+    std::shared_ptr<OptimizationPass> Optimizer::createPass(const std::string &name) {
+        if (name == "group") {
+            return std::make_shared<GroupPass>();
+        } else if (name == "reset") {
+            return std::make_shared<ResetPass>();
+        } else if (name == "linear-loop") {
+            return std::make_shared<LinearLoopPass>();
+        } else if (name == "scan") {
+            return std::make_shared<ScanPass>();
+        } else if (name == "offset") {
+            return std::make_shared<OffsetPass>();
+        }
+
+        return nullptr;
+    }
+
+    void Optimizer::printStats() const {
+        // The statistics are formatted as a whole, therefor the ones of files optimized concurrently don't interleave.
+        std::string text = config.statsFile.empty() ? "" : config.statsFile + ":\n";
+        text += std::format("Optimizer: {} iteration(s)\n", iterations);
+
+        for (const auto &[name, runs, duration, stmtsBefore, stmtsAfter, changes]: stats) {
+            const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+            text += std::format("  {}: {} run(s), {} changed, {} us, {} -> {} statements\n", name, runs, changes,
+                                micros, stmtsBefore, stmtsAfter);
+        }
+
+        if (loopProfile != nullptr) {
+            text += std::format("  profile: {} hot, {} warm, {} cold and {} unmatched of {} loop(s), {} hot loop(s) "
+                                "optimized further\n", loopProfile->count(HEAT_HOT), loopProfile->count(HEAT_WARM),
+                                loopProfile->count(HEAT_COLD), loopProfile->count(HEAT_UNKNOWN),
+                                loopProfile->getLoopCount(), optimizedHotLoops);
         }
 
-        return std::make_shared<StmtPayload>(StmtPayload{.stmts = stmts});
+        *config.statsOut << text << std::flush;
+    }
+
+    bool Optimizer::optimizeHotLoops(StmtVector &stmts, const OptimizationVector &passes, StmtArena &arena) {
+        /// A list of statements that is being searched for hot loops, along with the conditional it is the body of, if
+        /// any, and the statements that have been optimized so far.
+        struct Frame {
+            Conditional *conditional;
+            StmtSpan stmts;
+            std::size_t next;
+            StmtVector optimizedStmts;
+            bool changed;
+        };
+
+        std::vector<Frame> frames;
+        frames.push_back(Frame{
+            .conditional = nullptr, .stmts = stmts, .next = 0, .optimizedStmts = {}, .changed = false
+        });
+
+        while (true) {
+            // The frame must not be used once another one is pushed, as it may move.
+            auto &frame = frames.back();
+
+            if (frame.next == frame.stmts.size()) {
+                if (frames.size() == 1) {
+                    const bool changed = frame.changed;
+                    stmts = std::move(frame.optimizedStmts);
+                    return changed;
+                }
+
+                const auto conditional = frame.conditional;
+                const auto changed = frame.changed;
+                const auto body = std::move(frame.optimizedStmts);
+                frames.pop_back();
+
+                auto &parent = frames.back();
+                if (changed) {
+                    parent.optimizedStmts.push_back(arena.make<Conditional>(conditional->column, conditional->line,
+                                                                            arena.list(body)));
+                    parent.changed = true;
+                } else {
+                    parent.optimizedStmts.push_back(conditional);
+                }
+
+                continue;
+            }
+
+            const auto stmt = frame.stmts[frame.next++];
+
+            if (stmt->type != IF) {
+                frame.optimizedStmts.push_back(stmt);
+                continue;
+            }
+
+            const auto conditional = static_cast<Conditional *>(stmt);
+
+            if (loopProfile->heat(conditional) != HEAT_HOT) {
+                frames.push_back(Frame{
+                    .conditional = conditional, .stmts = conditional->stmts, .next = 0, .optimizedStmts = {},
+                    .changed = false
+                });
+                continue;
+            }
+
+            // The loop is rewritten as a list of its own, which allows the passes to replace the loop itself, for
+            // example with a Scan.
+            StmtVector loop{conditional};
+            bool loopChanged = false;
+
+            for (int iteration = 0; iteration < MAX_OPT_ITERATIONS; iteration++) {
+                bool passChanged = false;
+
+                for (const auto &pass: passes) {
+                    passChanged |= pass->rewrite(loop, arena);
+                }
+
+                if (!passChanged) {
+                    break;
+                }
+
+                loopChanged = true;
+            }
+
+            if (loopChanged) {
+                optimizedHotLoops++;
+                frame.changed = true;
+            }
+
+            frame.optimizedStmts.insert(frame.optimizedStmts.end(), loop.begin(), loop.end());
+        }
+    }
+
+    //
+    // OptimizationPass
+    //
+
+    StmtVector OptimizationPass::run(const StmtSpan stmts, StmtArena &arena) const {
+        StmtVector optimizedStmts(stmts.begin(), stmts.end());
+        // ReSharper disable once CppDFAUnusedValue
+        auto _ = rewrite(optimizedStmts, arena);
+
+        return optimizedStmts;
+    }
+
+    bool OptimizationPass::rewrite(StmtVector &stmts, StmtArena &arena) const {
+        /// A list of statements that is being rewritten, along with the conditional it is the body of, if any.
+        struct Frame {
+            Conditional *conditional;
+            StmtVector stmts;
+            std::size_t next;
+            bool changed;
+        };
+
+        std::vector<Frame> frames;
+        frames.push_back(Frame{.conditional = nullptr, .stmts = std::move(stmts), .next = 0, .changed = false});
+
+        while (true) {
+            // The frame must not be used once another one is pushed, as it may move.
+            auto &frame = frames.back();
+
+            // The bodies of the conditionals are rewritten first, one after another.
+            if (frame.next < frame.stmts.size()) {
+                if (const auto stmt = frame.stmts[frame.next]; stmt->type == IF) {
+                    const auto conditional = static_cast<Conditional *>(stmt);
+                    frames.push_back(Frame{
+                        .conditional = conditional,
+                        .stmts = StmtVector(conditional->stmts.begin(), conditional->stmts.end()),
+                        .next = 0,
+                        .changed = false
+                    });
+                } else {
+                    frame.next++;
+                }
+
+                continue;
+            }
+
+            const bool changed = rewriteStmts(frame.stmts, arena) || frame.changed;
+
+            if (frames.size() == 1) {
+                stmts = std::move(frame.stmts);
+                return changed;
+            }
+
+            const auto conditional = frame.conditional;
+            const auto body = std::move(frame.stmts);
+            frames.pop_back();
+
+            // Conditionals whose body didn't change are kept, to share them with the original statements.
+            auto &parent = frames.back();
+            if (changed) {
+                parent.stmts[parent.next] = arena.make<Conditional>(conditional->column, conditional->line,
+                                                                    arena.list(body));
+                parent.changed = true;
+            }
+
+            parent.next++;
+        }
     }
 
     //
     // GroupPass
     //
 
-    StmtVector GroupPass::run(const StmtVector &stmts) const { // NOLINT(*-no-recursion)
-        StmtVector optimizedStmts;
+    bool GroupPass::rewriteStmts(StmtVector &stmts, StmtArena &arena) const {
+        bool changed = false;
+
+        // As the statements are only ever reduced, the rewritten statements are written to the front of the list,
+        // which never overtakes the statement that is currently processed.
+        std::size_t out = 0;
 
-        for (int idx = 0; idx < stmts.size(); idx++) {
-            if (const auto &stmt = stmts[idx]; stmt->type < OUT) {
-                const auto groupedStmt = groupStmts(idx, stmts);
+        for (std::size_t idx = 0; idx < stmts.size(); idx++) {
+            if (const auto stmt = stmts[idx]; stmt->type < OUT) {
+                const auto first = idx;
+                const auto groupedStmt = groupStmts(idx, stmts, arena);
 
                 // if we can eliminate a statement (e.g. +-+-+), null is returned
                 if (groupedStmt != nullptr) {
-                    optimizedStmts.emplace_back(groupedStmt);
+                    stmts[out++] = groupedStmt;
                 }
-            } else if (stmt->type == IF) {
-                const auto conditional = std::static_pointer_cast<Conditional>(stmt);
-                const auto subStmts = run(conditional->stmts);
 
+                changed |= groupedStmt == nullptr || idx != first;
+            } else if (stmt->type == IF) {
                 // strip any conditionals that turn out to be empty
-                if (!subStmts.empty()) {
-                    optimizedStmts.emplace_back(new Conditional(stmt->column, stmt->line, subStmts));
+                if (!static_cast<const Conditional *>(stmt)->stmts.empty()) {
+                    stmts[out++] = stmt;
+                } else {
+                    changed = true;
                 }
             } else {
-                optimizedStmts.push_back(stmt);
+                stmts[out++] = stmt;
             }
         }
 
-        return optimizedStmts;
+        stmts.resize(out);
+        return changed;
     }
 
-    std::shared_ptr<Stmt> GroupPass::groupStmts(int &idx, const StmtVector &stmts) const {
+    Stmt *GroupPass::groupStmts(std::size_t &idx, const StmtSpan stmts, StmtArena &arena) {
+        const auto first = idx;
         auto stmt = stmts[idx];
 
         const int line = stmt->line;
@@ -68,19 +409,21 @@ namespace goo {
         const bool isByteOp = stmt->type < INC_PTR;
         const TokenType increase = isByteOp ? INC_BYTE : INC_PTR;
         const TokenType decrease = isByteOp ? DEC_BYTE : DEC_PTR;
+        const int offset = stmtOffset(stmt);
 
         int moves = 0;
 
         // We now iterate over all successive statements of the same type (ptr ops), where we track how many
-        // times we increase or decrease. Additionally, we delete all statements to prevent memory leaks, as
-        // we create a new grouped statements. At the end we decide, whether to create an increase or
-        // a decrease statement.
+        // times we increase or decrease. At the end we decide, whether to create an increase or a decrease
+        // statement.
         for (; idx < stmts.size(); idx++) {
             stmt = stmts[idx];
-            if (stmt->type == increase) {
-                moves++;
-            } else if (stmt->type == decrease) {
-                moves--;
+            if (isByteOp && stmtOffset(stmt) != offset) {
+                // byte operations at different offsets address different bytes
+                break;
+            } else if (stmt->type == increase || stmt->type == decrease) {
+                // statements that were grouped before, count more than one move
+                moves += signedCount(stmt);
             } else {
                 // if we have no ptr operator anymore, we break the loop
                 break;
@@ -91,20 +434,25 @@ namespace goo {
         // thus we have to process it normally.
         idx--;
 
+        // A single statement can't be grouped any further.
+        if (idx == first) {
+            return stmts[first];
+        }
+
         if (moves > 0) {
             if (isByteOp) {
-                return std::make_shared<IncrementByte>(column, line, moves);
+                return arena.make<IncrementByte>(column, line, moves, offset);
             } else {
-                return std::make_shared<IncrementPtr>(column, line, moves);
+                return arena.make<IncrementPtr>(column, line, moves);
             }
         } else if (moves < 0) {
             // As we have negative moves, we must negate them to have the positive value
             moves = -moves;
 
             if (isByteOp) {
-                return std::make_shared<DecrementByte>(column, line, moves);
+                return arena.make<DecrementByte>(column, line, moves, offset);
             } else {
-                return std::make_shared<DecrementPtr>(column, line, moves);
+                return arena.make<DecrementPtr>(column, line, moves);
             }
         }
 
@@ -115,178 +463,241 @@ namespace goo {
     // ResetPass
     //
 
-    StmtVector ResetPass::run(const StmtVector &stmts) const {
-        StmtVector optimizedStmts;
+    bool ResetPass::rewriteStmts(StmtVector &stmts, StmtArena &arena) const {
+        bool changed = false;
+        std::size_t out = 0;
 
         // We iterate over all statements trying to detect a pattern of Conditional->Decrease. In this case we
         // insert a new reset statement in place of the conditional.
-        for (int idx = 0; idx < stmts.size(); idx++) {
-            const auto &stmt = stmts[idx];
-            if (stmt->matches({IF, DEC_BYTE, FI})) {
+        for (std::size_t idx = 0; idx < stmts.size(); idx++) {
+            const auto stmt = stmts[idx];
+            if (isResetLoop(stmt)) {
                 // Now that we know that we reset the current byte we also check for an assign statement directly
                 // afterward: [-]+
                 int initialValue = 0;
 
                 if (idx + 1 < stmts.size() && stmts[idx + 1]->type == INC_BYTE) {
-                    const auto incByte = std::static_pointer_cast<IncrementByte>(stmts[idx + 1]);
-                    initialValue = incByte->count;
+                    if (const auto incByte = static_cast<const IncrementByte *>(stmts[idx + 1]);
+                        incByte->offset == 0) {
+                        initialValue = incByte->count;
 
-                    // increase index by one to skip this increase.
-                    idx++;
+                        // increase index by one to skip this increase.
+                        idx++;
+                    }
                 }
 
-                optimizedStmts.emplace_back(new Reset(stmt->column, stmt->line, initialValue, 0));
-                continue;
-            } else if (stmt->type == IF) {
-                const auto conditional = std::static_pointer_cast<Conditional>(stmt);
-
-                auto newStmts = run(conditional->stmts);
-                optimizedStmts.emplace_back(new Conditional(stmt->column, stmt->line, newStmts));
-                continue;
+                stmts[out++] = arena.make<Reset>(stmt->column, stmt->line, initialValue, 0);
+                changed = true;
+            } else {
+                // If we cannot detect a reset statement, we simply keep it untouched.
+                stmts[out++] = stmt;
             }
-
-            // If we cannot detect a reset statement, we simply add it untouched.
-            optimizedStmts.push_back(stmt);
         }
 
-        return optimizedStmts;
+        stmts.resize(out);
+        return changed;
+    }
+
+    bool ResetPass::isResetLoop(const Stmt *stmt) {
+        // The decrease must address the byte at the tape pointer, [>-<] doesn't reset anything.
+        return stmt->matches({IF, DEC_BYTE, FI}) &&
+               static_cast<const DecrementByte *>(static_cast<const Conditional *>(stmt)->stmts[0])->offset
+               == 0;
     }
 
     //
-    // TransferPass
+    // LinearLoopPass
     //
 
-    StmtVector TransferPass::run(const StmtVector &stmts) const {
-        StmtVector optimizedStmts;
-
-        // We iterate over all statements trying to detect a pattern of Conditional->Decrease. In this case we
-        // insert a new reset statement in place of the conditional.
-        for (const auto &stmt: stmts) {
-            if (stmt->type == IF) {
-                const auto conditional = std::static_pointer_cast<Conditional>(stmt);
-
-                int offset;
-                int incCount;
-                if (extract(conditional, offset, incCount) && incCount == 1) {
-                    optimizedStmts.emplace_back(new Transfer(stmt->column, stmt->line, offset));
-                    continue;
-                }
+    bool LinearLoopPass::rewriteStmts(StmtVector &stmts, StmtArena &arena) const {
+        bool changed = false;
 
-                // recursively step into the conditional and try to optimize yet again
-                auto newStmts = run(conditional->stmts);
-                optimizedStmts.emplace_back(new Conditional(stmt->column, stmt->line, newStmts));
+        for (auto &stmt: stmts) {
+            if (stmt->type != IF) {
                 continue;
             }
 
-            // If we cannot detect a reset statement, we simply add it untouched.
-            optimizedStmts.push_back(stmt);
+            if (const auto linearLoop = analyze(static_cast<const Conditional *>(stmt), arena); linearLoop != nullptr) {
+                stmt = linearLoop;
+                changed = true;
+            }
         }
 
-        return optimizedStmts;
+        return changed;
     }
 
-    bool TransferPass::extract(const std::shared_ptr<Conditional>& conditional, int &offset, int &incCount) const {
-        if (conditional->stmts.size() == 4) {
-            int ptrShift = 0;
-            int matchedAll = INC_BYTE | INC_PTR | DEC_BYTE | DEC_PTR;
-
-            for (int idx = 0; idx < conditional->stmts.size(); idx++) {
-                if (conditional->stmts[idx]->type == INC_BYTE) {
-                    const auto incByte = std::static_pointer_cast<IncrementByte>(conditional->stmts[idx]);
-                    incCount = incByte->count;
-
-                    matchedAll &= ~INC_BYTE;
-
-                    // If INC_PTR precedes INC_BYTE, we have a positive offset, otherwise a negative
-                    if (idx > 0) {
-                        if (conditional->stmts[idx - 1]->type == INC_PTR) {
-                            const auto incPtr = std::static_pointer_cast<IncrementPtr>(conditional->stmts[idx - 1]);
-                            offset = incPtr->count;
-                        } else if (conditional->stmts[idx - 1]->type == DEC_PTR) {
-                            const auto decPtr = std::static_pointer_cast<DecrementPtr>(conditional->stmts[idx - 1]);
-                            offset = -decPtr->count;
-                        } else {
-                            return false;
-                        }
-                    } else {
-                        return false;
-                    }
-                } else if (conditional->stmts[idx]->type == DEC_BYTE) {
-                    const auto decByte = std::static_pointer_cast<DecrementByte>(conditional->stmts[idx]);
-                    if (decByte->count != 1) {
-                        return false;
-                    }
+    LinearLoop *LinearLoopPass::analyze(const Conditional *conditional, StmtArena &arena) {
+        // We simulate a single iteration of the loop, tracking by how much each cell changes, relative to the counter.
+        std::map<int, int> deltas;
+        int offset = 0;
+
+        for (const auto &stmt: conditional->stmts) {
+            switch (stmt->type) {
+                case INC_BYTE: {
+                    const auto incByte = static_cast<const IncrementByte *>(stmt);
+                    deltas[offset + incByte->offset] += incByte->count;
+                    break;
+                }
+                case DEC_BYTE: {
+                    const auto decByte = static_cast<const DecrementByte *>(stmt);
+                    deltas[offset + decByte->offset] -= decByte->count;
+                    break;
+                }
+                case INC_PTR:
+                    offset += static_cast<const IncrementPtr *>(stmt)->count;
+                    break;
+                case DEC_PTR:
+                    offset -= static_cast<const DecrementPtr *>(stmt)->count;
+                    break;
+                default:
+                    // Any other statement, such as a nested conditional or I/O, can't be expressed linearly.
+                    return nullptr;
+            }
+        }
 
-                    matchedAll &= ~DEC_BYTE;
-                } else if (conditional->stmts[idx]->type == INC_PTR) {
-                    const auto incPtr = std::static_pointer_cast<IncrementPtr>(conditional->stmts[idx]);
-                    ptrShift += incPtr->count;
+        // Only if the loop ends where it started and counts down by one, the number of iterations is the counter.
+        if (offset != 0 || deltas[0] != -1) {
+            return nullptr;
+        }
 
-                    matchedAll &= ~INC_PTR;
-                } else if (conditional->stmts[idx]->type == DEC_PTR) {
-                    const auto decPtr = std::static_pointer_cast<DecrementPtr>(conditional->stmts[idx]);
-                    ptrShift -= decPtr->count;
+        std::vector<LinearTarget> targets;
 
-                    matchedAll &= ~DEC_PTR;
-                } else {
-                    return false;
-                }
+        for (const auto &[targetOffset, factor]: deltas) {
+            // Like all cells addressed by offset, the targets must not exceed the padding of the tape.
+            if (std::abs(targetOffset) > TAPE_PADDING) {
+                return nullptr;
             }
 
-            return ptrShift == 0 && matchedAll == 0;
+            if (targetOffset != 0 && factor != 0) {
+                targets.push_back(LinearTarget{.offset = targetOffset, .factor = factor});
+            }
         }
 
-        return false;
+        return arena.make<LinearLoop>(conditional->column, conditional->line, targets);
     }
 
     //
-    // MultiplyPass
+    // ScanPass
     //
 
-    StmtVector MultiplyPass::run(const StmtVector &stmts) const {
-        StmtVector optimizedStmts;
+    bool ScanPass::rewriteStmts(StmtVector &stmts, StmtArena &arena) const {
+        bool changed = false;
+
+        for (auto &stmt: stmts) {
+            if (stmt->type != IF) {
+                continue;
+            }
+
+            const auto conditional = static_cast<Conditional *>(stmt);
+
+            // After grouping, a loop that only moves the tape pointer consists of exactly one pointer movement.
+            if (stmt->matches({IF, INC_PTR, FI})) {
+                const auto incPtr = static_cast<const IncrementPtr *>(conditional->stmts[0]);
+                stmt = arena.make<Scan>(stmt->column, stmt->line, incPtr->count);
+                changed = true;
+            } else if (stmt->matches({IF, DEC_PTR, FI})) {
+                const auto decPtr = static_cast<const DecrementPtr *>(conditional->stmts[0]);
+                stmt = arena.make<Scan>(stmt->column, stmt->line, -decPtr->count);
+                changed = true;
+            }
+        }
 
-        // We iterate over all statements and try to detect this pattern: +[...]
+        return changed;
+    }
 
-        for (int idx = 0; idx < stmts.size(); idx++) {
-            const auto& stmt = stmts[idx];
+    //
+    // OffsetPass
+    //
 
-            bool isValidPreStmts = stmts[idx]->type == INC_BYTE || stmts[idx]->type == RESET;
-            if (isValidPreStmts && (idx + 1 < stmts.size() - 1 && stmts[idx + 1]->type == IF)) {
-                int times;
-                if (stmts[idx]->type == INC_BYTE) {
-                    const auto incByte = std::static_pointer_cast<IncrementByte>(stmt);
-                    times = incByte->count;
-                } else {
-                    const auto reset = std::static_pointer_cast<Reset>(stmt);
-                    times = reset->initialValue;
+    bool OffsetPass::rewriteStmts(StmtVector &stmts, StmtArena &arena) const {
+        bool changed = false;
 
-                    // This is a special case, as we need to create a new Reset statement with an initial value of 0
-                    optimizedStmts.emplace_back(new Reset(stmt->column, stmt->line, 0, reset->tapePtrOffset));
-                }
-                const auto conditional = std::static_pointer_cast<Conditional>(stmts[idx + 1]);
-
-                int offset;
-                int count;
-                if (extract(conditional, offset, count)) {
-                    optimizedStmts.emplace_back(new Multiply(stmt->column, stmt->line, offset, count, times));
-                    idx++; // increase idx by one to skip the following, already processed conditional
-                    continue;
-                }
+        // Every movement that is applied replaces at least one pointer movement, therefor the rewritten statements
+        // never overtake the statement that is currently processed.
+        std::size_t out = 0;
+        Movement movement;
+
+        for (std::size_t idx = 0; idx < stmts.size(); idx++) {
+            const auto stmt = stmts[idx];
 
-                // we need to add the increment byte statement and recursively step into the conditional,
-                // to try to optimize yet again
-                optimizedStmts.emplace_back(stmt);
+            if (stmt->type == INC_PTR || stmt->type == DEC_PTR) {
+                if (movement.offset == 0) {
+                    movement.first = stmt;
+                }
 
-                auto newStmts = run(conditional->stmts);
-                optimizedStmts.emplace_back(new Conditional(stmt->column, stmt->line, newStmts));
+                movement.offset += signedCount(stmt);
+                movement.stmts++;
                 continue;
             }
 
-            // If we cannot detect a reset statement, we simply add it untouched.
-            optimizedStmts.push_back(stmt);
+            const bool isAddressable = stmt->type == INC_BYTE || stmt->type == DEC_BYTE || stmt->type == RESET ||
+                                       stmt->type == OUT || stmt->type == IN;
+
+            // Any other statement depends on the position of the tape pointer, as does a cell beyond the padding.
+            if (!isAddressable || std::abs(movement.offset + stmtOffset(stmt)) > TAPE_PADDING) {
+                if (const auto applied = applyOffset(movement, arena, changed); applied != nullptr) {
+                    stmts[out++] = applied;
+                }
+            }
+
+            if (isAddressable && movement.offset != 0) {
+                stmts[out++] = shift(stmt, movement.offset, arena);
+                changed = true;
+            } else {
+                // The body of a conditional starts and ends at the tape pointer, as it may be run any number of
+                // times, therefor any movement within the body has been applied at its end already.
+                stmts[out++] = stmt;
+            }
         }
 
-        return optimizedStmts;
+        if (const auto applied = applyOffset(movement, arena, changed); applied != nullptr) {
+            stmts[out++] = applied;
+        }
+
+        stmts.resize(out);
+        return changed;
+    }
+
+    Stmt *OffsetPass::applyOffset(Movement &movement, StmtArena &arena, bool &changed) {
+        const auto [offset, count, first] = movement;
+        movement = Movement{};
+
+        // A single pointer movement, that wasn't deferred past any other statement, remains where it is.
+        if (count == 1) {
+            return first;
+        }
+
+        if (count > 1) {
+            changed = true;
+        }
+
+        if (offset > 0) {
+            return arena.make<IncrementPtr>(first->column, first->line, offset);
+        } else if (offset < 0) {
+            return arena.make<DecrementPtr>(first->column, first->line, -offset);
+        }
+
+        return nullptr;
+    }
+
+    Stmt *OffsetPass::shift(const Stmt *stmt, const int offset, StmtArena &arena) {
+        switch (stmt->type) {
+            case INC_BYTE: {
+                const auto incByte = static_cast<const IncrementByte *>(stmt);
+                return arena.make<IncrementByte>(stmt->column, stmt->line, incByte->count, incByte->offset + offset);
+            }
+            case DEC_BYTE: {
+                const auto decByte = static_cast<const DecrementByte *>(stmt);
+                return arena.make<DecrementByte>(stmt->column, stmt->line, decByte->count, decByte->offset + offset);
+            }
+            case RESET: {
+                const auto reset = static_cast<const Reset *>(stmt);
+                return arena.make<Reset>(stmt->column, stmt->line, reset->initialValue, reset->tapePtrOffset + offset);
+            }
+            case OUT:
+                return arena.make<Output>(stmt->column, stmt->line, stmtOffset(stmt) + offset);
+            default:
+                return arena.make<Input>(stmt->column, stmt->line, stmtOffset(stmt) + offset);
+        }
     }
 }
@@ -5,6 +5,9 @@
 #ifndef OPTIMIZER_H
 #define OPTIMIZER_H
 
+#include <chrono>
+#include <ostream>
+#include <string>
 #include <vector>
 
 #include "Optimizer.h"
@@ -13,24 +16,105 @@
 #include "Stmt.h"
 
 namespace goo {
+    class LoopProfile;
     class OptimizationPass;
+    class Profile;
 
-    typedef std::vector<std::shared_ptr<Stmt>> StmtVector;
     typedef std::vector<std::shared_ptr<OptimizationPass>> OptimizationVector;
 
+    /// The optimization level used by default, see OptimizerConfig::level.
+    constexpr int DEFAULT_OPT_LEVEL = 2;
+
+    /// The maximum number of times the passes are run at level 3, in case they never reach a fixed point.
+    constexpr int MAX_OPT_ITERATIONS = 16;
+
+    struct OptimizerConfig {
+        /// The optimization level from 0 to 3. Level 0 runs no passes at all, level 1 only groups statements and
+        /// detects resets, level 2 runs every pass once and level 3 runs every pass repeatedly, until the statements
+        /// no longer change (or MAX_OPT_ITERATIONS is reached).
+        const int level = DEFAULT_OPT_LEVEL;
+
+        /// The names of the passes to run in the given order, instead of the ones of the level, see
+        /// OptimizationPass::name. The level still decides how often they are run.
+        const std::vector<std::string> passes;
+
+        /// If set, the statistics of each pass are printed to this stream once the optimizer is done.
+        std::ostream *const statsOut = nullptr;
+
+        /// The file that is optimized, which heads the statistics if set, as files may be optimized concurrently.
+        const std::string statsFile;
+
+        /// If set, the profile is matched to the loops of the program and passed on with the statements, see
+        /// LoopProfile. Below level 3, hot loops are optimized as if it was level 3, with the passes of level 3 unless
+        /// passes are given.
+        const std::shared_ptr<const Profile> profile;
+    };
+
+    /// The statistics the Optimizer collects about a single pass. The statement counts include nested statements and
+    /// are summed up over all runs of the pass. As counting them requires a traversal of all statements, they are only
+    /// collected if OptimizerConfig::statsOut is set.
+    struct PassStats {
+        std::string name;
+        int runs = 0;
+        std::chrono::nanoseconds duration{0};
+        std::size_t stmtsBefore = 0;
+        std::size_t stmtsAfter = 0;
+
+        /// The number of runs that changed anything.
+        int changes = 0;
+    };
+
     /// A class that analyzes a list of statements and tries to group similar statements in an attempt to reduce the
-    /// number of operations and thus optimizing the code.
+    /// number of operations and thus optimizing the code. The statements are transformed by a pipeline of
+    /// OptimizationPass, as selected by the OptimizerConfig, which rewrite the statements in place.
     class Optimizer final : public Phase {
+        const OptimizerConfig config;
+
+        std::vector<PassStats> stats;
+        int iterations = 0;
+
+        /// The profile matched by the last ::run, if any, and the number of hot loops that were optimized further.
+        std::shared_ptr<const LoopProfile> loopProfile;
+        int optimizedHotLoops = 0;
+
     public:
-        explicit Optimizer(Reporter &reporter) : Phase(reporter) {
+        explicit Optimizer(Reporter &reporter) : Optimizer(OptimizerConfig{}, reporter) {
+        }
+
+        Optimizer(const OptimizerConfig &config, Reporter &reporter) : Phase(reporter), config(config) {
         }
 
+        [[nodiscard]] std::string name() const override { return "optimizer"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STMT; }
+
         /// Analyses a list of statements and creates an optimized list that groups duplicates, as well as (in the
-        /// future) unreachable or redundant code.
+        /// future) unreachable or redundant code. Unknown pass names are reported as errors.
         /// @param payload A list of statements that are to be optimized. Nullptr-entries are being ignored.
         /// @return A statement payload containing a list of optimized statements.
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
 
+        /// Returns the statistics of each pass of the last ::run, in the order the passes were run.
+        [[nodiscard]] const std::vector<PassStats> &getStats() const { return stats; }
+
+        /// Returns how often the passes were run during the last ::run.
+        [[nodiscard]] int getIterations() const { return iterations; }
+
+        /// Returns the names of the passes of an optimization level, in the order they are run.
+        static std::vector<std::string> passNames(int level);
+
+        /// Creates the pass with the given name, see OptimizationPass::name.
+        /// @return The pass, or nullptr if there is no pass of this name.
+        static std::shared_ptr<OptimizationPass> createPass(const std::string &name);
+
+    private:
+        /// Prints the collected statistics to OptimizerConfig::statsOut, headed by OptimizerConfig::statsFile.
+        void printStats() const;
+
+        /// Runs the passes on each hot loop (including the loop itself), until they no longer change it. Nested loops
+        /// are only visited if the enclosing loop isn't hot, as they are optimized along with it otherwise.
+        /// @return True if anything changed.
+        bool optimizeHotLoops(StmtVector &stmts, const OptimizationVector &passes, StmtArena &arena);
     };
 
     /// An optimization pass that transforms a list of statements.
@@ -38,14 +122,37 @@ namespace goo {
     public:
         virtual ~OptimizationPass() = default;
 
-        [[nodiscard]] virtual StmtVector run(const StmtVector &stmts) const = 0;
+        /// The name of the pass, as used by OptimizerConfig::passes and in the statistics of the Optimizer.
+        [[nodiscard]] virtual std::string name() const = 0;
+
+        /// Transforms the statements in place, constructing any new statements within the arena. Statements that
+        /// don't change are kept as they are, as are conditionals whose body doesn't change, therefor untouched
+        /// subtrees are shared with the original statements. As passes may run repeatedly, they must accept the output
+        /// of any other pass, including statements that address their byte by offset.
+        ///
+        /// The bodies of conditionals are transformed before the statements that contain them, with a stack of its
+        /// own instead of recursion, see ::rewriteStmts.
+        /// @return True if anything changed.
+        bool rewrite(StmtVector &stmts, StmtArena &arena) const;
+
+        /// Like ::rewrite, but returns the transformed statements instead, leaving `stmts` untouched.
+        [[nodiscard]] StmtVector run(StmtSpan stmts, StmtArena &arena) const;
+
+    protected:
+        /// Transforms a single list of statements in place, whose conditionals have been transformed already, like
+        /// ::rewrite does for all of them.
+        /// @return True if anything changed.
+        virtual bool rewriteStmts(StmtVector &stmts, StmtArena &arena) const = 0;
     };
 
     /// An optimization pass that matches patterns of repeating operations of type byte increase/decrease and
-    /// pointer increase/decrease.
+    /// pointer increase/decrease. Byte operations are only grouped if they address the same offset.
     class GroupPass final : public OptimizationPass {
     public:
-        [[nodiscard]] StmtVector run(const StmtVector &stmts) const override;
+        [[nodiscard]] std::string name() const override { return "group"; }
+
+    protected:
+        bool rewriteStmts(StmtVector &stmts, StmtArena &arena) const override;
 
     private:
         /// Groups a list of statements of a similar type (*BYTE or *PTR) into one single statement. The idx-param
@@ -53,32 +160,85 @@ namespace goo {
         /// element that was grouped, to allow for regular processing in the caller.
         /// @param idx The current index of stmts where grouping should begin.
         /// @param stmts A list of statements to group.
-        /// @return A statement that groups a list of successive statements.
-        std::shared_ptr<Stmt> groupStmts(int &idx, const StmtVector &stmts) const;
+        /// @param arena The arena to construct the grouped statement in.
+        /// @return A statement that groups a list of successive statements, which is the first statement itself if
+        /// there is nothing to group it with.
+        static Stmt *groupStmts(std::size_t &idx, StmtSpan stmts, StmtArena &arena);
     };
 
     /// A pass that detect patterns of type [-] and replaces them with a reset statement. If the reset pattern is
     /// immediately followed by an INC_BYTE ( [-]+ ), the count of the INC_BYTE is used as initial value, otherwise 0.
     class ResetPass final : public OptimizationPass {
     public:
-        [[nodiscard]] StmtVector run(const StmtVector &stmts) const override;
+        [[nodiscard]] std::string name() const override { return "reset"; }
+
+    protected:
+        bool rewriteStmts(StmtVector &stmts, StmtArena &arena) const override;
+
+    private:
+        /// Checks whether the statement is a conditional that only decreases the byte at the tape pointer.
+        static bool isResetLoop(const Stmt *stmt);
     };
 
-    /// A pass that detects patterns of type [>+<-], [->+<], [<+>-] or [>-<+>] and replaces them with two reset statements which moves the
-    /// value of the copier to the copy and clear the copies.
-    class TransferPass : public OptimizationPass {
+    /// A pass that detects loops that only increase or decrease bytes relative to the tape pointer, such as [->+<] or
+    /// [->++>+++<<], and replaces them with a LinearLoop. A loop qualifies, if its body doesn't move the tape pointer
+    /// overall and decreases the byte at the tape pointer by exactly 1, as it then runs as many times as this byte.
+    class LinearLoopPass final : public OptimizationPass {
     public:
-        [[nodiscard]] StmtVector run(const StmtVector &stmts) const override;
+        [[nodiscard]] std::string name() const override { return "linear-loop"; }
 
     protected:
-        bool extract(const std::shared_ptr<Conditional> &conditional, int &offset, int &incCount) const;
+        bool rewriteStmts(StmtVector &stmts, StmtArena &arena) const override;
+
+    private:
+        /// Analyses the body of a conditional and returns the equivalent linear loop.
+        /// @param conditional The conditional to analyse.
+        /// @return A LinearLoop, or nullptr if the conditional is no linear loop.
+        static LinearLoop *analyze(const Conditional *conditional, StmtArena &arena);
     };
 
-    /// A pass that detects patterns of type +[>+<-] or similar. Compared to TransferPass, this pass allows for more than
-    /// one increase statements in the conditional.
-    class MultiplyPass final : public TransferPass {
+    /// A pass that detects loops that only move the tape pointer, such as [>], [<] or [>>>>], and replaces them with a
+    /// Scan, which searches for the next byte that is 0 with the stride of the loop.
+    class ScanPass final : public OptimizationPass {
     public:
-        [[nodiscard]] StmtVector run(const StmtVector &stmts) const override;
+        [[nodiscard]] std::string name() const override { return "scan"; }
+
+    protected:
+        bool rewriteStmts(StmtVector &stmts, StmtArena &arena) const override;
+    };
+
+    /// A pass that defers pointer movements. Instead of moving the tape pointer, byte increase/decrease, reset, output
+    /// and input statements address their byte relative to the tape pointer, e.g. >+>+<< becomes two increase
+    /// statements at the offsets 1 and 2, without any pointer movement.
+    ///
+    /// The accumulated movement is only applied where the position of the tape pointer matters: before and at the end
+    /// of a conditional, before linear loops, scans and debug statements, at the end of the statements, and whenever
+    /// the offset would exceed TAPE_PADDING. Cells addressed beyond either end of the tape wrap around like the tape
+    /// pointer (see cellPosition), although the tape pointer only warns about it when the movement is applied.
+    /// Statements that already address their byte by offset are shifted by the deferred movement.
+    class OffsetPass final : public OptimizationPass {
+    public:
+        [[nodiscard]] std::string name() const override { return "offset"; }
+
+    protected:
+        bool rewriteStmts(StmtVector &stmts, StmtArena &arena) const override;
+
+    private:
+        /// A movement of the tape pointer that hasn't been applied yet.
+        struct Movement {
+            int offset = 0;
+
+            /// The number of pointer movements that make up this movement, and the first of them.
+            int stmts = 0;
+            Stmt *first = nullptr;
+        };
+
+        /// Returns the statement that applies the movement, if there is any, and resets the movement. This is the
+        /// original pointer movement, if the movement consists of exactly one, otherwise `changed` is set.
+        static Stmt *applyOffset(Movement &movement, StmtArena &arena, bool &changed);
+
+        /// Returns a copy of an addressable statement, that addresses its byte `offset` cells further.
+        static Stmt *shift(const Stmt *stmt, int offset, StmtArena &arena);
     };
 
 }
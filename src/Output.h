@@ -14,6 +14,8 @@ namespace goo {
         explicit OutputPhase(Reporter &reporter) : Phase(reporter) {
         }
 
+        [[nodiscard]] std::string name() const override { return "output"; }
+
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
     };
 } // goo
@@ -7,77 +7,114 @@
 #include <memory>
 
 #include "Payload.h"
+#include "Scanner.h"
 #include "Token.h"
 
 namespace goo {
 
-    std::shared_ptr<Payload> Parser::run(const std::shared_ptr<Payload> payload) {
-        // reset state of parser to allow for reuse
-        current = 0;
-
-        const auto tokenPayload = std::static_pointer_cast<TokenPayload>(payload);
-        tokens = tokenPayload->tokens;
-
-        std::vector<std::shared_ptr<Stmt>> stmts;
-        while (!isAtEnd()) {
-            stmts.emplace_back(std::shared_ptr<Stmt>(statement()));
-        }
-
-        return std::make_shared<StmtPayload>(StmtPayload { .stmts = stmts});
-    }
+    //
+    // StmtTreeBuilder
+    //
 
-    Stmt *Parser::statement() { // NOLINT(*-no-recursion)
-        switch (const auto token = tokens.at(current++); token->type) {
+    void StmtTreeBuilder::add(const TokenRun &token) {
+        switch (token.type) {
             case INC_BYTE:
-                return new IncrementByte(token->column, token->line);
+                stmts.push_back(arena->make<IncrementByte>(token.column, token.line, token.count));
+                break;
             case DEC_BYTE:
-                return new DecrementByte(token->column, token->line);
+                stmts.push_back(arena->make<DecrementByte>(token.column, token.line, token.count));
+                break;
             case INC_PTR:
-                return new IncrementPtr(token->column, token->line);
+                stmts.push_back(arena->make<IncrementPtr>(token.column, token.line, token.count));
+                break;
             case DEC_PTR:
-                return new DecrementPtr(token->column, token->line);
+                stmts.push_back(arena->make<DecrementPtr>(token.column, token.line, token.count));
+                break;
             case OUT:
-                return new Output(token->column, token->line);
+                stmts.push_back(arena->make<Output>(token.column, token.line));
+                break;
             case IN:
-                return new Input(token->column, token->line);
+                stmts.push_back(arena->make<Input>(token.column, token.line));
+                break;
             case IF:
-                return conditional(token->column, token->line);
+                open.push_back(OpenConditional{.column = token.column, .line = token.line, .start = stmts.size()});
+                break;
             case FI:
-                // If we reach this case, we have a closing tag ] without any
-                // opening. This is treated as a syntax error.
-                reporter.error(token->line, token->column, "Unexpected closing tag ]");
+                if (open.empty()) {
+                    // A closing tag ] without any opening is treated as a syntax error.
+                    reporter.error(token.line, token.column, "Unexpected closing tag ]");
+                } else {
+                    closeConditional();
+                }
                 break;
             case DEBUG:
-                return new Debug(token->column, token->line);
+                stmts.push_back(arena->make<Debug>(token.column, token.line));
+                break;
+            case EOF_:
+                // the end of the tokens is handled by ::finish
+                break;
             default:
                 // At this point there should be no unknown token type. Having
                 // reached this point means that we encountered an error.
-                reporter.error(token->line, token->column, "Unexpected tag");
+                reporter.error(token.line, token.column, "Unexpected tag");
                 break;
         }
-
-        return nullptr;
     }
 
-    Conditional *Parser::conditional(const int column, const int line) { // NOLINT(*-no-recursion)
-        std::vector<std::shared_ptr<Stmt>> stmts;
+    std::shared_ptr<StmtPayload> StmtTreeBuilder::finish() {
+        // Report the unmatched opening tags in the order they appear in the code.
+        for (const auto &conditional: open) {
+            reporter.error(conditional.line, conditional.column, "Unmatched opening tag [");
+        }
 
-        while (peek()->type != FI && !isAtEnd()) {
-            stmts.emplace_back(statement());
+        while (!open.empty()) {
+            closeConditional();
         }
 
-        // skip the FI token
-        current++;
+        return std::make_shared<StmtPayload>(StmtPayload{.stmts = std::move(stmts), .arena = arena});
+    }
+
+    void StmtTreeBuilder::closeConditional() {
+        const auto [column, line, start] = open.back();
+        open.pop_back();
 
-        return new Conditional(column, line, stmts);
+        const auto body = arena->list(StmtSpan(stmts).subspan(start));
+        stmts.resize(start);
+        stmts.push_back(arena->make<Conditional>(column, line, body));
     }
 
-    bool Parser::isAtEnd() const {
-        return current >= this->tokens.size() || peek()->type == EOF_;
+    //
+    // Parser
+    //
+
+    std::shared_ptr<Payload> Parser::run(const std::shared_ptr<Payload> payload) {
+        const auto tokenPayload = std::static_pointer_cast<TokenPayload>(payload);
+        StmtTreeBuilder builder(reporter);
+
+        for (const auto &token: tokenPayload->tokens) {
+            builder.add(TokenRun{.type = token->type, .count = 1, .line = token->line, .column = token->column});
+        }
+
+        return builder.finish();
     }
 
-    std::shared_ptr<Token> Parser::peek() const {
-        return this->tokens[current];
+    //
+    // StreamingParser
+    //
+
+    std::shared_ptr<Payload> StreamingParser::run(const std::shared_ptr<Payload> payload) {
+        const std::string_view source = inputType == SOURCE
+                                            ? std::static_pointer_cast<SourcePayload>(payload)->source
+                                            : std::static_pointer_cast<StringPayload>(payload)->value;
+
+        TokenStream stream(source, groupRuns);
+        StmtTreeBuilder builder(reporter);
+
+        for (auto token = stream.next(); token.type != EOF_; token = stream.next()) {
+            builder.add(token);
+        }
+
+        return builder.finish();
     }
 
-} // goo
\ No newline at end of file
+} // goo
@@ -4,54 +4,96 @@
 
 #ifndef PARSER_H
 #define PARSER_H
-#include <utility>
+#include <memory>
 #include <vector>
 
 #include "Payload.h"
 #include "Pipeline.h"
 #include "Reporter.h"
 #include "Stmt.h"
+#include "Token.h"
 
 namespace goo {
-    class Token;
+    /// Builds the tree of statements from a sequence of tokens, one token at a time, as used by the Parser and the
+    /// StreamingParser. Instead of recursing into conditionals, the open conditionals are tracked on an explicit
+    /// stack, therefor the depth of nesting is only limited by memory. Each closing tag ] is matched with the last
+    /// opening tag [ in the same pass, and unbalanced brackets are reported with their position.
+    class StmtTreeBuilder {
+        Reporter &reporter;
+        const std::shared_ptr<StmtArena> arena;
+
+        /// An opening tag [, whose closing tag hasn't been reached yet.
+        struct OpenConditional {
+            int column;
+            int line;
+
+            /// The index in stmts at which the body of the conditional starts.
+            std::size_t start;
+        };
+
+        std::vector<OpenConditional> open;
+
+        /// The statements of the top level, followed by the bodies of all open conditionals. Once a conditional is
+        /// closed, its body is moved into the arena and replaced by the conditional itself.
+        StmtVector stmts;
+
+    public:
+        explicit StmtTreeBuilder(Reporter &reporter) : reporter(reporter), arena(std::make_shared<StmtArena>()) {
+        }
+
+        /// Adds the statement represented by the token, or opens or closes a conditional. A closing tag ] without an
+        /// opening one, as well as unknown tokens, are reported as errors.
+        void add(const TokenRun &token);
+
+        /// Reports any conditional that hasn't been closed as error, and closes it at the end of the statements.
+        /// @return The statements, owned by the arena of the builder.
+        std::shared_ptr<StmtPayload> finish();
+
+    private:
+        void closeConditional();
+    };
 
     /// Parses a list of tokens, turning them into statements, which
     /// can be processed. The parser performs syntax-checking (as far as
     /// brainfuck contains possibilities for malformed syntax).
-    /// As each parser is initialized with one list of tokens, to process
-    /// a new list of tokens (for example, in REPL mode), it is necessary
-    /// to create a new instance.
     class Parser final : public Phase {
-        std::vector<std::shared_ptr<Token>> tokens;
-
-        int current = 0;
-
     public:
         explicit Parser(Reporter &reporter) : Phase(reporter) {}
 
-        /// Parses the list of tokens provided in the constructor. Each token is transformed into a
-        /// statement. In case of syntax errors the error flag is set and a new error message is being
+        [[nodiscard]] std::string name() const override { return "parser"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STMT; }
+
+        /// Parses the list of tokens of the payload. Each token is transformed into a statement, see
+        /// StmtTreeBuilder. In case of syntax errors the error flag is set and a new error message is being
         /// added, although the parser still tries to parse the following tokens. It is not recommended
         /// to interpret or compile the statements in case of error.
-        /// @return A list of statements. The caller of this function must take care to release the memory.
+        /// @return A list of statements, owned by a new StmtArena.
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
+    };
 
-    private:
-        /// Transforms the next token into a statement, performing basic syntax error checks. In case of error,
-        /// the error flag is set and nullptr is returned.
-        /// @return The statement represented by the current token. Nullptr in case of error.
-        Stmt *statement();
-
-        /// Creates a new conditional-statement, recursively calling ::statement() for each child-statement, as
-        /// long as the corresponding FI-statement is not reached. Due to the recursive nature of this function,
-        /// child-conditionals can be properly processed.
-        /// @param column The column of the current token.
-        /// @param line The line of the current line.
-        /// @return The conditional-statement represented by the current token.
-        Conditional *conditional(int column, int line);
-
-        [[nodiscard]] bool isAtEnd() const;
-        [[nodiscard]] std::shared_ptr<Token> peek() const;
+    /// Parses brainfuck source code directly, pulling one token at a time from a TokenStream, instead of
+    /// materializing a list of tokens first, like the Scanner and Parser do. Like the Parser, the statements are built
+    /// by a StmtTreeBuilder.
+    class StreamingParser final : public Phase {
+        const bool groupRuns;
+        const PayloadType inputType;
+
+    public:
+        /// @param groupRuns If true, runs of successive byte and pointer operations of the same kind are parsed into
+        /// a single statement each, see TokenStream.
+        /// @param inputType The type of payload to parse, either STRING or SOURCE.
+        StreamingParser(const bool groupRuns, const PayloadType inputType, Reporter &reporter) : Phase(reporter),
+            groupRuns(groupRuns), inputType(inputType) {
+        }
+
+        [[nodiscard]] std::string name() const override { return "streaming-parser"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STMT; }
+
+        /// Parses the source code of a StringPayload or SourcePayload into statements.
+        /// @return A list of statements, owned by a new StmtArena.
+        std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
     };
 } // goo
 
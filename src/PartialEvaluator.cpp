@@ -0,0 +1,196 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "PartialEvaluator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#include "Payload.h"
+#include "Reporter.h"
+
+namespace goo {
+    std::shared_ptr<Payload> PartialEvaluator::run(const std::shared_ptr<Payload> payload) {
+        const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
+        const auto &stmts = stmtPayload->stmts;
+
+        Reporter evaluationReporter;
+        std::stringstream output;
+        Interpreter evaluationInterpreter(evaluationReporter, output, config.cellSemantics);
+
+        interpreter = &evaluationInterpreter;
+        interpreterReporter = &evaluationReporter;
+        remainingSteps = config.stepBudget;
+        stopped = false;
+
+        const int size = tapeSize(config.cellSemantics);
+        const int paddedSize = size + 2 * TAPE_PADDING;
+
+        // The output and the state of the tape after the last statement that has been evaluated completely.
+        std::streamoff outputLength = 0;
+        std::vector<char> savedTape;
+
+        std::size_t idx = 0;
+        for (; idx < stmts.size(); idx++) {
+            const auto &stmt = stmts[idx];
+            const int savedTapePtr = interpreter->tapePtr;
+
+            // Only conditionals may stop after they already changed any cells, any other statement stops before.
+            if (stmt->type == IF) {
+                savedTape.assign(interpreter->tape - TAPE_PADDING, interpreter->tape - TAPE_PADDING + paddedSize);
+            }
+
+            stmt->accept(this);
+            interpreter->io.flush();
+
+            if (stopped) {
+                if (stmt->type == IF) {
+                    std::copy(savedTape.begin(), savedTape.end(), interpreter->tape - TAPE_PADDING);
+                }
+
+                interpreter->tapePtr = savedTapePtr;
+                break;
+            }
+
+            outputLength = output.tellp();
+        }
+
+        interpreter = nullptr;
+        interpreterReporter = nullptr;
+
+        // If not even the first statement could be evaluated, there is nothing to replace.
+        if (idx == 0) {
+            return payload;
+        }
+
+        auto &arena = *stmtPayload->arena;
+        StmtVector evaluatedStmts;
+
+        if (const auto value = output.str().substr(0, outputLength); !value.empty()) {
+            evaluatedStmts.push_back(arena.make<ConstOutput>(stmts[0]->column, stmts[0]->line, value));
+        }
+
+        if (idx < stmts.size()) {
+            std::vector<TapeCell> cells;
+
+            for (int position = -TAPE_PADDING; position < size + TAPE_PADDING; position++) {
+                if (const char value = evaluationInterpreter.tape[position]; value != 0) {
+                    cells.push_back(TapeCell{.position = position, .value = value});
+                }
+            }
+
+            evaluatedStmts.push_back(arena.make<TapeInit>(stmts[idx]->column, stmts[idx]->line, cells,
+                                                          evaluationInterpreter.tapePtr));
+            evaluatedStmts.insert(evaluatedStmts.end(), stmts.begin() + idx, stmts.end());
+        }
+
+        return std::make_shared<StmtPayload>(StmtPayload{
+            .stmts = evaluatedStmts, .arena = stmtPayload->arena, .profile = stmtPayload->profile
+        });
+    }
+
+    bool PartialEvaluator::step() {
+        if (remainingSteps <= 0) {
+            stopped = true;
+            return false;
+        }
+
+        remainingSteps--;
+        return true;
+    }
+
+    bool PartialEvaluator::scanTerminates(const int stride) const {
+        const int size = tapeSize(config.cellSemantics);
+        const int distance = std::gcd(std::abs(stride), size);
+
+        for (int position = interpreter->tapePtr % distance; position < size; position += distance) {
+            if (interpreter->tape[position] == 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void PartialEvaluator::execute(Stmt *stmt) {
+        if (!step()) {
+            return;
+        }
+
+        stmt->accept(interpreter);
+
+        // The interpreter only warns when the tape pointer wraps around, which is left to the backend to report.
+        if (interpreterReporter->hasWarnings()) {
+            stopped = true;
+        }
+    }
+
+    void PartialEvaluator::visitIncrementByte(IncrementByte *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitDecrementByte(DecrementByte *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitIncrementPtr(IncrementPtr *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitDecrementPtr(DecrementPtr *stmt) {
+        execute(stmt);
+    }
+
+    bool PartialEvaluator::enterConditional(Conditional *) {
+        return interpreter->tape[interpreter->tapePtr] != 0 && step();
+    }
+
+    bool PartialEvaluator::leaveConditional(Conditional *) {
+        return interpreter->tape[interpreter->tapePtr] != 0 && step();
+    }
+
+    void PartialEvaluator::visitOutput(Output *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitInput(Input *) {
+        stopped = true;
+    }
+
+    void PartialEvaluator::visitDebug(Debug *) {
+        stopped = true;
+    }
+
+    void PartialEvaluator::visitReset(Reset *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitLinearLoop(LinearLoop *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitScan(Scan *stmt) {
+        // A scan that doesn't find a byte that is 0 before the end of the tape wraps around, which may never end.
+        const int size = tapeSize(config.cellSemantics);
+        const int position = scanTape(interpreter->tape, size, interpreter->tapePtr, stmt->stride);
+
+        if (interpreter->tape[position] != 0 && !scanTerminates(stmt->stride)) {
+            stopped = true;
+            return;
+        }
+
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitConstOutput(ConstOutput *stmt) {
+        execute(stmt);
+    }
+
+    void PartialEvaluator::visitTapeInit(TapeInit *stmt) {
+        execute(stmt);
+    }
+} // goo
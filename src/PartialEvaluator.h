@@ -0,0 +1,117 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef PARTIALEVALUATOR_H
+#define PARTIALEVALUATOR_H
+
+#include <cstdint>
+
+#include "Interpreter.h"
+#include "Pipeline.h"
+#include "Stmt.h"
+#include "Tape.h"
+
+namespace goo {
+    /// The default number of steps the PartialEvaluator may take, see PartialEvaluatorConfig::stepBudget.
+    constexpr std::int64_t DEFAULT_STEP_BUDGET = 10'000'000;
+
+    struct PartialEvaluatorConfig {
+        const CellSemantics cellSemantics = CELLS_COMPAT;
+
+        /// The maximum number of steps to evaluate at compile time. Each executed statement and each iteration of a
+        /// conditional is one step.
+        const std::int64_t stepBudget = DEFAULT_STEP_BUDGET;
+    };
+
+    /// A phase that runs the beginning of a program at compile time, as far as it doesn't depend on any input. Many
+    /// programs compute a large part of their output deterministically, which then becomes a ConstOutput, followed by
+    /// a TapeInit that restores the state of the tape for the remaining statements. Programs that never read input are
+    /// reduced to a single ConstOutput.
+    ///
+    /// The statements are executed by an Interpreter on a tape of its own, therefor the results match the ones of the
+    /// Interpreter exactly. The evaluation proceeds statement by statement at the top level and stops before the first
+    /// statement that
+    ///
+    /// - reads input or prints debug information, even if it is nested within a conditional,
+    /// - exceeds the remaining step budget, or
+    /// - moves the tape pointer beyond either end of the tape, which is left to the backend, as it may warn about it.
+    ///
+    /// Any changes of such a statement are rolled back, and it remains part of the program along with all following
+    /// statements. Therefor, programs that consist of a single large loop can't be evaluated partially.
+    class PartialEvaluator final : public Phase, public StmtWalker {
+        const PartialEvaluatorConfig config;
+
+        /// The interpreter that executes each statement during ::run, on a tape of its own. Its warnings are collected
+        /// by a reporter of its own, as they only signal that the evaluation must stop.
+        Interpreter *interpreter = nullptr;
+        const Reporter *interpreterReporter = nullptr;
+
+        std::int64_t remainingSteps = 0;
+
+        /// Set once the statement that is currently evaluated can't be evaluated at compile time.
+        bool stopped = false;
+
+    public:
+        explicit PartialEvaluator(const PartialEvaluatorConfig config, Reporter &reporter) : Phase(reporter),
+                                                                                             config(config) {
+        }
+
+        [[nodiscard]] std::string name() const override { return "partial-evaluator"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return STMT; }
+
+        /// Evaluates the beginning of the statements, starting with an empty tape.
+        /// @param payload A payload of type StmtPayload.
+        /// @return A StmtPayload, beginning with the output and the state of the tape computed at compile time, if any,
+        /// followed by the statements that couldn't be evaluated.
+        std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
+
+    private:
+        /// Takes a single step, or stops the evaluation if the step budget is exhausted.
+        /// @return False if the evaluation has been stopped.
+        bool step();
+
+        /// Returns true if a Scan with this stride eventually finds a cell that is 0, as the loop would run forever
+        /// otherwise. The positions visited by the scan are all positions that differ from the tape pointer by a
+        /// multiple of gcd(stride, tape size).
+        [[nodiscard]] bool scanTerminates(int stride) const;
+
+        /// Takes a step and executes a statement that neither reads input nor contains other statements.
+        void execute(Stmt *stmt);
+
+        void visitIncrementByte(IncrementByte *stmt) override;
+
+        void visitDecrementByte(DecrementByte *stmt) override;
+
+        void visitIncrementPtr(IncrementPtr *stmt) override;
+
+        void visitDecrementPtr(DecrementPtr *stmt) override;
+
+        /// Enters and repeats the body of a conditional as long as the byte at the tape pointer isn't 0, taking a
+        /// step for each iteration.
+        bool enterConditional(Conditional *stmt) override;
+
+        bool leaveConditional(Conditional *stmt) override;
+
+        [[nodiscard]] bool isDone() const override { return stopped; }
+
+        void visitOutput(Output *stmt) override;
+
+        void visitInput(Input *stmt) override;
+
+        void visitDebug(Debug *stmt) override;
+
+        void visitReset(Reset *stmt) override;
+
+        void visitLinearLoop(LinearLoop *stmt) override;
+
+        void visitScan(Scan *stmt) override;
+
+        void visitConstOutput(ConstOutput *stmt) override;
+
+        void visitTapeInit(TapeInit *stmt) override;
+    };
+} // goo
+
+#endif //PARTIALEVALUATOR_H
@@ -6,12 +6,15 @@
 #define PAYLOAD_H
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Stmt.h"
+#include "StmtArena.h"
 #include "Token.h"
 
 namespace goo {
+    class LoopProfile;
 
     /// A base struct used for different payload implementations that are passed between compiler phases.
     struct Payload {};
@@ -26,14 +29,27 @@ namespace goo {
         const std::string value;
     };
 
+    /// A payload containing a view of source code that is owned by someone else, such as a MappedFile. The owner keeps
+    /// the source alive for as long as the payload exists.
+    struct SourcePayload : Payload {
+        const std::string_view source;
+        const std::shared_ptr<const void> owner;
+    };
+
     /// A payload containing a list of tokens.
     struct TokenPayload : Payload {
         const std::vector<std::shared_ptr<Token>> tokens;
     };
 
-    /// A payload containing a list of statements that may or may not be optimized.
+    /// A payload containing a list of statements that may or may not be optimized. The statements are owned by the
+    /// arena, which phases that create further statements should use as well.
     struct StmtPayload : Payload {
-        const std::vector<std::shared_ptr<Stmt>> stmts;
+        const StmtVector stmts;
+        const std::shared_ptr<StmtArena> arena;
+
+        /// The profile of the program, as matched by the Optimizer, if it was given one. Phases that pass on the
+        /// statements should pass on the profile, too.
+        const std::shared_ptr<const LoopProfile> profile;
     };
 
 }
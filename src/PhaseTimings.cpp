@@ -0,0 +1,79 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "PhaseTimings.h"
+
+#include <format>
+
+namespace goo {
+    static long long micros(const std::chrono::nanoseconds duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    }
+
+    /// Quotes a string for JSON.
+    static std::string quote(const std::string &value) {
+        std::string quoted = "\"";
+
+        for (const char character: value) {
+            if (character == '"' || character == '\\') {
+                quoted += '\\';
+                quoted += character;
+            } else if (static_cast<unsigned char>(character) < 0x20) {
+                quoted += std::format("\\u{:04x}", static_cast<int>(character));
+            } else {
+                quoted += character;
+            }
+        }
+
+        return quoted + "\"";
+    }
+
+    PhaseObserver PhaseTimings::observer() {
+        return [this](const PhaseTiming &timing) {
+            timings.push_back(timing);
+        };
+    }
+
+    void PhaseTimings::printTable(std::ostream &out) const {
+        // The table is formatted as a whole, therefor the rows of pipelines running concurrently don't interleave.
+        std::string table = file.empty() ? "" : file + ":\n";
+        table += std::format("{:<20} {:>12} {:>12} {:>14}  {}\n", "Phase", "Wall (us)", "CPU (us)", "Peak RSS (KiB)",
+                             "Payload");
+
+        std::chrono::nanoseconds totalWallTime{0};
+        std::chrono::nanoseconds totalCpuTime{0};
+
+        for (const auto &[phase, wallTime, cpuTime, peakRssDelta, payloadSize, payloadUnit]: timings) {
+            const auto payload = payloadUnit.empty() ? "-" : std::format("{} {}", payloadSize, payloadUnit);
+
+            table += std::format("{:<20} {:>12} {:>12} {:>14}  {}\n", phase, micros(wallTime), micros(cpuTime),
+                                 peakRssDelta / 1024, payload);
+
+            totalWallTime += wallTime;
+            totalCpuTime += cpuTime;
+        }
+
+        table += std::format("{:<20} {:>12} {:>12}\n", "total", micros(totalWallTime), micros(totalCpuTime));
+
+        out << table << std::flush;
+    }
+
+    void PhaseTimings::printJson(std::ostream &out) const {
+        std::string json = std::format("{{\"file\": {}, \"phases\": [", quote(file));
+
+        for (std::size_t idx = 0; idx < timings.size(); idx++) {
+            const auto &[phase, wallTime, cpuTime, peakRssDelta, payloadSize, payloadUnit] = timings[idx];
+
+            // Phase names and units consist of lower-case letters and dashes only, therefor they need no escaping.
+            json += std::format(
+                "{}{{\"phase\": \"{}\", \"wallUs\": {}, \"cpuUs\": {}, \"peakRssDeltaBytes\": {}, "
+                "\"payloadSize\": {}, \"payloadUnit\": \"{}\"}}",
+                idx > 0 ? ", " : "", phase, micros(wallTime), micros(cpuTime), peakRssDelta, payloadSize, payloadUnit);
+        }
+
+        json += "]}\n";
+
+        out << json << std::flush;
+    }
+} // goo
@@ -0,0 +1,46 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef PHASETIMINGS_H
+#define PHASETIMINGS_H
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Pipeline.h"
+
+namespace goo {
+    /// Collects the PhaseTiming of each phase of one or several pipelines and prints them as a table or as JSON.
+    ///
+    /// Usage:
+    ///   PhaseTimings timings("hello.bf");
+    ///   pipeline->setPhaseObserver(timings.observer());
+    ///   pipeline->execute(payload);
+    ///   timings.printTable(std::cerr);
+    class PhaseTimings {
+        const std::string file;
+        std::vector<PhaseTiming> timings;
+
+    public:
+        /// @param file The file the pipeline processes, which is printed along with the measurements, unless empty.
+        explicit PhaseTimings(std::string file = "") : file(std::move(file)) {
+        }
+
+        /// Returns an observer that adds the measurements to this instance, which must outlive the pipeline.
+        [[nodiscard]] PhaseObserver observer();
+
+        [[nodiscard]] const std::vector<PhaseTiming> &getTimings() const { return timings; }
+
+        /// Prints one row per phase, followed by the total wall and CPU time.
+        void printTable(std::ostream &out) const;
+
+        /// Prints a single line containing an object with the "file" and a "phases" array, whose times are given in
+        /// microseconds and sizes in bytes. Several files therefor result in one line of JSON each.
+        void printJson(std::ostream &out) const;
+    };
+} // goo
+
+#endif //PHASETIMINGS_H
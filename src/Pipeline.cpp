@@ -4,17 +4,25 @@
 
 #include "Pipeline.h"
 
+#include <ctime>
 #include <memory>
+#include <sys/resource.h>
 
 #include "AsmBuilder.h"
 #include "Assembler.h"
 #include "AstPrinter.h"
+#include "BytecodeInterpreter.h"
 #include "CodeGen.h"
+#include "ElfAsmBuilder.h"
+#include "ElfWriter.h"
 #include "Input.h"
 #include "Interpreter.h"
+#include "IrAsmBuilder.h"
+#include "Jit.h"
 #include "Optimizer.h"
 #include "Output.h"
 #include "Parser.h"
+#include "PartialEvaluator.h"
 #include "Reporter.h"
 #include "Scanner.h"
 
@@ -32,7 +40,7 @@ namespace goo {
         auto payload = initialPayload;
 
         for (const auto &phase: phases) {
-            payload = phase->run(payload);
+            payload = observer ? runMeasured(*phase, payload) : phase->run(payload);
 
             if (reporter.hasWarnings() || reporter.hasError()) {
                 reporter.print();
@@ -46,6 +54,91 @@ namespace goo {
         return true;
     }
 
+    /// Returns the CPU time the calling thread has consumed so far.
+    static std::chrono::nanoseconds threadCpuTime() {
+        timespec time{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+    }
+
+    /// Returns the peak resident set size of the process in bytes.
+    static long peakRss() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+
+        // Linux reports the maximum resident set size in KiB.
+        return usage.ru_maxrss * 1024;
+    }
+
+    /// Counts the statements, including the ones nested within conditionals. As conditionals may be nested deeper
+    /// than the call stack allows, this uses a stack of its own, like the StmtTreeBuilder.
+    static std::size_t countStmts(const StmtSpan stmts) {
+        std::size_t count = 0;
+        std::vector<StmtSpan> pending = {stmts};
+
+        while (!pending.empty()) {
+            const auto current = pending.back();
+            pending.pop_back();
+
+            count += current.size();
+
+            for (const auto &stmt: current) {
+                if (stmt != nullptr && stmt->type == IF) {
+                    pending.push_back(static_cast<const Conditional *>(stmt)->stmts);
+                }
+            }
+        }
+
+        return count;
+    }
+
+    std::shared_ptr<Payload> Pipeline::runMeasured(Phase &phase, const std::shared_ptr<Payload> &payload) const {
+        const auto rssBefore = peakRss();
+        const auto cpuStart = threadCpuTime();
+        const auto wallStart = std::chrono::steady_clock::now();
+
+        auto result = phase.run(payload);
+
+        PhaseTiming timing{
+            .phase = phase.name(),
+            .wallTime = std::chrono::steady_clock::now() - wallStart,
+            .cpuTime = threadCpuTime() - cpuStart,
+            .peakRssDelta = peakRss() - rssBefore
+        };
+
+        if (result != nullptr) {
+            switch (phase.outputType()) {
+                case FILE:
+                    timing.payloadSize = std::static_pointer_cast<FilePayload>(result)->filepath.size();
+                    timing.payloadUnit = "bytes";
+                    break;
+                case STRING:
+                    timing.payloadSize = std::static_pointer_cast<StringPayload>(result)->value.size();
+                    timing.payloadUnit = "bytes";
+                    break;
+                case SOURCE:
+                    timing.payloadSize = std::static_pointer_cast<SourcePayload>(result)->source.size();
+                    timing.payloadUnit = "bytes";
+                    break;
+                case TOKEN:
+                    timing.payloadSize = std::static_pointer_cast<TokenPayload>(result)->tokens.size();
+                    timing.payloadUnit = "tokens";
+                    break;
+                case STMT:
+                    timing.payloadSize = countStmts(std::static_pointer_cast<StmtPayload>(result)->stmts);
+                    timing.payloadUnit = "statements";
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        observer(timing);
+
+        return result;
+    }
+
     //
     // DebugPhase
     //
@@ -58,11 +151,14 @@ namespace goo {
             case STRING:
                 value = std::static_pointer_cast<StringPayload>(payload)->value;
                 break;
+            case SOURCE:
+                value = std::static_pointer_cast<SourcePayload>(payload)->source;
+                break;
             case TOKEN:
                 tokens = std::static_pointer_cast<TokenPayload>(payload)->tokens;
                 break;
             case STMT:
-                stmts = std::static_pointer_cast<StmtPayload>(payload)->stmts;
+                stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
                 break;
             default:
                 break;
@@ -84,11 +180,19 @@ namespace goo {
 
     PipelineBuilder &StandardPipelineBuilder::fileInput() {
         phases.emplace_back(std::make_shared<FileInput>(_reporter));
+        inputType = STRING;
         return *this;
     }
 
     PipelineBuilder &StandardPipelineBuilder::stringInput() {
         phases.emplace_back(std::make_shared<StringInput>(_reporter));
+        inputType = STRING;
+        return *this;
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::mmapFileInput() {
+        phases.emplace_back(std::make_shared<MmapFileInput>(_reporter));
+        inputType = SOURCE;
         return *this;
     }
 
@@ -102,17 +206,61 @@ namespace goo {
         return *this;
     }
 
+    PipelineBuilder &StandardPipelineBuilder::streamingParser(const bool groupRuns) {
+        phases.emplace_back(std::make_shared<StreamingParser>(groupRuns, inputType, _reporter));
+        return *this;
+    }
+
     PipelineBuilder &StandardPipelineBuilder::interpreter() {
         return interpreter(std::cout);
     }
 
     PipelineBuilder &StandardPipelineBuilder::interpreter(std::ostream &out) {
-        phases.emplace_back(std::make_shared<Interpreter>(_reporter, out));
+        return interpreter(out, CELLS_COMPAT);
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::interpreter(std::ostream &out, const CellSemantics cellSemantics) {
+        phases.emplace_back(std::make_shared<Interpreter>(_reporter, out, cellSemantics));
+        return *this;
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::bytecodeInterpreter() {
+        return bytecodeInterpreter(std::cout);
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::bytecodeInterpreter(std::ostream &out) {
+        return bytecodeInterpreter(out, CELLS_COMPAT);
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::bytecodeInterpreter(std::ostream &out,
+                                                                  const CellSemantics cellSemantics) {
+        phases.emplace_back(std::make_shared<BytecodeInterpreter>(_reporter, out, cellSemantics));
+        return *this;
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::jit() {
+        return jit(std::cout);
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::jit(std::ostream &out) {
+        return jit(out, CELLS_COMPAT);
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::jit(std::ostream &out, const CellSemantics cellSemantics) {
+        phases.emplace_back(std::make_shared<Jit>(_reporter, out, cellSemantics));
         return *this;
     }
 
     PipelineBuilder &StandardPipelineBuilder::codeGen(CodeGenConfig config) {
-        auto asmBuilder = std::static_pointer_cast<AsmBuilder>(std::make_shared<StringAsmBuilder>());
+        auto asmBuilder = std::static_pointer_cast<AsmBuilder>(std::make_shared<IrAsmBuilder>(_reporter,
+            tapeSize(config.cellSemantics)));
+        phases.emplace_back(std::make_shared<CodeGen>(config, asmBuilder, _reporter));
+        return *this;
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::elfCodeGen(CodeGenConfig config, const ElfType type) {
+        auto asmBuilder = std::static_pointer_cast<AsmBuilder>(std::make_shared<ElfAsmBuilder>(type, _reporter,
+            tapeSize(config.cellSemantics)));
         phases.emplace_back(std::make_shared<CodeGen>(config, asmBuilder, _reporter));
         return *this;
     }
@@ -122,11 +270,26 @@ namespace goo {
         return *this;
     }
 
+    PipelineBuilder &StandardPipelineBuilder::optimizer(OptimizerConfig config) {
+        phases.emplace_back(std::make_shared<Optimizer>(config, _reporter));
+        return *this;
+    }
+
+    PipelineBuilder &StandardPipelineBuilder::partialEvaluator(const PartialEvaluatorConfig config) {
+        phases.emplace_back(std::make_shared<PartialEvaluator>(config, _reporter));
+        return *this;
+    }
+
     PipelineBuilder &StandardPipelineBuilder::assembler(AssemblerConfig config) {
         phases.emplace_back(std::make_shared<Assembler>(config, _reporter));
         return *this;
     }
 
+    PipelineBuilder &StandardPipelineBuilder::elfWriter(ElfWriterConfig config) {
+        phases.emplace_back(std::make_shared<ElfWriter>(config, _reporter));
+        return *this;
+    }
+
     PipelineBuilder &StandardPipelineBuilder::astPrinter() {
         phases.emplace_back(std::make_shared<AstPrinter>(_reporter));
         return *this;
@@ -4,7 +4,11 @@
 
 #ifndef PIPELINE_H
 #define PIPELINE_H
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -12,6 +16,12 @@
 
 namespace goo {
     struct CodeGenConfig;
+    struct ElfWriterConfig;
+    struct OptimizerConfig;
+    struct PartialEvaluatorConfig;
+
+    enum ElfType : std::uint8_t;
+    enum CellSemantics : std::uint8_t;
 }
 
 namespace goo {
@@ -21,6 +31,41 @@ namespace goo {
     class PipelineBuilder;
     class Reporter;
 
+    /// The payload type that the debug phase is about to retrieve, or that a phase passes on.
+    /// This is important for correct casting and copying.
+    enum PayloadType {
+        FILE,
+        STRING,
+        SOURCE,
+        TOKEN,
+        STMT,
+        NO_PAYLOAD
+    };
+
+    /// The measurements of a single phase, as passed to the PhaseObserver of a Pipeline.
+    struct PhaseTiming {
+        /// The name of the phase, see Phase::name.
+        std::string phase;
+
+        std::chrono::nanoseconds wallTime{0};
+
+        /// The CPU time of the thread that ran the phase, which excludes the time of child processes such as nasm.
+        std::chrono::nanoseconds cpuTime{0};
+
+        /// How much the peak resident set size of the process grew while the phase ran, in bytes. As this is the peak
+        /// of the whole process, it is 0 for phases that don't exceed the memory of earlier phases, and includes the
+        /// memory of other pipelines that run concurrently.
+        long peakRssDelta = 0;
+
+        /// The size of the payload the phase passed on, in bytes, tokens or statements (including nested ones), as
+        /// given by the unit, which is empty for phases that pass on no payload.
+        std::size_t payloadSize = 0;
+        std::string payloadUnit;
+    };
+
+    /// A function that is called by Pipeline::execute after each phase.
+    typedef std::function<void(const PhaseTiming &)> PhaseObserver;
+
     /// A pipeline combines different phases of compilation and manages the
     /// execution of each phase, by retrieving the payload of the currently processing
     /// unit and passing it over to the next unit.
@@ -32,6 +77,7 @@ namespace goo {
     class Pipeline {
         Reporter &reporter;
         std::vector<std::shared_ptr<Phase> > phases;
+        PhaseObserver observer;
 
     public:
         explicit Pipeline(std::vector<std::shared_ptr<Phase> > phases, Reporter &reporter) : reporter(reporter),
@@ -45,6 +91,14 @@ namespace goo {
         /// @param initialPayload The payload to use for the first phase of the compiler, typically StringPayload or
         /// @return True if the execution was successful (i.e. without errors), otherwise false.
         [[nodiscard]] bool execute(const std::shared_ptr<Payload> &initialPayload) const;
+
+        /// Measures each phase that is run by ::execute and passes the measurements to the observer, including the
+        /// phase that reported an error, if any. Phases are only measured if an observer is set.
+        void setPhaseObserver(PhaseObserver phaseObserver) { observer = std::move(phaseObserver); }
+
+    private:
+        /// Runs a single phase and passes its measurements to the observer.
+        std::shared_ptr<Payload> runMeasured(Phase &phase, const std::shared_ptr<Payload> &payload) const;
     };
 
     /// A compiler phase which is part of a pipeline. A phase can be anything from extracting code from a source file
@@ -60,6 +114,12 @@ namespace goo {
         explicit Phase(Reporter &reporter): reporter(reporter) {
         }
 
+        /// The name of the phase, as used in the PhaseTiming of a Pipeline.
+        [[nodiscard]] virtual std::string name() const = 0;
+
+        /// The type of payload the phase passes on, which is NO_PAYLOAD for phases that pass on nullptr.
+        [[nodiscard]] virtual PayloadType outputType() const { return NO_PAYLOAD; }
+
         /// Runs the phase, processing the received payload and transforming it into a new payload that is being returned
         /// to the caller.
         /// @param payload A payload to process. If the payload is not of the expected type, the behavior of the method is undefined.
@@ -67,21 +127,12 @@ namespace goo {
         virtual std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) = 0;
     };
 
-    /// The payload type that the debug phase is about to retrieve.
-    /// This is important for correct casting and copying.
-    enum PayloadType {
-        FILE,
-        STRING,
-        TOKEN,
-        STMT
-    };
-
     /// A special Phase that is used for unit testing to interject a pipeline
     /// and retrieve the current payload.
     class DebugPhase final : public Phase {
         PayloadType type;
 
-        std::vector<std::shared_ptr<Stmt>> stmts;
+        std::shared_ptr<StmtPayload> stmtPayload;
         std::vector<std::shared_ptr<Token>> tokens;
         std::string value;
 
@@ -89,10 +140,17 @@ namespace goo {
         explicit DebugPhase(const PayloadType type, Reporter &reporter) : Phase(reporter), type(type) {
         }
 
-        [[nodiscard]] std::vector<std::shared_ptr<Stmt>> getStmts() const { return stmts; }
+        [[nodiscard]] const StmtVector &getStmts() const { return stmtPayload->stmts; }
+
+        /// Returns the payload of statements, which keeps the StmtArena and therefor the statements alive.
+        [[nodiscard]] std::shared_ptr<StmtPayload> getStmtPayload() const { return stmtPayload; }
         [[nodiscard]] std::vector<std::shared_ptr<Token>> getTokens() const { return tokens; }
         [[nodiscard]] std::string getValue() const { return value; }
 
+        [[nodiscard]] std::string name() const override { return "debug"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return type; }
+
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
     };
 
@@ -109,20 +167,56 @@ namespace goo {
 
         virtual PipelineBuilder &stringInput() = 0;
 
+        /// Like ::fileInput, but the file is mapped into memory instead of being read, see MmapFileInput. This must be
+        /// followed by ::streamingParser, as the Scanner only accepts the payload of ::fileInput or ::stringInput.
+        virtual PipelineBuilder &mmapFileInput() = 0;
+
         virtual PipelineBuilder &lexer() = 0;
 
         virtual PipelineBuilder &parser() = 0;
 
+        /// Replaces ::lexer and ::parser, parsing the source without materializing a list of tokens, see
+        /// StreamingParser.
+        /// @param groupRuns If true, runs of successive byte and pointer operations are parsed into single statements.
+        virtual PipelineBuilder &streamingParser(bool groupRuns) = 0;
+
         virtual PipelineBuilder &optimizer() = 0;
 
+        /// Like ::optimizer, but with the passes selected by the config instead of the default optimization level.
+        virtual PipelineBuilder &optimizer(OptimizerConfig config) = 0;
+
+        /// Evaluates the beginning of the program at compile time, see PartialEvaluator. Like the optimizer, this is
+        /// expected to follow the parser.
+        virtual PipelineBuilder &partialEvaluator(PartialEvaluatorConfig config) = 0;
+
         virtual PipelineBuilder &interpreter() = 0;
 
         virtual PipelineBuilder &interpreter(std::ostream &out) = 0;
 
+        virtual PipelineBuilder &interpreter(std::ostream &out, CellSemantics cellSemantics) = 0;
+
+        virtual PipelineBuilder &bytecodeInterpreter() = 0;
+
+        virtual PipelineBuilder &bytecodeInterpreter(std::ostream &out) = 0;
+
+        virtual PipelineBuilder &bytecodeInterpreter(std::ostream &out, CellSemantics cellSemantics) = 0;
+
+        virtual PipelineBuilder &jit() = 0;
+
+        virtual PipelineBuilder &jit(std::ostream &out) = 0;
+
+        virtual PipelineBuilder &jit(std::ostream &out, CellSemantics cellSemantics) = 0;
+
         virtual PipelineBuilder &codeGen(CodeGenConfig config) = 0;
 
+        /// Like ::codeGen, but the code is directly encoded to an ELF file of the given type, instead of assembler
+        /// code. Use ::elfWriter instead of ::assembler to write the result to disk.
+        virtual PipelineBuilder &elfCodeGen(CodeGenConfig config, ElfType type) = 0;
+
         virtual PipelineBuilder &assembler(AssemblerConfig config) = 0;
 
+        virtual PipelineBuilder &elfWriter(ElfWriterConfig config) = 0;
+
         virtual PipelineBuilder &astPrinter() = 0;
 
         virtual PipelineBuilder &output() = 0;
@@ -135,6 +229,9 @@ namespace goo {
         Reporter &_reporter;
         std::vector<std::shared_ptr<Phase> > phases;
 
+        /// The type of payload the input phase passes on, either STRING or SOURCE.
+        PayloadType inputType = STRING;
+
     public:
         explicit StandardPipelineBuilder(Reporter &reporter);
 
@@ -144,20 +241,46 @@ namespace goo {
 
         PipelineBuilder &stringInput() override;
 
+        PipelineBuilder &mmapFileInput() override;
+
         PipelineBuilder &lexer() override;
 
         PipelineBuilder &parser() override;
 
+        PipelineBuilder &streamingParser(bool groupRuns) override;
+
         PipelineBuilder &optimizer() override;
 
+        PipelineBuilder &optimizer(OptimizerConfig config) override;
+
+        PipelineBuilder &partialEvaluator(PartialEvaluatorConfig config) override;
+
         PipelineBuilder &interpreter() override;
 
         PipelineBuilder &interpreter(std::ostream &out) override;
 
+        PipelineBuilder &interpreter(std::ostream &out, CellSemantics cellSemantics) override;
+
+        PipelineBuilder &bytecodeInterpreter() override;
+
+        PipelineBuilder &bytecodeInterpreter(std::ostream &out) override;
+
+        PipelineBuilder &bytecodeInterpreter(std::ostream &out, CellSemantics cellSemantics) override;
+
+        PipelineBuilder &jit() override;
+
+        PipelineBuilder &jit(std::ostream &out) override;
+
+        PipelineBuilder &jit(std::ostream &out, CellSemantics cellSemantics) override;
+
         PipelineBuilder &codeGen(CodeGenConfig config) override;
 
+        PipelineBuilder &elfCodeGen(CodeGenConfig config, ElfType type) override;
+
         PipelineBuilder &assembler(AssemblerConfig config) override;
 
+        PipelineBuilder &elfWriter(ElfWriterConfig config) override;
+
         PipelineBuilder &astPrinter() override;
 
         PipelineBuilder &output() override;
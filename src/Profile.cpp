@@ -0,0 +1,266 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "Profile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <ranges>
+
+namespace goo {
+    namespace {
+        constexpr char PROFILE_MAGIC[8] = {'G', 'O', 'O', 'P', 'R', 'O', 'F', '\0'};
+
+        /// Appends a 32-bit integer in little-endian byte order.
+        void appendInt(std::string &bytes, const std::uint32_t value) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                bytes += static_cast<char>(value >> shift & 0xFF);
+            }
+        }
+
+        /// Reads a little-endian integer of `size` bytes at `position`.
+        std::uint64_t readInt(const std::string &bytes, const std::size_t position, const int size) {
+            std::uint64_t value = 0;
+
+            for (int idx = size - 1; idx >= 0; idx--) {
+                value = value << 8 | static_cast<unsigned char>(bytes[position + idx]);
+            }
+
+            return value;
+        }
+    }
+
+    std::string Profile::header(const std::vector<ProfileCounter> &counters) {
+        std::string bytes(PROFILE_MAGIC, sizeof(PROFILE_MAGIC));
+        appendInt(bytes, PROFILE_VERSION);
+        appendInt(bytes, static_cast<std::uint32_t>(counters.size()));
+
+        for (const auto &[kind, line, column, count]: counters) {
+            appendInt(bytes, static_cast<std::uint32_t>(line));
+            appendInt(bytes, static_cast<std::uint32_t>(column));
+            appendInt(bytes, kind);
+        }
+
+        return bytes;
+    }
+
+    std::optional<Profile> Profile::read(const std::string &filepath) {
+        std::ifstream ifs(filepath, std::ios::binary);
+        if (!ifs) {
+            return std::nullopt;
+        }
+
+        const std::string bytes(std::istreambuf_iterator{ifs}, {});
+
+        if (bytes.size() < PROFILE_HEADER_SIZE || memcmp(bytes.data(), PROFILE_MAGIC, sizeof(PROFILE_MAGIC)) != 0 ||
+            readInt(bytes, 8, 4) != PROFILE_VERSION) {
+            return std::nullopt;
+        }
+
+        const auto counterCount = readInt(bytes, 12, 4);
+        const auto valuesStart = PROFILE_HEADER_SIZE + counterCount * PROFILE_DESCRIPTOR_SIZE;
+
+        // The binary may have been killed before writing its counters, in which case the file is incomplete.
+        if (bytes.size() != valuesStart + counterCount * sizeof(std::uint64_t)) {
+            return std::nullopt;
+        }
+
+        std::vector<ProfileCounter> counters;
+        counters.reserve(counterCount);
+
+        for (std::size_t idx = 0; idx < counterCount; idx++) {
+            const auto descriptor = PROFILE_HEADER_SIZE + idx * PROFILE_DESCRIPTOR_SIZE;
+            const auto kind = readInt(bytes, descriptor + 8, 4);
+
+            if (kind > INPUTS) {
+                return std::nullopt;
+            }
+
+            counters.push_back(ProfileCounter{
+                .kind = static_cast<ProfileCounterKind>(kind),
+                .line = static_cast<int>(readInt(bytes, descriptor, 4)),
+                .column = static_cast<int>(readInt(bytes, descriptor + 4, 4)),
+                .count = readInt(bytes, valuesStart + idx * sizeof(std::uint64_t), 8)
+            });
+        }
+
+        return Profile(counters);
+    }
+
+    std::vector<ProfileLoop> Profile::loops() const {
+        // The entries and iterations of a loop are separate counters, therefor they are merged by position.
+        std::vector<ProfileLoop> loops;
+        std::map<std::pair<int, int>, std::size_t> indices;
+
+        for (const auto &[kind, line, column, count]: counters) {
+            if (kind != LOOP_ENTRIES && kind != LOOP_ITERATIONS) {
+                continue;
+            }
+
+            const auto [it, inserted] = indices.try_emplace({line, column}, loops.size());
+            if (inserted) {
+                loops.push_back(ProfileLoop{.line = line, .column = column});
+            }
+
+            auto &loop = loops[it->second];
+            (kind == LOOP_ENTRIES ? loop.entries : loop.iterations) += count;
+        }
+
+        return loops;
+    }
+
+    void Profile::print(std::ostream &out, const std::size_t limit) const {
+        std::uint64_t outputs = 0;
+        std::uint64_t inputs = 0;
+
+        for (const auto &[kind, line, column, count]: counters) {
+            if (kind == OUTPUTS) {
+                outputs += count;
+            } else if (kind == INPUTS) {
+                inputs += count;
+            }
+        }
+
+        auto loops = this->loops();
+        std::ranges::stable_sort(loops, std::ranges::greater{}, &ProfileLoop::iterations);
+
+        out << std::format("Hottest loops ({} of {}):", std::min(limit, loops.size()), loops.size()) << std::endl;
+
+        for (std::size_t idx = 0; idx < loops.size() && idx < limit; idx++) {
+            const auto &[line, column, entries, iterations] = loops[idx];
+            out << std::format("  {}:{}: {} iteration(s), {} entries", line, column, iterations, entries)
+                    << std::endl;
+        }
+
+        out << std::format("{} output(s), {} input(s)", outputs, inputs) << std::endl;
+    }
+
+    LoopProfile LoopProfile::match(const Profile &profile, const StmtSpan stmts) {
+        const auto loops = profile.loops();
+
+        std::uint64_t totalIterations = 0;
+        std::map<std::pair<int, int>, std::size_t> loopsByPosition;
+        std::multimap<int, std::size_t> loopsByLine;
+
+        for (std::size_t idx = 0; idx < loops.size(); idx++) {
+            totalIterations += loops[idx].iterations;
+            loopsByPosition[{loops[idx].line, loops[idx].column}] = idx;
+            loopsByLine.emplace(loops[idx].line, idx);
+        }
+
+        // The loops are collected in the order of the source, like the counters of the profile. Programs may nest
+        // deeper than the stack allows, therefor the statements are traversed iteratively.
+        std::vector<const Stmt *> loopStmts;
+        std::vector<StmtSpan> pending{stmts};
+
+        while (!pending.empty()) {
+            const auto span = pending.back();
+            pending.pop_back();
+
+            for (std::size_t idx = 0; idx < span.size(); idx++) {
+                if (span[idx]->type == LINEAR_LOOP || span[idx]->type == SCAN) {
+                    loopStmts.push_back(span[idx]);
+                }
+
+                if (span[idx]->type != IF) {
+                    continue;
+                }
+
+                loopStmts.push_back(span[idx]);
+
+                // The remainder of the span is visited after the body of the conditional.
+                pending.push_back(span.subspan(idx + 1));
+                pending.push_back(static_cast<const Conditional *>(span[idx])->stmts);
+                break;
+            }
+        }
+
+        constexpr auto unmatched = static_cast<std::size_t>(-1);
+        std::vector matches(loopStmts.size(), unmatched);
+        std::vector used(loops.size(), false);
+
+        for (std::size_t idx = 0; idx < loopStmts.size(); idx++) {
+            // Matching by position first could take a different loop, that moved to the position of this one.
+            if (loopStmts.size() == loops.size()) {
+                matches[idx] = idx;
+                continue;
+            }
+
+            const auto it = loopsByPosition.find({loopStmts[idx]->line, loopStmts[idx]->column});
+
+            if (it != loopsByPosition.end()) {
+                matches[idx] = it->second;
+                used[it->second] = true;
+            }
+        }
+
+        for (std::size_t idx = 0; idx < loopStmts.size(); idx++) {
+            if (matches[idx] != unmatched) {
+                continue;
+            }
+
+            // The nearest loop by line, and for loops on the same line by column.
+            const auto [line, column] = std::pair{loopStmts[idx]->line, loopStmts[idx]->column};
+            std::pair best{INT32_MAX, INT32_MAX};
+
+            const auto first = loopsByLine.lower_bound(line - PROFILE_LINE_TOLERANCE);
+            const auto last = loopsByLine.upper_bound(line + PROFILE_LINE_TOLERANCE);
+
+            for (auto it = first; it != last; ++it) {
+                const std::pair distance{std::abs(it->first - line), std::abs(loops[it->second].column - column)};
+
+                if (!used[it->second] && distance < best) {
+                    best = distance;
+                    matches[idx] = it->second;
+                }
+            }
+
+            if (matches[idx] != unmatched) {
+                used[matches[idx]] = true;
+            }
+        }
+
+        LoopProfile loopProfile;
+        loopProfile.loopCount = loopStmts.size();
+        loopProfile.profileLoopCount = loops.size();
+
+        for (std::size_t idx = 0; idx < loopStmts.size(); idx++) {
+            if (matches[idx] == unmatched) {
+                continue;
+            }
+
+            const auto &[line, column, entries, iterations] = loops[matches[idx]];
+            auto heat = HEAT_WARM;
+
+            if (entries == 0) {
+                heat = HEAT_COLD;
+            } else if (iterations >= HOT_LOOP_MIN_ITERATIONS &&
+                       static_cast<double>(iterations) >= HOT_LOOP_SHARE * static_cast<double>(totalIterations)) {
+                heat = HEAT_HOT;
+            }
+
+            loopProfile.heatByPosition[{loopStmts[idx]->line, loopStmts[idx]->column}] = heat;
+        }
+
+        return loopProfile;
+    }
+
+    LoopHeat LoopProfile::heat(const int line, const int column) const {
+        const auto it = heatByPosition.find({line, column});
+        return it != heatByPosition.end() ? it->second : HEAT_UNKNOWN;
+    }
+
+    std::size_t LoopProfile::count(const LoopHeat loopHeat) const {
+        if (loopHeat == HEAT_UNKNOWN) {
+            return loopCount - heatByPosition.size();
+        }
+
+        return std::ranges::count(heatByPosition | std::views::values, loopHeat);
+    }
+} // goo
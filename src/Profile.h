@@ -0,0 +1,151 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Stmt.h"
+
+namespace goo {
+    /// The version of the profile file format, see Profile.
+    constexpr std::uint32_t PROFILE_VERSION = 1;
+
+    /// The size of the header of a profile file, which consists of the magic bytes "GOOPROF\0", the version and the
+    /// number of counters.
+    constexpr std::size_t PROFILE_HEADER_SIZE = 16;
+
+    /// The size of the description of a single counter: its line, column and kind.
+    constexpr std::size_t PROFILE_DESCRIPTOR_SIZE = 12;
+
+    /// What a counter of a profiled binary counts.
+    enum ProfileCounterKind : std::uint8_t {
+        /// How often the execution reached a loop, including the times the loop was skipped. This includes linear
+        /// loops and scans.
+        LOOP_ENTRIES,
+
+        /// How often the body of a loop was executed. Linear loops and scans have no such counter, as they don't run
+        /// their body iteration by iteration.
+        LOOP_ITERATIONS,
+
+        /// How often an output statement was executed.
+        OUTPUTS,
+
+        /// How often an input statement was executed.
+        INPUTS
+    };
+
+    /// A single counter of a profile, which refers to the statement at the given position in the source.
+    struct ProfileCounter {
+        ProfileCounterKind kind;
+        int line;
+        int column;
+        std::uint64_t count = 0;
+    };
+
+    /// The counters of a single loop, merged from its LOOP_ENTRIES and LOOP_ITERATIONS counter.
+    struct ProfileLoop {
+        int line;
+        int column;
+        std::uint64_t entries = 0;
+        std::uint64_t iterations = 0;
+    };
+
+    /// The counters written by a binary that was compiled with CodeGenConfig::profileFile set. The file consists of
+    /// the header, the description of each counter and finally the value of each counter as 64-bit integer, all of
+    /// which are little-endian. Everything but the values is known at compile time, therefor the binary merely writes
+    /// the header and the descriptions from its constant data, followed by the counters from .bss.
+    class Profile {
+        std::vector<ProfileCounter> counters;
+
+    public:
+        Profile() = default;
+
+        explicit Profile(std::vector<ProfileCounter> counters) : counters(std::move(counters)) {
+        }
+
+        [[nodiscard]] const std::vector<ProfileCounter> &getCounters() const { return counters; }
+
+        /// Returns the header and the description of each counter, which precede the values in a profile file.
+        static std::string header(const std::vector<ProfileCounter> &counters);
+
+        /// Returns the counters of each loop, in the order their counters appear in the profile, which is the order of
+        /// the loops in the source.
+        [[nodiscard]] std::vector<ProfileLoop> loops() const;
+
+        /// Reads a profile file.
+        /// @return The profile, or std::nullopt if the file can't be read or isn't a profile of this version.
+        static std::optional<Profile> read(const std::string &filepath);
+
+        /// Prints the loops with the most iterations, at most `limit` of them, followed by the number of executed
+        /// output and input statements.
+        void print(std::ostream &out, std::size_t limit = 20) const;
+    };
+
+    /// The number of lines a loop may have moved since it was profiled, to still be matched by its position.
+    constexpr int PROFILE_LINE_TOLERANCE = 3;
+
+    /// The share of all iterations of a profile, which a loop must at least account for to be hot.
+    constexpr double HOT_LOOP_SHARE = 0.01;
+
+    /// The number of iterations a loop must at least have to be hot, so that short-running programs have no hot loops.
+    constexpr std::uint64_t HOT_LOOP_MIN_ITERATIONS = 1000;
+
+    /// How often a loop ran according to a profile, see LoopProfile.
+    enum LoopHeat : std::uint8_t {
+        /// The loop couldn't be matched to any loop of the profile.
+        HEAT_UNKNOWN,
+
+        /// The loop was never reached.
+        HEAT_COLD,
+
+        HEAT_WARM,
+
+        /// The loop has at least HOT_LOOP_MIN_ITERATIONS iterations and HOT_LOOP_SHARE of all iterations.
+        HEAT_HOT
+    };
+
+    /// A Profile matched to the loops of a program, which may have changed slightly since it was profiled. The loops
+    /// are conditionals, linear loops and scans, as the binary counts the entries of each of them. If the program
+    /// still has as many loops as the profile, they are matched by their index, as edits that neither add nor remove
+    /// loops keep their order. Otherwise, each loop of the program is matched by its position, or if that fails, the
+    /// nearest unmatched loop within PROFILE_LINE_TOLERANCE lines is taken, if any.
+    ///
+    /// Statements keep the position of the loop they were created from, therefor loops that are optimized any further
+    /// are looked up by the position of the original loop.
+    class LoopProfile {
+        std::map<std::pair<int, int>, LoopHeat> heatByPosition;
+        std::size_t loopCount = 0;
+        std::size_t profileLoopCount = 0;
+
+    public:
+        /// Matches the profile to the loops within the statements, which should have been optimized like the profiled
+        /// program, otherwise loops can only be matched by their position.
+        static LoopProfile match(const Profile &profile, StmtSpan stmts);
+
+        /// Returns the heat of the loop at the given position.
+        [[nodiscard]] LoopHeat heat(int line, int column) const;
+
+        [[nodiscard]] LoopHeat heat(const Stmt *stmt) const { return heat(stmt->line, stmt->column); }
+
+        /// Returns the number of loops of the program.
+        [[nodiscard]] std::size_t getLoopCount() const { return loopCount; }
+
+        /// Returns the number of loops of the profile, which is lower than the one of the program, if the beginning of
+        /// the program was evaluated at compile time, see PartialEvaluator.
+        [[nodiscard]] std::size_t getProfileLoopCount() const { return profileLoopCount; }
+
+        /// Returns the number of loops of the program that are of the given heat.
+        [[nodiscard]] std::size_t count(LoopHeat loopHeat) const;
+    };
+} // goo
+
+#endif //PROFILE_H
@@ -12,20 +12,27 @@
 
 namespace goo {
 
-    void Reporter::setCode(const std::string &code) {
-        codeLines = splitIntoLines(code);
+    void Reporter::setCode(std::string code) {
+        const auto owner = std::make_shared<const std::string>(std::move(code));
+        setCode(*owner, owner);
+    }
+
+    void Reporter::setCode(const std::string_view code, std::shared_ptr<const void> owner) {
+        this->code = code;
+        codeOwner = std::move(owner);
+        lineStarts.clear();
     }
 
     void Reporter::print() const {
         if (!errors.empty()) {
             for (const auto& error : errors) {
-                std::cout << error << std::endl;
+                out << error << std::endl;
             }
         }
 
         if (!warnings.empty()) {
             for (const auto& warning : warnings) {
-                std::cout << warning << std::endl;
+                out << warning << std::endl;
             }
         }
     }
@@ -37,8 +44,8 @@ namespace goo {
     void Reporter::error(const int line, const int column, const std::string &message) {
         errors.emplace_back(std::format("{}{}:{}: Error: {}", filename, line, column, message));
 
-        if (line < codeLines.size()) {
-            errors.emplace_back(std::format("\t{}\t|\t\t{}", line, codeLines.at(line - 1)));
+        if (const auto text = codeLine(line); text.has_value()) {
+            errors.emplace_back(std::format("\t{}\t|\t\t{}", line, *text));
             errors.emplace_back(std::format("\t\t|\t\t{}^", repeatString(" ", column - 1)));
         }
     }
@@ -50,8 +57,8 @@ namespace goo {
     void Reporter::warning(const int line, const int column, const std::string &message) {
         warnings.emplace_back(std::format("{}{}:{}: Warning: {}", filename, line, column, message));
 
-        if (line < codeLines.size()) {
-            warnings.emplace_back(std::format("\t{}\t|\t\t{}", line, codeLines.at(line - 1)));
+        if (const auto text = codeLine(line); text.has_value()) {
+            warnings.emplace_back(std::format("\t{}\t|\t\t{}", line, *text));
             warnings.emplace_back(std::format("\t\t|\t\t{}^", repeatString(" ", column - 1)));
         }
     }
@@ -61,4 +68,31 @@ namespace goo {
         warnings.clear();
     }
 
+    std::optional<std::string_view> Reporter::codeLine(const int line) {
+        if (lineStarts.empty() && !code.empty()) {
+            lineStarts.push_back(0);
+
+            for (std::size_t idx = 0; idx < code.size(); idx++) {
+                if (code[idx] == '\n') {
+                    lineStarts.push_back(idx + 1);
+                }
+            }
+        }
+
+        if (line < 1) {
+            return std::nullopt;
+        }
+
+        const auto index = static_cast<std::size_t>(line);
+
+        if (index > lineStarts.size()) {
+            return std::nullopt;
+        }
+
+        const auto start = lineStarts[index - 1];
+        const auto end = index < lineStarts.size() ? lineStarts[index] - 1 : code.size();
+
+        return code.substr(start, end - start);
+    }
+
 } // goo
\ No newline at end of file
@@ -5,7 +5,11 @@
 #ifndef ERRORTRACKER_H
 #define ERRORTRACKER_H
 
+#include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -17,24 +21,44 @@ namespace goo {
     /// checked via ::hasError and ::hasWarning.
     ///
     /// To report the tracked issues to the user, use ::print. This method prints the errors and warnings to
-    /// standard out. Afterward use ::clear to reset the state of the reporter for further use.
+    /// standard out, or the stream given to the constructor. Afterward use ::clear to reset the state of the reporter
+    /// for further use.
     class Reporter {
         std::vector<std::string> errors;
         std::vector<std::string> warnings;
 
         std::string filename;
-        std::vector<std::string> codeLines;
+        std::ostream &out;
+
+        /// The code that errors and warnings refer to, which is kept alive by its owner.
+        std::string_view code;
+        std::shared_ptr<const void> codeOwner;
+
+        /// The offset at which each line of the code starts. As most runs don't report anything, the lines are only
+        /// determined once a diagnostic refers to one of them.
+        std::vector<std::size_t> lineStarts;
 
     public:
         /// Creates a new reporter instance, adding an optional filename that is
         /// prepended to every error and warning line.
         /// @param filename An optional filename that is added to every error and warning line.
-        explicit Reporter(std::string filename = ""): filename(std::move(filename) + ": ") {}
+        /// @param out The stream to print errors, warnings and other messages to, e.g. to buffer them.
+        explicit Reporter(std::string filename = "", std::ostream &out = std::cout)
+            : filename(std::move(filename) + ": "), out(out) {}
+
+        /// The stream that phases print their messages to, such as the progress of the Assembler, so that they end
+        /// up in the same place as the errors and warnings.
+        [[nodiscard]] std::ostream &output() const { return out; }
 
         /// Sets the code that is translated or interpreted, to report any errors showing the specific location
         /// in the code.
         /// @param code The code to report any errors or warnings about.
-        void setCode(const std::string &code);
+        void setCode(std::string code);
+
+        /// Like ::setCode, but without copying the code, which is kept alive by the owner instead.
+        /// @param code The code to report any errors or warnings about.
+        /// @param owner The owner of the code, such as the payload containing it.
+        void setCode(std::string_view code, std::shared_ptr<const void> owner);
 
         /// Prints any errors and warnings to standard out, in this order. Note, that this method doesn't clear the
         /// internal list of errors and warnings.
@@ -69,6 +93,12 @@ namespace goo {
 
         /// Resets the internal state of the reports, clearing any error or warning flags, as well as messages.
         void reset();
+
+    private:
+        /// Looks up the text of a line of the code, without the line break.
+        /// @param line The line, starting at 1.
+        /// @return The text of the line, or nothing if there is no such line.
+        std::optional<std::string_view> codeLine(int line);
     };
 } // goo
 
@@ -4,62 +4,211 @@
 
 #include "Scanner.h"
 
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
 namespace goo {
-    std::shared_ptr<Payload> Scanner::run(const std::shared_ptr<Payload> payload) {
-        // reset the state of the scanner to allow for reuse
-        current = 0;
-        line = 1;
-        column = 0;
-        tokens.clear();
+    namespace {
+        /// Returns the type of token a character stands for.
+        /// @return The type of token, or NONE if the character is a comment or line break.
+        TokenType lexemeType(const char lexeme) {
+            switch (lexeme) {
+                case '+': return INC_BYTE;
+                case '-': return DEC_BYTE;
+                case '>': return INC_PTR;
+                case '<': return DEC_PTR;
+                case '.': return OUT;
+                case ',': return IN;
+                case '[': return IF;
+                case ']': return FI;
+                case '!': return DEBUG;
+                default:
+                    // whitespace and any other character are treated as comments
+                    return NONE;
+            }
+        }
 
-        const auto stringPayload = std::static_pointer_cast<StringPayload>(payload);
-        source = stringPayload->value;
+        /// A function that skips the comments and line breaks between `it` and `end`, updating line and column like
+        /// TokenStream::next would do.
+        /// @return The position of the next lexeme, or `end` if there is none.
+        typedef const char *(*SkipFunction)(const char *it, const char *end, int &line, int &column);
+
+        const char *skipScalar(const char *it, const char *end, int &line, int &column) {
+            for (; it < end; ++it) {
+                if (*it == '\n') {
+                    line++;
+                    column = 0;
+                } else if (lexemeType(*it) != NONE) {
+                    break;
+                } else {
+                    column++;
+                }
+            }
 
-        while (!isAtEnd()) {
-            scanToken();
+            return it;
         }
 
-        addToken(EOF_);
-        return std::make_shared<TokenPayload>(TokenPayload{.tokens = tokens});
+        /// Updates line and column after skipping the first bytes of a block, whose line breaks are marked by the
+        /// bits of `newlines`.
+        void advance(const int skipped, const std::uint64_t newlines, int &line, int &column) {
+            if (newlines == 0) {
+                column += skipped;
+                return;
+            }
+
+            line += std::popcount(newlines);
+
+            // The column restarts after the last line break.
+            const int lastNewline = 63 - std::countl_zero(newlines);
+            column = skipped - lastNewline - 1;
+        }
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+        /// Marks each byte of the block that is a lexeme.
+        __attribute__((target("avx2"))) std::uint32_t lexemeMask(const __m256i block) {
+            __m256i matches = _mm256_setzero_si256();
+
+            for (const char lexeme: {'+', '-', '>', '<', '.', ',', '[', ']', '!'}) {
+                matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(lexeme)));
+            }
+
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(matches));
+        }
+
+        __attribute__((target("avx2"))) std::uint32_t newlineMask(const __m256i block) {
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))));
+        }
+
+        __attribute__((target("avx2")))
+        const char *skipAvx2(const char *it, const char *end, int &line, int &column) {
+            while (end - it >= 64) {
+                const auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(it));
+                const auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(it + 32));
+
+                const auto lexemes = lexemeMask(low) | static_cast<std::uint64_t>(lexemeMask(high)) << 32;
+                const auto newlines = newlineMask(low) | static_cast<std::uint64_t>(newlineMask(high)) << 32;
+
+                if (lexemes != 0) {
+                    const int skipped = std::countr_zero(lexemes);
+                    advance(skipped, newlines & ((std::uint64_t{1} << skipped) - 1), line, column);
+                    return it + skipped;
+                }
+
+                advance(64, newlines, line, column);
+                it += 64;
+            }
+
+            return skipScalar(it, end, line, column);
+        }
+
+        __attribute__((target("sse4.2")))
+        const char *skipSse42(const char *it, const char *end, int &line, int &column) {
+            const auto lexemeSet = _mm_setr_epi8('+', '-', '>', '<', '.', ',', '[', ']', '!', 0, 0, 0, 0, 0, 0, 0);
+            constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+
+            while (end - it >= 16) {
+                const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+
+                // The length of the set excludes the zeros, as they would otherwise match any zero in the source.
+                const auto lexemes = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_cmpestrm(lexemeSet, 9, block, 16,
+                    mode)));
+                const auto newlines = static_cast<std::uint32_t>(_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+
+                if (lexemes != 0) {
+                    const int skipped = std::countr_zero(lexemes);
+                    advance(skipped, newlines & ((std::uint32_t{1} << skipped) - 1), line, column);
+                    return it + skipped;
+                }
+
+                advance(16, newlines, line, column);
+                it += 16;
+            }
+
+            return skipScalar(it, end, line, column);
+        }
+#endif
+
+        /// The way comments are skipped, which is chosen once, based on the features of the CPU.
+        struct SkipImplementation {
+            std::string_view name;
+            SkipFunction skip;
+        };
+
+        const SkipImplementation &skipImplementation() {
+            static const SkipImplementation implementation = []() -> SkipImplementation {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+                if (__builtin_cpu_supports("avx2")) {
+                    return {"avx2", skipAvx2};
+                }
+
+                if (__builtin_cpu_supports("sse4.2")) {
+                    return {"sse4.2", skipSse42};
+                }
+#endif
+                return {"scalar", skipScalar};
+            }();
+
+            return implementation;
+        }
     }
 
-    bool Scanner::isAtEnd() const {
-        return current >= source.size();
+    std::shared_ptr<Payload> Scanner::run(const std::shared_ptr<Payload> payload) {
+        const auto stringPayload = std::static_pointer_cast<StringPayload>(payload);
+        TokenStream stream(stringPayload->value);
+
+        std::vector<std::shared_ptr<Token>> tokens;
+        TokenRun token{};
+
+        do {
+            token = stream.next();
+            tokens.emplace_back(std::make_shared<Token>(token.type, token.line, token.column));
+        } while (token.type != EOF_);
+
+        return std::make_shared<TokenPayload>(TokenPayload{.tokens = tokens});
     }
 
-    void Scanner::scanToken() {
+    TokenRun TokenStream::next() {
+        skipComments();
+
+        if (current >= source.size()) {
+            return TokenRun{.type = EOF_, .count = 1, .line = line, .column = column};
+        }
+
+        const char lexeme = source[current++];
         column++;
 
-        switch (source[current++]) {
-            case '+': addToken(INC_BYTE);
-                break;
-            case '-': addToken(DEC_BYTE);
-                break;
-            case '>': addToken(INC_PTR);
-                break;
-            case '<': addToken(DEC_PTR);
-                break;
-            case '.': addToken(OUT);
-                break;
-            case ',': addToken(IN);
-                break;
-            case '[': addToken(IF);
-                break;
-            case ']': addToken(FI);
-                break;
-            case '!': addToken(DEBUG);
-                break;
-            case '\n':
-                line++;
-                column = 0;
-                break;
-            default:
-                // whitespace and any other character are treated as comments
-                break;
+        const auto type = lexemeType(lexeme);
+        TokenRun token{.type = type, .count = 1, .line = line, .column = column};
+
+        if (groupRuns && (type == INC_BYTE || type == DEC_BYTE || type == INC_PTR || type == DEC_PTR)) {
+            while (current < source.size() && source[current] == lexeme) {
+                current++;
+                column++;
+                token.count++;
+            }
         }
+
+        return token;
+    }
+
+    std::string_view TokenStream::vectorExtension() {
+        return skipImplementation().name;
     }
 
-    void Scanner::addToken(TokenType type) {
-        tokens.emplace_back(std::make_shared<Token>(type, line, column));
+    void TokenStream::skipComments() {
+        // In dense code, the next lexeme usually follows immediately.
+        if (current >= source.size() || lexemeType(source[current]) != NONE) {
+            return;
+        }
+
+        const auto skip = vectorize ? skipImplementation().skip : skipScalar;
+        const auto begin = source.data();
+
+        current = skip(begin + current, begin + source.size(), line, column) - begin;
     }
 } // goo
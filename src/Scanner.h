@@ -5,7 +5,7 @@
 #ifndef SCANNER_H
 #define SCANNER_H
 
-#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Payload.h"
@@ -13,46 +13,66 @@
 #include "Token.h"
 
 namespace goo {
-    /// This class processes brainfuck source code and extracts tokens for each
-    /// proper brainfuck statement. For debugging purposes, the scanner also tracks
-    /// the current line and column within the line.
+    /// Scans brainfuck source code on demand, one token at a time, without copying the source or allocating any
+    /// tokens. Like the Scanner, the stream tracks the current line and column within the line for debugging purposes.
     ///
-    /// The scanner doesn't execute or interpret any actual code, it merely turns
-    /// each lexeme into a corresponding (dumb) token for further processing.
-    class Scanner final : public Phase {
-        std::string source;
-        std::vector<std::shared_ptr<Token>> tokens;
+    /// Optionally, successive +, -, > and < characters of the same kind are returned as one run. Only directly
+    /// adjacent characters are grouped, therefor comments or line breaks in between start a new run.
+    ///
+    /// As most characters of real-world sources are comments, they are skipped in blocks of 64 (AVX2) or 16 (SSE4.2)
+    /// bytes, if the CPU supports it, counting the line breaks within each block, otherwise byte by byte.
+    class TokenStream {
+        const std::string_view source;
+        const bool groupRuns;
+        const bool vectorize;
 
-        int current = 0;
+        std::size_t current = 0;
 
-        // track line and column to add this as debug info in case of compiler errors
         int line = 1;
         int column = 0;
 
+    public:
+        /// Creates a new stream of the source, which must outlive the stream.
+        /// @param source The brainfuck source code to scan.
+        /// @param groupRuns If true, successive byte and pointer operations of the same kind are grouped into one run.
+        /// @param vectorize If false, comments are always skipped byte by byte, e.g. to compare both approaches.
+        explicit TokenStream(const std::string_view source, const bool groupRuns = false,
+                             const bool vectorize = true) : source(source), groupRuns(groupRuns),
+                                                            vectorize(vectorize) {
+        }
+
+        /// Scans the source up to the next valid lexeme and returns it as token, skipping any comments.
+        /// @return The next token, or a token of type EOF_ once the source has been processed completely.
+        TokenRun next();
+
+        /// Returns the instruction set that is used to skip comments, either "avx2", "sse4.2" or "scalar".
+        static std::string_view vectorExtension();
+
+    private:
+        /// Skips any comments and line breaks, up to the next valid lexeme or the end of the source.
+        void skipComments();
+    };
+
+    /// This class processes brainfuck source code and extracts tokens for each
+    /// proper brainfuck statement. For debugging purposes, the scanner also tracks
+    /// the current line and column within the line.
+    ///
+    /// The scanner doesn't execute or interpret any actual code, it merely turns
+    /// each lexeme into a corresponding (dumb) token for further processing. To parse
+    /// the source without materializing any tokens, see StreamingParser.
+    class Scanner final : public Phase {
     public:
         explicit Scanner(Reporter &reporter) : Phase(reporter) {
         }
 
+        [[nodiscard]] std::string name() const override { return "scanner"; }
+
+        [[nodiscard]] PayloadType outputType() const override { return TOKEN; }
+
         /// Scans the source and extracts the valid lexemes, turning them to tokens. This function
         /// doesn't check for syntax errors, instead it blindly turns the code into tokens.
         /// @return A list of tokens representing the valid brainfuck statements in the source provided.
         std::shared_ptr<Payload> run(std::shared_ptr<Payload> payload) override;
-
-    private:
-        /// Compares the value in `current` with the length of source to verify whether the end of
-        /// source has been reached or not.
-        /// @return True if the source has been processed completely, otherwise false.
-        [[nodiscard]] bool isAtEnd() const;
-
-        /// Scans the next character of source and matches it against a list of valid brainfuck statements. If
-        /// a character is not a valid brainfuck statement, it is ignored. Otherwise, ::addToken is called with
-        /// the proper type of the token.
-        void scanToken();
-
-        /// Adds a new token to the list of already processed tokens, based on the token type.
-        /// The current line and column are added to the token for debugging purposes.
-        /// @param type The type of the token to add.
-        void addToken(TokenType type);
     };
 } // goo
 
@@ -0,0 +1,109 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "Sha256.h"
+
+#include <bit>
+#include <format>
+
+namespace goo {
+    /// The first 32 bits of the fractional parts of the cube roots of the first 64 primes, as defined by FIPS 180-4.
+    constexpr std::uint32_t ROUND_CONSTANTS[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    Sha256::Sha256() : state{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    } {
+    }
+
+    void Sha256::update(const std::string_view bytes) {
+        length += bytes.size();
+
+        for (const char byte: bytes) {
+            block[blockSize++] = static_cast<unsigned char>(byte);
+
+            if (blockSize == block.size()) {
+                compress(block.data());
+                blockSize = 0;
+            }
+        }
+    }
+
+    std::string Sha256::hexDigest() {
+        const std::uint64_t bitLength = length * 8;
+
+        // The padding is a single 1 bit, followed by 0 bits up to the last 8 bytes of a block, which hold the length.
+        update(std::string_view("\x80", 1));
+
+        while (blockSize != block.size() - 8) {
+            update(std::string_view("\0", 1));
+        }
+
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            const char byte = static_cast<char>(bitLength >> shift);
+            update(std::string_view(&byte, 1));
+        }
+
+        std::string digest;
+        for (const auto word: state) {
+            digest += std::format("{:08x}", word);
+        }
+
+        return digest;
+    }
+
+    void Sha256::compress(const unsigned char *chunk) {
+        std::uint32_t words[64];
+
+        for (int idx = 0; idx < 16; idx++) {
+            words[idx] = static_cast<std::uint32_t>(chunk[idx * 4]) << 24 |
+                         static_cast<std::uint32_t>(chunk[idx * 4 + 1]) << 16 |
+                         static_cast<std::uint32_t>(chunk[idx * 4 + 2]) << 8 |
+                         static_cast<std::uint32_t>(chunk[idx * 4 + 3]);
+        }
+
+        for (int idx = 16; idx < 64; idx++) {
+            const auto s0 = std::rotr(words[idx - 15], 7) ^ std::rotr(words[idx - 15], 18) ^ words[idx - 15] >> 3;
+            const auto s1 = std::rotr(words[idx - 2], 17) ^ std::rotr(words[idx - 2], 19) ^ words[idx - 2] >> 10;
+            words[idx] = words[idx - 16] + s0 + words[idx - 7] + s1;
+        }
+
+        auto [a, b, c, d, e, f, g, h] = state;
+
+        for (int idx = 0; idx < 64; idx++) {
+            const auto s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+            const auto choice = (e & f) ^ (~e & g);
+            const auto temp1 = h + s1 + choice + ROUND_CONSTANTS[idx] + words[idx];
+            const auto s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+            const auto majority = (a & b) ^ (a & c) ^ (b & c);
+            const auto temp2 = s0 + majority;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+} // goo
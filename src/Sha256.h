@@ -0,0 +1,42 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace goo {
+    /// Computes the SHA-256 digest of a sequence of bytes, which may be passed in several parts, e.g. to hash large
+    /// files without copying them into a single string first.
+    class Sha256 {
+        std::array<std::uint32_t, 8> state;
+
+        /// The bytes that don't fill a block of 64 bytes yet.
+        std::array<unsigned char, 64> block{};
+        std::size_t blockSize = 0;
+
+        /// The number of bytes hashed so far.
+        std::uint64_t length = 0;
+
+    public:
+        Sha256();
+
+        /// Appends the bytes to the hashed sequence.
+        void update(std::string_view bytes);
+
+        /// Finishes the digest. Afterward, the instance must not be updated anymore.
+        /// @return The digest as 64 lowercase hexadecimal digits.
+        [[nodiscard]] std::string hexDigest();
+
+    private:
+        /// Processes a complete block of 64 bytes.
+        void compress(const unsigned char *chunk);
+    };
+} // goo
+
+#endif //SHA256_H
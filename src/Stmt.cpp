@@ -24,4 +24,50 @@ namespace goo {
 
         return stmtPattern == pattern;
     }
+
+    void StmtWalker::visitConditional(Conditional *stmt) {
+        Stmt *const stmts[] = {stmt};
+        walk(stmts);
+    }
+
+    void StmtWalker::walk(const StmtSpan stmts) {
+        /// A list of statements that is being walked, along with the conditional it is the body of, if any.
+        struct Frame {
+            Conditional *conditional;
+            StmtSpan stmts;
+            std::size_t next;
+        };
+
+        std::vector<Frame> frames = {Frame{.conditional = nullptr, .stmts = stmts, .next = 0}};
+
+        while (!frames.empty() && !isDone()) {
+            // The frame must not be used once another one is pushed, as it may move.
+            auto &frame = frames.back();
+
+            if (frame.next == frame.stmts.size()) {
+                if (frame.conditional != nullptr && leaveConditional(frame.conditional)) {
+                    frame.next = 0;
+                } else {
+                    frames.pop_back();
+                }
+
+                continue;
+            }
+
+            const auto idx = frame.next++;
+            const auto stmt = frame.stmts[idx];
+
+            if (stmt == nullptr) {
+                continue;
+            }
+
+            beforeStmt(frame.stmts, idx);
+
+            if (stmt->type != IF) {
+                stmt->accept(this);
+            } else if (const auto conditional = static_cast<Conditional *>(stmt); enterConditional(conditional)) {
+                frames.push_back(Frame{.conditional = conditional, .stmts = conditional->stmts, .next = 0});
+            }
+        }
+    }
 } // goo
\ No newline at end of file
@@ -4,8 +4,9 @@
 
 #ifndef STMT_H
 #define STMT_H
-#include <memory>
+#include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Token.h"
@@ -20,11 +21,19 @@ namespace goo {
     class Input;
     class Debug;
     class Reset;
-    class Transfer;
-    class Multiply;
+    class LinearLoop;
+    class Scan;
+    class ConstOutput;
+    class TapeInit;
 
+    class Stmt;
     class Visitor;
 
+    typedef std::vector<Stmt *> StmtVector;
+
+    /// A list of statements that is owned by someone else, such as the body of a Conditional.
+    typedef std::span<Stmt *const> StmtSpan;
+
     /// A statement is a single command that performs a certain operation. This class
     /// represents an abstract base for any actual brainfuck statements.
     ///
@@ -36,6 +45,9 @@ namespace goo {
     ///
     /// For debugging purposes, each statement tracks its line and column, to make it
     /// easier to pinpoint errors.
+    ///
+    /// Statements are owned by a StmtArena, which constructs and destroys them, therefor they are passed around as
+    /// plain pointers and can't be deleted on their own.
     class Stmt {
     public:
         const int column;
@@ -45,8 +57,6 @@ namespace goo {
         Stmt(const int column, const int line, const TokenType type): column(column), line(line), type(type) {
         }
 
-        virtual ~Stmt() = default;
-
         /// Attempts to match the pattern provided as param. For regular statements, only one token type must be
         /// provided as pattern, otherwise this call fails. For conditionals, the pattern includes all sub-statements.
         ///
@@ -62,6 +72,11 @@ namespace goo {
         [[nodiscard]] std::string debugInfo() const {
             return std::to_string(line) + ":" + std::to_string(column);
         }
+
+    protected:
+        /// Only the StmtArena destroys statements, and only those that own memory of their own, therefor the
+        /// destructor is neither virtual nor public.
+        ~Stmt() = default;
     };
 
     /// A visitor to a statement. The purpose of the visitor is to process a
@@ -90,17 +105,53 @@ namespace goo {
 
         virtual void visitReset(Reset *stmt) = 0;
 
-        virtual void visitTransfer(Transfer *stmt) = 0;
+        virtual void visitLinearLoop(LinearLoop *stmt) = 0;
+
+        virtual void visitScan(Scan *stmt) = 0;
+
+        virtual void visitConstOutput(ConstOutput *stmt) = 0;
+
+        virtual void visitTapeInit(TapeInit *stmt) = 0;
+    };
+
+    /// A visitor that walks nested conditionals with a stack of its own instead of recursion, therefor any depth of
+    /// nesting fits, as long as it fits into memory. Conditionals are visited by ::enterConditional and
+    /// ::leaveConditional, any other statement is visited through Stmt::accept.
+    class StmtWalker : public Visitor {
+    public:
+        /// Walks a conditional that is visited on its own, such as through Stmt::accept.
+        void visitConditional(Conditional *stmt) final;
+
+    protected:
+        /// Visits the statements in order, including the bodies of conditionals. Nullptr-entries are being ignored.
+        void walk(StmtSpan stmts);
 
-        virtual void visitMultiply(Multiply *stmt) = 0;
+        /// Called before the body of a conditional.
+        /// @return True if the body is walked, otherwise the walk continues after the conditional.
+        virtual bool enterConditional(Conditional *stmt) = 0;
+
+        /// Called after the body of a conditional has been walked.
+        /// @return True if the body is walked once more, as loops do.
+        virtual bool leaveConditional(Conditional *stmt) = 0;
+
+        /// Called before the statement at `idx` is visited, with the list of statements it is part of.
+        virtual void beforeStmt(StmtSpan /*stmts*/, std::size_t /*idx*/) {
+        }
+
+        /// Stops the walk once it returns true, for example after an error.
+        [[nodiscard]] virtual bool isDone() const { return false; }
     };
 
+    /// Increments the byte at the tape pointer by count. Like DecrementByte, Output and Input, the statement may address
+    /// a byte relative to the tape pointer (offset != 0), instead of the one at the tape pointer (offset = 0).
     class IncrementByte final : public Stmt {
     public:
         const int count;
+        const int offset;
 
         IncrementByte(const int column, const int line,
-                      const int count = 1): Stmt(column, line, INC_BYTE), count(count) {
+                      const int count = 1, const int offset = 0): Stmt(column, line, INC_BYTE), count(count),
+                                                                  offset(offset) {
         }
 
         void accept(Visitor *visitor) override {
@@ -111,9 +162,11 @@ namespace goo {
     class DecrementByte final : public Stmt {
     public:
         const int count;
+        const int offset;
 
         DecrementByte(const int column, const int line,
-                      const int count = 1): Stmt(column, line, DEC_BYTE), count(count) {
+                      const int count = 1, const int offset = 0): Stmt(column, line, DEC_BYTE), count(count),
+                                                                  offset(offset) {
         }
 
         void accept(Visitor *visitor) override {
@@ -147,12 +200,14 @@ namespace goo {
         }
     };
 
+    /// A loop that runs its body as long as the byte at the tape pointer isn't 0. The body is owned by the StmtArena
+    /// of the conditional, see StmtArena::list.
     class Conditional final : public Stmt {
     public:
-        std::vector<std::shared_ptr<Stmt> > stmts;
+        StmtSpan stmts;
 
-        explicit Conditional(const int column, const int line,
-                             const std::vector<std::shared_ptr<Stmt> > &stmts): Stmt(column, line, IF), stmts(stmts) {
+        explicit Conditional(const int column, const int line, const StmtSpan stmts): Stmt(column, line, IF),
+                                                                                       stmts(stmts) {
         }
 
         /// Matches the pattern against this conditional. Only the complete conditional can be matches, therefor
@@ -168,7 +223,9 @@ namespace goo {
 
     class Output final : public Stmt {
     public:
-        Output(const int column, const int line): Stmt(column, line, OUT) {
+        const int offset;
+
+        Output(const int column, const int line, const int offset = 0): Stmt(column, line, OUT), offset(offset) {
         }
 
         void accept(Visitor *visitor) override {
@@ -178,7 +235,9 @@ namespace goo {
 
     class Input final : public Stmt {
     public:
-        Input(const int column, const int line): Stmt(column, line, IN) {
+        const int offset;
+
+        Input(const int column, const int line, const int offset = 0): Stmt(column, line, IN), offset(offset) {
         }
 
         void accept(Visitor *visitor) override {
@@ -213,36 +272,84 @@ namespace goo {
         }
     };
 
-    /// A statement that transfers a value from one byte of the tape to another. The transfer can be a simple 1:1 one
-    /// ( [>+<-] ) or more complex, such as [>++<-] or [>+<--] etc. The add/subOffset inform processing compiler phases
-    /// about where to write the bytes to and where to read them from.
-    class Transfer final : public Stmt {
+    /// A cell that a LinearLoop adds a multiple of its counter to, relative to the tape pointer.
+    struct LinearTarget {
+        int offset;
+        int factor;
+
+        bool operator==(const LinearTarget &other) const = default;
+    };
+
+    /// An optimized version of a loop that only increases or decreases bytes relative to the tape pointer, without
+    /// moving the tape pointer overall, and that decreases the byte at the tape pointer (the counter) by exactly 1 per
+    /// iteration, such as [->+<] or [->++>+++<<]. The loop therefor runs `counter` times, which is equivalent to adding
+    /// counter * factor to each of its targets and resetting the counter to 0, without any loop.
+    class LinearLoop final : public Stmt {
     public:
-        const int offset;
+        const std::vector<LinearTarget> targets;
 
-        Transfer(const int column, const int line, const int offset): Stmt(column, line, TRANSFER), offset(offset) {
+        LinearLoop(const int column, const int line, const std::vector<LinearTarget> &targets): Stmt(column, line,
+            LINEAR_LOOP), targets(targets) {
         }
 
         void accept(Visitor *visitor) override {
-            visitor->visitTransfer(this);
+            visitor->visitLinearLoop(this);
         }
     };
 
-    /// A statement that matches a pattern of type +[>+<-], i.e. multiplies the outer increment statement ('times')
-    /// with the inner increase statement ('count') and adds it to the tape at offset.
-    class Multiply final : public Stmt {
+    /// An optimized version of a loop that only moves the tape pointer by a constant stride, such as [>], [<] or [>>>>].
+    /// The loop searches for the next byte that is 0, starting at the tape pointer and visiting every stride-th byte
+    /// towards the end (stride > 0) or the beginning (stride < 0) of the tape, which allows for searching many bytes
+    /// at once.
+    class Scan final : public Stmt {
     public:
-        const int offset;
-        const int times;
-        const int count;
+        const int stride;
+
+        Scan(const int column, const int line, const int stride): Stmt(column, line, SCAN), stride(stride) {
+        }
+
+        void accept(Visitor *visitor) override {
+            visitor->visitScan(this);
+        }
+    };
+
+    /// Writes a constant sequence of bytes, which the PartialEvaluator computed at compile time. It is only used at the
+    /// top level of a program, never within a conditional.
+    class ConstOutput final : public Stmt {
+    public:
+        const std::string value;
+
+        ConstOutput(const int column, const int line, std::string value): Stmt(column, line, CONST_OUTPUT),
+                                                                          value(std::move(value)) {
+        }
+
+        void accept(Visitor *visitor) override {
+            visitor->visitConstOutput(this);
+        }
+    };
+
+    /// A cell of the tape at an absolute position, which may lie within the padding of the tape.
+    struct TapeCell {
+        int position;
+        char value;
+
+        bool operator==(const TapeCell &other) const = default;
+    };
+
+    /// Restores the state of the tape that the PartialEvaluator computed at compile time: each of the cells is set to
+    /// its value, and the tape pointer is moved to the absolute position tapePtr. As it only lists cells that aren't 0,
+    /// it expects the tape to be empty, which is why it must only be used at the beginning of a program.
+    class TapeInit final : public Stmt {
+    public:
+        const std::vector<TapeCell> cells;
+        const int tapePtr;
 
-        Multiply(const int column, const int line, const int offset, const int count, const int times): Stmt(column,
-            line,
-            MULTIPLY), offset(offset), count(count), times(times) {
+        TapeInit(const int column, const int line, const std::vector<TapeCell> &cells, const int tapePtr): Stmt(column,
+            line, TAPE_INIT), cells(cells), tapePtr(tapePtr) {
         }
 
         void accept(Visitor *visitor) override {
-            visitor->visitMultiply(this);
+            visitor->visitTapeInit(this);
         }
     };
 } // goo
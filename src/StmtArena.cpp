@@ -0,0 +1,52 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "StmtArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace goo {
+    StmtArena::~StmtArena() {
+        for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+            it->second(it->first);
+        }
+    }
+
+    StmtSpan StmtArena::list(const StmtSpan stmts) {
+        if (stmts.empty()) {
+            return {};
+        }
+
+        const auto memory = static_cast<Stmt **>(allocate(stmts.size() * sizeof(Stmt *), alignof(Stmt *)));
+        std::ranges::copy(stmts, memory);
+
+        return {memory, stmts.size()};
+    }
+
+    void *StmtArena::allocate(const std::size_t size, const std::size_t alignment) {
+        allocatedBytes += size;
+
+        // Allocations that would take up a large part of a block get a block of their own, which keeps the current
+        // block, as it most likely still has room for further statements.
+        if (size > BLOCK_SIZE / 4) {
+            return blocks.emplace_back(new std::byte[size]).get();
+        }
+
+        auto padding = (alignment - reinterpret_cast<std::uintptr_t>(next) % alignment) % alignment;
+
+        if (next == nullptr || padding + size > remaining) {
+            // A new block is aligned suitably for any statement.
+            next = blocks.emplace_back(new std::byte[BLOCK_SIZE]).get();
+            remaining = BLOCK_SIZE;
+            padding = 0;
+        }
+
+        void *memory = next + padding;
+        next += padding + size;
+        remaining -= padding + size;
+
+        return memory;
+    }
+} // goo
@@ -0,0 +1,76 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef STMTARENA_H
+#define STMTARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Stmt.h"
+
+namespace goo {
+    /// A bump allocator that owns all statements of a program. Instead of allocating each statement on its own, the
+    /// statements are constructed one after another within large blocks, as are the lists of sub-statements of
+    /// conditionals. Statements therefor refer to each other by plain pointers, which remain valid for as long as the
+    /// arena exists, and are only destroyed along with the arena.
+    ///
+    /// Statements that are replaced, e.g. by an OptimizationPass, aren't released individually, but remain part of
+    /// the arena until it is destroyed.
+    class StmtArena {
+        /// The size of a regular block. Larger allocations, such as a long list of sub-statements, get a block of
+        /// their own.
+        static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+        std::vector<std::unique_ptr<std::byte[]> > blocks;
+        std::byte *next = nullptr;
+        std::size_t remaining = 0;
+
+        /// The statements that own memory of their own, such as the targets of a LinearLoop, which must be destroyed
+        /// along with the arena. Most statements don't, therefor they are never destroyed explicitly.
+        std::vector<std::pair<Stmt *, void (*)(Stmt *)> > destructors;
+
+        std::size_t stmtCount = 0;
+        std::size_t allocatedBytes = 0;
+
+    public:
+        StmtArena() = default;
+
+        StmtArena(const StmtArena &) = delete;
+
+        StmtArena &operator=(const StmtArena &) = delete;
+
+        ~StmtArena();
+
+        /// Constructs a statement of type T within the arena.
+        template<typename T, typename... Args>
+        T *make(Args &&... args) {
+            T *stmt = new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                destructors.emplace_back(stmt, [](Stmt *s) { static_cast<T *>(s)->~T(); });
+            }
+
+            stmtCount++;
+            return stmt;
+        }
+
+        /// Copies a list of statements into the arena, for example to become the body of a Conditional.
+        StmtSpan list(StmtSpan stmts);
+
+        /// Returns the number of statements that have been constructed within the arena.
+        [[nodiscard]] std::size_t size() const { return stmtCount; }
+
+        /// Returns the number of bytes that have been allocated for statements and lists of statements.
+        [[nodiscard]] std::size_t bytes() const { return allocatedBytes; }
+
+    private:
+        void *allocate(std::size_t size, std::size_t alignment);
+    };
+} // goo
+
+#endif //STMTARENA_H
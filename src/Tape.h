@@ -0,0 +1,93 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef TAPE_H
+#define TAPE_H
+
+#include <cstdint>
+#include <cstring>
+
+/// The number of cells of the tape in the compatibility mode.
+#define TAPE_SIZE 30000
+
+/// The number of cells of the tape with wrap8 semantics. Being a power of two, the tape pointer wraps around by
+/// masking it with WRAP8_TAPE_SIZE - 1, instead of comparing it against the bounds of the tape.
+#define WRAP8_TAPE_SIZE 32768
+
+/// The number of additional cells before and after the tape. Statements may address cells relative to the tape pointer
+/// (see OffsetPass) by at most this many cells, therefor a single wrap-around reaches the cell, see cellPosition().
+#define TAPE_PADDING 256
+
+namespace goo {
+    /// Defines how cells and the tape pointer behave on over- and underflows. All interpreters and the CodeGen support
+    /// both semantics.
+    enum CellSemantics : std::uint8_t {
+        /// The original semantics of goo: cells hold values from 0 to 127 and every arithmetic operation is followed by
+        /// a guard that restores an over- or underflowing value to this range. The tape holds 30,000 cells and moving
+        /// the tape pointer beyond either end wraps around to the other end, which the interpreters report as warning.
+        CELLS_COMPAT,
+
+        /// Cells are plain bytes from 0 to 255 with native, modular 8-bit arithmetic. The tape holds 32,768 cells and
+        /// the tape pointer silently wraps around. This requires no compares or branches in the generated code.
+        CELLS_WRAP8
+    };
+
+    /// Returns the number of cells of the tape for the given semantics.
+    inline int tapeSize(const CellSemantics cellSemantics) {
+        return cellSemantics == CELLS_WRAP8 ? WRAP8_TAPE_SIZE : TAPE_SIZE;
+    }
+
+    /// Returns the position of the cell at `offset` relative to the tape pointer. Like the tape pointer itself, the
+    /// position wraps around either end of the tape, so that a cell beyond the end is the same cell the tape pointer
+    /// would reach by moving there.
+    inline int cellPosition(const int tapePtr, const int offset, const CellSemantics cellSemantics) {
+        const int position = tapePtr + offset;
+
+        if (cellSemantics == CELLS_WRAP8) {
+            return position & (WRAP8_TAPE_SIZE - 1);
+        }
+
+        if (position < 0) {
+            return position + TAPE_SIZE;
+        }
+
+        return position >= TAPE_SIZE ? position - TAPE_SIZE : position;
+    }
+
+    /// Allocates a tape for the given semantics, with every cell set to 0, including the padding on either side.
+    /// @return A pointer to the first cell of the tape, which must be released with freeTape().
+    inline char *allocateTape(const CellSemantics cellSemantics) {
+        return new char[tapeSize(cellSemantics) + 2 * TAPE_PADDING]() + TAPE_PADDING;
+    }
+
+    /// Releases a tape allocated by allocateTape().
+    inline void freeTape(const char *tape) {
+        delete[] (tape - TAPE_PADDING);
+    }
+
+    /// Searches the tape for the first byte that is 0, starting at `tapePtr` and moving by `stride` cells per step, as
+    /// [>] or [<<] do. The search stops at either end of the tape, as moving beyond it depends on the CellSemantics.
+    /// Strides of 1 and -1 use memchr and memrchr, which compare many bytes at once.
+    /// @return The position of the byte that is 0, or the last position before the tape pointer would leave the tape,
+    /// in which case the byte at it is not 0.
+    inline int scanTape(const char *tape, const int size, int tapePtr, const int stride) {
+        if (stride == 1) {
+            const auto *cell = static_cast<const char *>(memchr(tape + tapePtr, 0, size - tapePtr));
+            return cell != nullptr ? static_cast<int>(cell - tape) : size - 1;
+        }
+
+        if (stride == -1) {
+            const auto *cell = static_cast<const char *>(memrchr(tape, 0, tapePtr + 1));
+            return cell != nullptr ? static_cast<int>(cell - tape) : 0;
+        }
+
+        while (tape[tapePtr] != 0 && tapePtr + stride >= 0 && tapePtr + stride < size) {
+            tapePtr += stride;
+        }
+
+        return tapePtr;
+    }
+} // goo
+
+#endif //TAPE_H
@@ -20,8 +20,10 @@ namespace goo {
         IF = 64,
         FI = 128,
         RESET = 256,
-        TRANSFER = 512,
-        MULTIPLY = 1024,
+        LINEAR_LOOP = 512,
+        SCAN = 1024,
+        CONST_OUTPUT = 2048,
+        TAPE_INIT = 4096,
         DEBUG,
         EOF_,
         NONE
@@ -48,6 +50,15 @@ namespace goo {
         /// @return A string of this format: "<lexeme> <line>:<column>"
         [[nodiscard]] std::string toString() const;
     };
+
+    /// A compact, non-allocated token, as produced by the TokenStream. A run stands for `count` successive tokens of
+    /// the same type, the first of which is located at line and column.
+    struct TokenRun {
+        TokenType type;
+        int count;
+        int line;
+        int column;
+    };
 } // goo
 
 #endif //TOKEN_H
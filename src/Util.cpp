@@ -5,7 +5,7 @@
 #include "Util.h"
 
 #include <algorithm>
-#include <regex>
+#include <sstream>
 
 namespace goo {
 
@@ -16,7 +16,15 @@ namespace goo {
     }
 
     std::string stripWhitespace(const std::string& s) {
-        return std::regex_replace(s, std::regex("(^[ \t]+)|([ \t]+$)"),"");
+        // This is called for every operand of every assembler instruction, therefor we avoid std::regex here, as
+        // constructing it dominated the time of the code generation.
+        const auto start = s.find_first_not_of(" \t");
+        if (start == std::string::npos) {
+            return "";
+        }
+
+        const auto end = s.find_last_not_of(" \t");
+        return s.substr(start, end - start + 1);
     }
 
     std::vector<std::string> splitIntoLines(const std::string &s) {
@@ -28,7 +36,7 @@ namespace goo {
         std::stringstream ss(s);
         std::string part;
 
-        while (std::getline(ss, part, ' ')) {
+        while (std::getline(ss, part, delimiter)) {
             parts.push_back(part);
         }
 
@@ -0,0 +1,379 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include "X86Encoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace goo {
+    namespace {
+        bool isExtended(const X86Register reg) {
+            return reg != NO_REGISTER && (reg & 8) != 0;
+        }
+
+        /// spl, bpl, sil and dil can only be addressed with a REX prefix, otherwise the encoding refers to ah-bh.
+        bool needsByteRex(const X86Register reg) {
+            return reg >= RSP && reg <= RDI;
+        }
+
+        bool fitsInt8(const std::int64_t value) {
+            return value >= INT8_MIN && value <= INT8_MAX;
+        }
+
+        bool fitsInt32(const std::int64_t value) {
+            return value >= INT32_MIN && value <= INT32_MAX;
+        }
+    }
+
+    void X86Encoder::reset() {
+        code.clear();
+        labels.clear();
+        fixups.clear();
+        displacementPosition = 0;
+    }
+
+    bool X86Encoder::finish() {
+        for (const auto &[position, label]: fixups) {
+            if (labels[label] < 0) {
+                return false;
+            }
+
+            const auto rel = static_cast<std::int32_t>(labels[label] - static_cast<std::int64_t>(position + 4));
+            memcpy(&code[position], &rel, sizeof(rel));
+        }
+
+        fixups.clear();
+        return true;
+    }
+
+    int X86Encoder::newLabel() {
+        labels.push_back(-1);
+        return static_cast<int>(labels.size() - 1);
+    }
+
+    void X86Encoder::bind(const int label) {
+        labels[label] = static_cast<std::int64_t>(code.size());
+    }
+
+    void X86Encoder::alu(const AluOp op, const int size, const X86Register dest, const std::int32_t imm) {
+        if (size == 1) {
+            rex(false, NO_REGISTER, NO_REGISTER, dest, needsByteRex(dest));
+            emit8(0x80);
+            modrm(op, dest);
+            emit8(static_cast<std::uint8_t>(imm));
+        } else {
+            rex(size == 8, NO_REGISTER, NO_REGISTER, dest, false);
+            emit8(fitsInt8(imm) ? 0x83 : 0x81);
+            modrm(op, dest);
+            fitsInt8(imm) ? emit8(static_cast<std::uint8_t>(imm)) : emit32(imm);
+        }
+    }
+
+    void X86Encoder::alu(const AluOp op, const int size, const Memory &dest, const std::int32_t imm) {
+        rex(size, NO_REGISTER, dest);
+
+        if (size == 1) {
+            emit8(0x80);
+            modrm(op, dest);
+            emit8(static_cast<std::uint8_t>(imm));
+        } else {
+            emit8(fitsInt8(imm) ? 0x83 : 0x81);
+            modrm(op, dest);
+            fitsInt8(imm) ? emit8(static_cast<std::uint8_t>(imm)) : emit32(imm);
+        }
+    }
+
+    void X86Encoder::alu(const AluOp op, const int size, const X86Register dest, const X86Register src) {
+        rex(size == 8, src, NO_REGISTER, dest, size == 1 && (needsByteRex(src) || needsByteRex(dest)));
+        emit8(op * 8 + (size == 1 ? 0x00 : 0x01));
+        modrm(src, dest);
+    }
+
+    void X86Encoder::alu(const AluOp op, const int size, const Memory &dest, const X86Register src) {
+        rex(size, src, dest);
+        emit8(op * 8 + (size == 1 ? 0x00 : 0x01));
+        modrm(src, dest);
+    }
+
+    void X86Encoder::alu(const AluOp op, const int size, const X86Register dest, const Memory &src) {
+        rex(size, dest, src);
+        emit8(op * 8 + (size == 1 ? 0x02 : 0x03));
+        modrm(dest, src);
+    }
+
+    void X86Encoder::mov(const int size, const X86Register dest, const std::int64_t imm) {
+        if (size == 1) {
+            rex(false, NO_REGISTER, NO_REGISTER, dest, needsByteRex(dest));
+            emit8(0xB0 + (dest & 7));
+            emit8(static_cast<std::uint8_t>(imm));
+        } else if (size == 4) {
+            rex(false, NO_REGISTER, NO_REGISTER, dest, false);
+            emit8(0xB8 + (dest & 7));
+            emit32(static_cast<std::int32_t>(imm));
+        } else if (fitsInt32(imm)) {
+            rex(true, NO_REGISTER, NO_REGISTER, dest, false);
+            emit8(0xC7);
+            modrm(0, dest);
+            emit32(static_cast<std::int32_t>(imm));
+        } else {
+            rex(true, NO_REGISTER, NO_REGISTER, dest, false);
+            emit8(0xB8 + (dest & 7));
+            emit64(imm);
+        }
+    }
+
+    void X86Encoder::mov(const int size, const Memory &dest, const std::int32_t imm) {
+        rex(size, NO_REGISTER, dest);
+
+        if (size == 1) {
+            emit8(0xC6);
+            modrm(0, dest);
+            emit8(static_cast<std::uint8_t>(imm));
+        } else {
+            emit8(0xC7);
+            modrm(0, dest);
+            emit32(imm);
+        }
+    }
+
+    void X86Encoder::mov(const int size, const X86Register dest, const X86Register src) {
+        rex(size == 8, src, NO_REGISTER, dest, size == 1 && (needsByteRex(src) || needsByteRex(dest)));
+        emit8(size == 1 ? 0x88 : 0x89);
+        modrm(src, dest);
+    }
+
+    void X86Encoder::mov(const int size, const Memory &dest, const X86Register src) {
+        rex(size, src, dest);
+        emit8(size == 1 ? 0x88 : 0x89);
+        modrm(src, dest);
+    }
+
+    void X86Encoder::mov(const int size, const X86Register dest, const Memory &src) {
+        rex(size, dest, src);
+        emit8(size == 1 ? 0x8A : 0x8B);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::movzxByte(const X86Register dest, const Memory &src) {
+        rex(4, dest, src);
+        emit8(0x0F);
+        emit8(0xB6);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::movsxByte(const X86Register dest, const Memory &src) {
+        rex(4, dest, src);
+        emit8(0x0F);
+        emit8(0xBE);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::lea(const X86Register dest, const Memory &src) {
+        rex(8, dest, src);
+        emit8(0x8D);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::imul(const int size, const X86Register dest, const X86Register src, const std::int32_t imm) {
+        rex(size == 8, dest, NO_REGISTER, src, false);
+        emit8(fitsInt8(imm) ? 0x6B : 0x69);
+        modrm(dest, src);
+        fitsInt8(imm) ? emit8(static_cast<std::uint8_t>(imm)) : emit32(imm);
+    }
+
+    void X86Encoder::mul(const int size, const X86Register src) {
+        rex(size == 8, NO_REGISTER, NO_REGISTER, src, size == 1 && needsByteRex(src));
+        emit8(size == 1 ? 0xF6 : 0xF7);
+        modrm(4, src);
+    }
+
+    void X86Encoder::test(const int size, const X86Register dest, const X86Register src) {
+        rex(size == 8, src, NO_REGISTER, dest, size == 1 && (needsByteRex(src) || needsByteRex(dest)));
+        emit8(size == 1 ? 0x84 : 0x85);
+        modrm(src, dest);
+    }
+
+    void X86Encoder::bitScan(const bool reverse, const int size, const X86Register dest, const X86Register src) {
+        rex(size == 8, dest, NO_REGISTER, src, false);
+        emit8(0x0F);
+        emit8(reverse ? 0xBD : 0xBC);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::sse(const SseOp op, const X86Register dest, const X86Register src) {
+        // The mandatory prefix must precede the REX prefix.
+        emit8(op == SSE_MOVDQU ? 0xF3 : 0x66);
+        rex(false, dest, NO_REGISTER, src, false);
+        emit8(0x0F);
+        emit8(op);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::sse(const SseOp op, const X86Register dest, const Memory &src) {
+        emit8(op == SSE_MOVDQU ? 0xF3 : 0x66);
+        rex(false, dest, src.index, src.base, false);
+        emit8(0x0F);
+        emit8(op);
+        modrm(dest, src);
+    }
+
+    void X86Encoder::push(const X86Register reg) {
+        rex(false, NO_REGISTER, NO_REGISTER, reg, false);
+        emit8(0x50 + (reg & 7));
+    }
+
+    void X86Encoder::pop(const X86Register reg) {
+        rex(false, NO_REGISTER, NO_REGISTER, reg, false);
+        emit8(0x58 + (reg & 7));
+    }
+
+    void X86Encoder::call(const X86Register target) {
+        rex(false, NO_REGISTER, NO_REGISTER, target, false);
+        emit8(0xFF);
+        modrm(2, target);
+    }
+
+    void X86Encoder::ret() {
+        emit8(0xC3);
+    }
+
+    void X86Encoder::syscall() {
+        emit8(0x0F);
+        emit8(0x05);
+    }
+
+    void X86Encoder::jmp(const int label) {
+        emit8(0xE9);
+        jump(label);
+    }
+
+    void X86Encoder::jcc(const Condition condition, const int label) {
+        emit8(0x0F);
+        emit8(0x80 + condition);
+        jump(label);
+    }
+
+    void X86Encoder::align(const std::int64_t alignment) {
+        // The recommended NOPs of 1 to 9 bytes, see the description of NOP in the Intel SDM.
+        static const std::vector<std::vector<std::uint8_t>> nops = {
+            {0x90},
+            {0x66, 0x90},
+            {0x0F, 0x1F, 0x00},
+            {0x0F, 0x1F, 0x40, 0x00},
+            {0x0F, 0x1F, 0x44, 0x00, 0x00},
+            {0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00},
+            {0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00},
+            {0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+            {0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00}
+        };
+
+        auto padding = static_cast<std::size_t>((alignment - static_cast<std::int64_t>(code.size()) % alignment) %
+                                                alignment);
+
+        while (padding > 0) {
+            const auto &nop = nops[std::min(padding, nops.size()) - 1];
+            raw(nop);
+            padding -= nop.size();
+        }
+    }
+
+    void X86Encoder::raw(const std::vector<std::uint8_t> &bytes) {
+        code.insert(code.end(), bytes.begin(), bytes.end());
+    }
+
+    void X86Encoder::emit8(const std::uint8_t value) {
+        code.push_back(value);
+    }
+
+    void X86Encoder::emit32(const std::int32_t value) {
+        const auto position = code.size();
+        code.resize(position + sizeof(value));
+        memcpy(&code[position], &value, sizeof(value));
+    }
+
+    void X86Encoder::emit64(const std::int64_t value) {
+        const auto position = code.size();
+        code.resize(position + sizeof(value));
+        memcpy(&code[position], &value, sizeof(value));
+    }
+
+    void X86Encoder::rex(const bool wide, const X86Register reg, const X86Register index, const X86Register base,
+                         const bool byteRegs) {
+        std::uint8_t prefix = 0x40;
+
+        if (wide) prefix |= 0x08;
+        if (isExtended(reg)) prefix |= 0x04;
+        if (isExtended(index)) prefix |= 0x02;
+        if (isExtended(base)) prefix |= 0x01;
+
+        if (prefix != 0x40 || byteRegs) {
+            emit8(prefix);
+        }
+    }
+
+    void X86Encoder::rex(const int size, const X86Register reg, const Memory &mem) {
+        rex(size == 8, reg, mem.index, mem.base, size == 1 && needsByteRex(reg));
+    }
+
+    void X86Encoder::modrm(const std::uint8_t reg, const X86Register rm) {
+        emit8(0xC0 | (reg & 7) << 3 | (rm & 7));
+    }
+
+    void X86Encoder::modrm(const std::uint8_t reg, const Memory &mem) {
+        const std::uint8_t regBits = (reg & 7) << 3;
+
+        if (mem.ripRelative) {
+            emit8(regBits | 0x05);
+            displacementPosition = code.size();
+            emit32(mem.disp);
+            return;
+        }
+
+        if (mem.base == NO_REGISTER) {
+            // Without a base register we must use a SIB byte with base = 101, which implies a 32-bit displacement
+            // and, for an index of 100, no index at all.
+            emit8(regBits | 0x04);
+            emit8((mem.index == NO_REGISTER ? 0x04 : mem.index & 7) << 3 | 0x05);
+            displacementPosition = code.size();
+            emit32(mem.disp);
+            return;
+        }
+
+        // rbp and r13 as base can't be encoded without a displacement, therefor we use an 8-bit displacement of 0.
+        std::uint8_t mod = 0x80;
+        if (mem.disp == 0 && (mem.base & 7) != RBP) {
+            mod = 0x00;
+        } else if (fitsInt8(mem.disp)) {
+            mod = 0x40;
+        }
+
+        if (mem.index != NO_REGISTER) {
+            emit8(mod | regBits | 0x04);
+            emit8((mem.index & 7) << 3 | (mem.base & 7));
+        } else if ((mem.base & 7) == RSP) {
+            // rsp and r12 as base require a SIB byte
+            emit8(mod | regBits | 0x04);
+            emit8(0x24);
+        } else {
+            emit8(mod | regBits | (mem.base & 7));
+        }
+
+        if (mod == 0x40) {
+            emit8(static_cast<std::uint8_t>(mem.disp));
+        } else if (mod == 0x80) {
+            displacementPosition = code.size();
+            emit32(mem.disp);
+        }
+    }
+
+    void X86Encoder::jump(const int label) {
+        if (labels[label] >= 0) {
+            emit32(static_cast<std::int32_t>(labels[label] - static_cast<std::int64_t>(code.size() + 4)));
+        } else {
+            fixups.push_back(Fixup{.position = code.size(), .label = label});
+            emit32(0);
+        }
+    }
+} // goo
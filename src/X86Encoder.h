@@ -0,0 +1,192 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#ifndef X86ENCODER_H
+#define X86ENCODER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace goo {
+    /// The general purpose registers of x86-64, numbered by their hardware encoding.
+    enum X86Register : std::uint8_t {
+        RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+        R8, R9, R10, R11, R12, R13, R14, R15,
+        NO_REGISTER = 0xFF
+    };
+
+    /// The arithmetic operations sharing the same encoding scheme, numbered by their /digit in the opcode tables.
+    enum AluOp : std::uint8_t {
+        ALU_ADD = 0,
+        ALU_OR = 1,
+        ALU_AND = 4,
+        ALU_SUB = 5,
+        ALU_XOR = 6,
+        ALU_CMP = 7
+    };
+
+    /// The SSE2 instructions on xmm registers, numbered by their opcode following 0x0F. All of them require a mandatory
+    /// prefix, which is 0xF3 for SSE_MOVDQU and 0x66 for the others.
+    enum SseOp : std::uint8_t {
+        SSE_MOVDQU = 0x6F,
+        SSE_PCMPEQB = 0x74,
+        SSE_PMOVMSKB = 0xD7,
+        SSE_PXOR = 0xEF
+    };
+
+    /// Condition codes for conditional jumps, numbered by their hardware encoding.
+    enum Condition : std::uint8_t {
+        COND_B = 0x2,
+        COND_AE = 0x3,
+        COND_E = 0x4,
+        COND_NE = 0x5,
+        COND_S = 0x8,
+        COND_NS = 0x9,
+        COND_L = 0xC,
+        COND_GE = 0xD,
+        COND_LE = 0xE,
+        COND_G = 0xF
+    };
+
+    /// A memory operand of the form [base + index + disp] or [rip + disp]. Either register may be omitted by setting
+    /// it to NO_REGISTER. The scale of the index is always 1.
+    struct Memory {
+        X86Register base = NO_REGISTER;
+        X86Register index = NO_REGISTER;
+        std::int32_t disp = 0;
+        bool ripRelative = false;
+    };
+
+    /// A minimal x86-64 machine code encoder, supporting exactly the instructions required by goo's backends. The
+    /// operand size is given in bytes (1, 4 or 8) for every instruction that supports more than one size.
+    ///
+    /// Jumps refer to labels, which are created by ::newLabel and placed by ::bind. Jumps to labels that have not
+    /// been bound yet are patched once ::finish is called. All jumps use 32-bit displacements.
+    class X86Encoder {
+        std::vector<std::uint8_t> code;
+
+        std::vector<std::int64_t> labels;
+
+        struct Fixup {
+            std::size_t position;
+            int label;
+        };
+
+        std::vector<Fixup> fixups;
+
+    public:
+        /// Returns the encoded machine code. Make sure to call ::finish first, otherwise jump targets are missing.
+        [[nodiscard]] const std::vector<std::uint8_t> &bytes() const { return code; }
+
+        [[nodiscard]] std::size_t size() const { return code.size(); }
+
+        /// Clears the encoded code and all labels, to allow for reuse.
+        void reset();
+
+        /// Patches all jumps with the positions of their labels.
+        /// @return False if a jump refers to a label that has never been bound.
+        bool finish();
+
+        int newLabel();
+
+        void bind(int label);
+
+        /// Returns the position of a label within the code, or -1 if the label has not been bound.
+        [[nodiscard]] std::int64_t labelPosition(int label) const { return labels[label]; }
+
+        void alu(AluOp op, int size, X86Register dest, std::int32_t imm);
+
+        void alu(AluOp op, int size, const Memory &dest, std::int32_t imm);
+
+        void alu(AluOp op, int size, X86Register dest, X86Register src);
+
+        void alu(AluOp op, int size, const Memory &dest, X86Register src);
+
+        void alu(AluOp op, int size, X86Register dest, const Memory &src);
+
+        void mov(int size, X86Register dest, std::int64_t imm);
+
+        void mov(int size, const Memory &dest, std::int32_t imm);
+
+        void mov(int size, X86Register dest, X86Register src);
+
+        void mov(int size, const Memory &dest, X86Register src);
+
+        void mov(int size, X86Register dest, const Memory &src);
+
+        /// Zero-extends a byte in memory into a 32-bit register.
+        void movzxByte(X86Register dest, const Memory &src);
+
+        /// Sign-extends a byte in memory into a 32-bit register.
+        void movsxByte(X86Register dest, const Memory &src);
+
+        void lea(X86Register dest, const Memory &src);
+
+        /// Encodes the three operand form: dest = src * imm.
+        void imul(int size, X86Register dest, X86Register src, std::int32_t imm);
+
+        /// Encodes the unsigned multiplication of rax (or al) with src.
+        void mul(int size, X86Register src);
+
+        void test(int size, X86Register dest, X86Register src);
+
+        /// Encodes bsf, or bsr if `reverse` is set: dest = the index of the lowest (highest) set bit of src.
+        void bitScan(bool reverse, int size, X86Register dest, X86Register src);
+
+        /// Encodes an SSE2 instruction. xmm registers are given by their number, e.g. RCX for xmm1. For SSE_PMOVMSKB,
+        /// dest is a general purpose register.
+        void sse(SseOp op, X86Register dest, X86Register src);
+
+        void sse(SseOp op, X86Register dest, const Memory &src);
+
+        void push(X86Register reg);
+
+        void pop(X86Register reg);
+
+        void call(X86Register target);
+
+        void ret();
+
+        void syscall();
+
+        void jmp(int label);
+
+        void jcc(Condition condition, int label);
+
+        /// Pads the code with multi-byte NOPs, until its size is a multiple of `alignment`. As the code is loaded to an
+        /// address that is aligned to at least 16 bytes, this aligns the address of the next instruction likewise.
+        void align(std::int64_t alignment);
+
+        /// Appends raw bytes, for example to emit data.
+        void raw(const std::vector<std::uint8_t> &bytes);
+
+        /// Returns the position of the 32-bit displacement of the last memory operand that has been emitted, which
+        /// allows callers to attach relocations to it.
+        [[nodiscard]] std::size_t lastDisplacement() const { return displacementPosition; }
+
+    private:
+        std::size_t displacementPosition = 0;
+
+        void emit8(std::uint8_t value);
+
+        void emit32(std::int32_t value);
+
+        void emit64(std::int64_t value);
+
+        /// Emits a REX prefix if required. `reg` is the register encoded in ModRM.reg, `base` in ModRM.rm or the
+        /// SIB base and `index` in the SIB index. Byte-sized operations on spl, bpl, sil and dil require an empty
+        /// REX prefix, which is indicated with `byteRegs`.
+        void rex(bool wide, X86Register reg, X86Register index, X86Register base, bool byteRegs);
+
+        void rex(int size, X86Register reg, const Memory &mem);
+
+        void modrm(std::uint8_t reg, X86Register rm);
+
+        void modrm(std::uint8_t reg, const Memory &mem);
+
+        void jump(int label);
+    };
+} // goo
+
+#endif //X86ENCODER_H
@@ -1,16 +1,32 @@
+#include <atomic>
 #include <cstring>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
 #include <CLI/CLI.hpp>
 
 #include "Scanner.h"
 #include "Parser.h"
 #include "CodeGen.h"
 #include "Assembler.h"
+#include "CompilationCache.h"
+#include "ElfAsmBuilder.h"
+#include "ElfWriter.h"
+#include "Input.h"
+#include "Jit.h"
+#include "Optimizer.h"
 #include "Util.h"
+#include "PartialEvaluator.h"
+#include "PhaseTimings.h"
+#include "Profile.h"
 #include "Pipeline.h"
+#include "Tape.h"
 
 using namespace goo;
 namespace fs = std::filesystem;
@@ -18,17 +34,109 @@ namespace fs = std::filesystem;
 struct Config {
     bool debugBuild = false;
     bool interpret = false;
+    bool jit = false;
     bool emitAstTree = false;
     bool emitAsmCode = false;
+    bool executable = false;
     bool noOpt = false;
+    bool optStats = false;
+    bool unbufferedIo = false;
     bool verbose = false;
 
-    std::string outputFile = "out.o";
+    /// Defaults to out.o for object files and out for executables. When compiling several files, this is the directory
+    /// of the output files instead, see batchOutputFile.
+    std::string outputFile;
+
+    /// Whether the compiled program writes a profile at exit, see profileFile.
+    bool profile = false;
+
+    /// A profile file to print instead of compiling anything.
+    std::string showProfile;
+
+    /// A profile file to optimize the program with, which is read into usedProfile, see OptimizerConfig::profile.
+    std::string profileUse;
+    std::shared_ptr<const Profile> usedProfile;
+
+    /// Identifies the content of the used profile in the cache key, as the profile may change while its path doesn't.
+    std::string usedProfileKey;
+
+    /// Either empty, "table" or "json". If set, the measurements of each phase are printed, see PhaseTimings.
+    std::string timePhases;
+
+    /// The number of files that are compiled concurrently.
+    int jobs = 1;
+
+    /// The directory of the CompilationCache, which is only used if set.
+    std::string cacheDir;
+
+    /// The size limit of the CompilationCache in MiB.
+    std::uintmax_t cacheSize = DEFAULT_CACHE_SIZE / (1024 * 1024);
+
+    /// The optimization level, see OptimizerConfig::level.
+    int optLevel = DEFAULT_OPT_LEVEL;
+
+    /// A comma-separated list of optimization passes, that replaces the ones of the optimization level.
+    std::string passes;
+
+    /// The step budget of the PartialEvaluator, 0 disables it.
+    std::int64_t evalBudget = DEFAULT_STEP_BUDGET;
+
+    /// Either "compat" or "wrap8", see CellSemantics.
+    std::string cellSemantics = "compat";
+
+    [[nodiscard]] CellSemantics getCellSemantics() const {
+        return cellSemantics == "wrap8" ? CELLS_WRAP8 : CELLS_COMPAT;
+    }
+
+    /// Whether the optimizer runs at all. --no-opt is equivalent to -O0.
+    [[nodiscard]] bool isOptimized() const {
+        return !noOpt && (optLevel > 0 || !passes.empty());
+    }
+
+    /// Describes all options that affect the compiled code, see CompilationCache::key. As the path of the profile is
+    /// part of the compiled code, so is the output file when profiling.
+    [[nodiscard]] std::string getCacheOptions(const std::string &outputFile) const {
+        return std::format("opt={};passes={};budget={};cells={};debug={};executable={};unbuffered={};profile={};"
+                           "profileUse={}", isOptimized() ? optLevel : 0, passes, evalBudget, cellSemantics,
+                           debugBuild, executable, unbufferedIo, profileFile(outputFile), usedProfileKey);
+    }
+
+    /// Returns the absolute path of the profile written by the compiled program, which is the output file with the
+    /// extension .prof. It is absolute, as the program may be run from any directory.
+    [[nodiscard]] std::string profileFile(const std::string &outputFile) const {
+        if (!profile) {
+            return "";
+        }
+
+        return fs::absolute(fs::path(outputFile).replace_extension(".prof")).lexically_normal().string();
+    }
+
+    [[nodiscard]] OptimizerConfig getOptimizerConfig(const std::string &filepath) const {
+        std::vector<std::string> passNames;
+        if (!passes.empty()) {
+            passNames = splitStringBy(passes, ',');
+        }
+
+        return OptimizerConfig{
+            .level = optLevel,
+            .passes = passNames,
+            .statsOut = optStats ? &std::cerr : nullptr,
+            .statsFile = filepath,
+            .profile = usedProfile
+        };
+    }
 };
 
-int runFile(const std::string &filepath, const Config &config);
+int runFile(const std::string &filepath, const std::string &outputFile, const Config &config, Reporter &reporter,
+            CompilationCache *cache);
+
+int runFiles(const std::vector<std::string> &filepaths, const Config &config, CompilationCache *cache);
 
-void runPrompt();
+std::string batchOutputFile(const std::string &filepath, const Config &config);
+
+void runPrompt(const Config &config);
+
+void addInterpreter(PipelineBuilder &builder, const Config &config);
 
 int main(const int argc, char **argv) {
     CLI::App app{
@@ -42,49 +150,150 @@ int main(const int argc, char **argv) {
                  "Print the translated assembler code instead of producing an object file. This only produces an output if an input file is provided.");
 
     app.add_flag("-d,--debug", config.debugBuild,
-                 "Enable the debug build, which includes debug information and symbols in the output file.");
+                 "Enable the debug build, which includes debug information and symbols in the output file. This requires nasm.");
+
+    app.add_flag("-x,--executable", config.executable,
+                 "Produce a statically linked executable instead of an object file, which can be run without linking it first.");
 
     app.add_flag("--emit-ast", config.emitAstTree,
                  "Print the AST tree of the converted statements.");
 
     app.add_flag("--no-opt", config.noOpt,
-                 "Disable any optimizations.");
+                 "Disable any optimizations. This is equivalent to -O0.");
+
+    app.add_option("-O", config.optLevel,
+                   "The optimization level. 0 disables any optimizations, 1 only groups statements and detects resets, 2 (the default) runs every optimization pass once and 3 runs them repeatedly, until they no longer change anything.")
+            ->check(CLI::Range(0, 3));
+
+    app.add_option("--passes", config.passes,
+                   "A comma-separated list of the optimization passes to run in the given order, instead of the ones of the optimization level. Available passes are group, reset, linear-loop, scan and offset.");
+
+    app.add_flag("--opt-stats", config.optStats,
+                 "Print the wall time and the number of statements before and after each optimization pass.");
+
+    app.add_flag("--time-phases{table}", config.timePhases,
+                 "Print the wall time, CPU time, growth of the peak memory usage and size of the result of each phase of the compiler. --time-phases=json prints one line of JSON per file instead of a table.")
+            ->check(CLI::IsMember({"table", "json"}));
+
+    app.add_flag("--profile", config.profile,
+                 "Let the compiled program count how often each loop is entered and iterated, and how often each output and input is executed. At exit, the program writes the counters to the output file with the extension .prof, for example out.prof. Use --show-profile to print them.");
+
+    app.add_option("--show-profile", config.showProfile,
+                   "Print the hottest loops of a profile written by a program compiled with --profile, instead of compiling anything.");
+
+    app.add_option("--profile-use", config.profileUse,
+                   "Optimize the program with a profile written by the program compiled with --profile. Hot loops are optimized further and aligned, small hot loops are unrolled, and code that never ran is kept small. Loops are matched by their position, therefor the profile remains useful after small changes to the program. Requires an optimization level of at least 1.");
+
+    app.add_flag("--unbuffered-io", config.unbufferedIo,
+                 "Let the compiled program write every byte of output immediately and read input byte by byte, instead of buffering it. Useful if output must appear as soon as it is printed, for example for progress messages of long-running programs.");
 
     app.add_flag("-v,--verbose", config.verbose,
                  "Print more messages for easier debugging.");
 
     app.add_option("-o,--output", config.outputFile,
-                   "Path to a file that contains either ELF code or assembler code.");
+                   "Path to a file that contains either ELF code or assembler code. When compiling several files, the directory to write the output files to, which defaults to the directory of each input file.");
+
+    app.add_option("-j,--jobs", config.jobs,
+                   "The number of files to compile concurrently, when compiling several files. Each output file is named after its input file, with the extension .o for object files and without extension for executables.")
+            ->check(CLI::PositiveNumber);
 
     app.add_option("-i,--interpret", config.interpret,
                    "Interpret the input file, instead of compiling it.");
 
+    app.add_option("--cell-semantics", config.cellSemantics,
+                   "Either compat (the default), where cells hold values from 0 to 127 on a tape of 30,000 cells, or wrap8, where cells wrap around like unsigned bytes on a tape of 32,768 cells. wrap8 produces considerably smaller and faster code.")
+            ->check(CLI::IsMember({"compat", "wrap8"}));
+
+    app.add_option("--eval-budget", config.evalBudget,
+                   "The maximum number of steps to run the program at compile time, before its first input. The output computed this way is written as a whole by the compiled program. Defaults to 10,000,000, 0 disables the evaluation. This only applies to optimized, compiled programs.")
+            ->check(CLI::NonNegativeNumber);
+
+    app.add_option("--cache-dir", config.cacheDir,
+                   "Cache compiled files in this directory, keyed by the source and the options that affect the compiled code. Files that are found in the cache aren't compiled again.");
+
+    app.add_option("--cache-size", config.cacheSize,
+                   "The size limit of the cache in MiB, defaults to 512. Once exceeded, the least recently used files are removed from the cache.")
+            ->check(CLI::PositiveNumber);
+
+    app.add_flag("--jit", config.jit,
+                 "Translate the code to machine code and execute it directly, when interpreting the input file or in REPL mode. Falls back to the interpreter, if the platform doesn't support it.");
+
     app.allow_extras();
     CLI11_PARSE(app, argc, argv);
 
-    if (const auto remainingArgs = app.remaining(); !remainingArgs.empty()) {
-        runFile(remainingArgs[0], config);
+    std::unique_ptr<CompilationCache> cache;
+    if (!config.cacheDir.empty()) {
+        cache = std::make_unique<CompilationCache>(CompilationCacheConfig{
+            .directory = config.cacheDir,
+            .maxBytes = config.cacheSize * 1024 * 1024
+        });
+    }
+
+    if (!config.showProfile.empty()) {
+        const auto profile = Profile::read(config.showProfile);
+        if (!profile.has_value()) {
+            Reporter reporter(config.showProfile);
+            reporter.error("The file is no valid profile.");
+            reporter.print();
+            return 1;
+        }
+
+        profile->print(std::cout);
+        return 0;
+    }
+
+    if (!config.profileUse.empty()) {
+        const auto profile = Profile::read(config.profileUse);
+        const auto file = MappedFile::open(config.profileUse);
+
+        if (!profile.has_value() || file == nullptr) {
+            Reporter reporter(config.profileUse);
+            reporter.error("The file is no valid profile.");
+            reporter.print();
+            return 1;
+        }
+
+        config.usedProfile = std::make_shared<const Profile>(*profile);
+        config.usedProfileKey = CompilationCache::key(file->content(), "");
+    }
+
+    int result = 0;
+
+    if (const auto remainingArgs = app.remaining(); remainingArgs.size() > 1) {
+        result = runFiles(remainingArgs, config, cache.get());
+    } else if (!remainingArgs.empty()) {
+        const auto outputFile = !config.outputFile.empty()
+                                    ? config.outputFile
+                                    : config.executable ? "out" : "out.o";
+
+        Reporter reporter;
+        result = runFile(remainingArgs[0], outputFile, config, reporter, cache.get());
     } else {
-        runPrompt();
+        runPrompt(config);
     }
 
-    return 0;
+    if (cache != nullptr && config.verbose) {
+        cache->printStats(std::cout);
+    }
+
+    return result;
 }
 
 /// Starts the REPL mode. This function repeatedly reads a users input, processes it
 /// and prints results (if any).
 ///
 /// To exit REPL mode, the user must either enter `exit` (case-insensitive) or press `Ctrl-D`.
-void runPrompt() {
+void runPrompt(const Config &config) {
     Reporter reporter;
     std::string line;
 
     StandardPipelineBuilder builder(reporter);
-    const auto pipeline = builder.stringInput()
-            .lexer()
-            .parser()
-            .interpreter()
-            .build();
+    builder.stringInput()
+            .streamingParser(config.isOptimized());
+
+    addInterpreter(builder, config);
+
+    const auto pipeline = builder.build();
 
     while (true) {
         std::cout << "> ";
@@ -107,45 +316,200 @@ void runPrompt() {
     }
 }
 
-int runFile(const std::string &filepath, const Config &config) {
-    Reporter reporter;
+int runFile(const std::string &filepath, const std::string &outputFile, const Config &config, Reporter &reporter,
+            CompilationCache *cache) {
+    const bool writesOutputFile = !config.emitAstTree && !config.interpret && !config.emitAsmCode;
+
+    // The cache is only consulted for files that are compiled, as there is nothing to restore otherwise.
+    std::string cacheKey;
+    if (cache != nullptr && writesOutputFile) {
+        if (const auto source = MappedFile::open(filepath); source != nullptr) {
+            cacheKey = CompilationCache::key(source->content(), config.getCacheOptions(outputFile));
+        }
+
+        if (!cacheKey.empty() && cache->restore(cacheKey, outputFile)) {
+            if (config.verbose) {
+                reporter.output() << "Restored " << outputFile << " from the cache" << std::endl;
+            }
+
+            reporter.output() << "[Finished]" << std::endl;
+            return 0;
+        }
+    }
+
     StandardPipelineBuilder builder(reporter);
 
     const auto initialPayload = std::make_shared<FilePayload>(FilePayload{.filepath = filepath});
 
-    builder.fileInput()
-            .lexer()
-            .parser();
+    // The AST shows the statements as parsed, therefor runs are only grouped if the statements are optimized.
+    builder.mmapFileInput()
+            .streamingParser(config.isOptimized() && !config.emitAstTree);
 
     if (config.emitAstTree) {
         builder.astPrinter().output();
     } else {
-        if (!config.noOpt) {
-            builder.optimizer();
+        if (config.isOptimized()) {
+            builder.optimizer(config.getOptimizerConfig(filepath));
         }
 
         if (config.interpret) {
-            builder.interpreter();
+            addInterpreter(builder, config);
         } else {
-            builder.codeGen(CodeGenConfig{
-                .debugBuild = config.debugBuild
-            });
+            if (config.isOptimized() && config.optLevel >= DEFAULT_OPT_LEVEL && config.evalBudget > 0) {
+                builder.partialEvaluator(PartialEvaluatorConfig{
+                    .cellSemantics = config.getCellSemantics(),
+                    .stepBudget = config.evalBudget
+                });
+            }
+
+            const auto codeGenConfig = CodeGenConfig{
+                .debugBuild = config.debugBuild,
+                .cellSemantics = config.getCellSemantics(),
+                .bufferedIo = !config.unbufferedIo,
+                .profileFile = config.profileFile(outputFile)
+            };
 
             if (config.emitAsmCode) {
-                builder.output();
+                builder.codeGen(codeGenConfig)
+                        .output();
+            } else if (config.debugBuild && !config.executable) {
+                // Only nasm produces debug information, therefor debug builds take the detour via assembler code.
+                builder.codeGen(codeGenConfig)
+                        .assembler(AssemblerConfig{
+                            .debugBuild = config.debugBuild,
+                            .verbose = config.verbose,
+                            .outputFile = outputFile
+                        });
             } else {
-                builder.assembler(AssemblerConfig{
-                    .debugBuild = config.debugBuild,
-                    .verbose = config.verbose,
-                    .outputFile = config.outputFile
-                });
+                builder.elfCodeGen(codeGenConfig, config.executable ? ELF_EXECUTABLE : ELF_RELOCATABLE)
+                        .elfWriter(ElfWriterConfig{
+                            .verbose = config.verbose,
+                            .executable = config.executable,
+                            .outputFile = outputFile
+                        });
             }
         }
     }
 
-    if (const auto pipeline = builder.build(); !pipeline->execute(initialPayload)) {
+    const auto pipeline = builder.build();
+
+    PhaseTimings timings(filepath);
+    if (!config.timePhases.empty()) {
+        pipeline->setPhaseObserver(timings.observer());
+    }
+
+    const bool success = pipeline->execute(initialPayload);
+
+    // Like the statistics of the optimizer, the measurements go to stderr, as stdout may contain the program's output.
+    if (config.timePhases == "json") {
+        timings.printJson(std::cerr);
+    } else if (config.timePhases == "table") {
+        timings.printTable(std::cerr);
+    }
+
+    if (!success) {
         return 1;
     }
 
+    if (!cacheKey.empty()) {
+        cache->store(cacheKey, outputFile);
+    }
+
     return 0;
 }
+
+/// Compiles several files, up to `config.jobs` of them concurrently. Each file is compiled by a pipeline of its own,
+/// whose messages are buffered and printed at once, when the file is done, therefor they don't interleave. Files that
+/// are interpreted or printed are processed one after another.
+/// @return 0 if all files were compiled successfully, otherwise 1.
+int runFiles(const std::vector<std::string> &filepaths, const Config &config, CompilationCache *cache) {
+    const bool printsResults = config.interpret || config.emitAstTree || config.emitAsmCode;
+    const auto jobs = printsResults ? 1 : std::min(static_cast<std::size_t>(config.jobs), filepaths.size());
+
+    std::vector<std::string> outputFiles;
+
+    // Different paths may refer to the same file, therefor the paths are compared once made absolute.
+    const auto normalize = [](const std::string &path) { return fs::absolute(path).lexically_normal(); };
+    std::set<fs::path> inputFiles;
+    std::set<fs::path> uniqueOutputFiles;
+
+    for (const auto &filepath: filepaths) {
+        inputFiles.insert(normalize(filepath));
+    }
+
+    for (const auto &filepath: filepaths) {
+        const auto &outputFile = outputFiles.emplace_back(batchOutputFile(filepath, config));
+
+        if (printsResults) {
+            continue;
+        }
+
+        if (inputFiles.contains(normalize(outputFile)) || !uniqueOutputFiles.insert(normalize(outputFile)).second) {
+            Reporter reporter(filepath);
+            reporter.error("The output file " + outputFile + " would overwrite another input or output file.");
+            reporter.print();
+            return 1;
+        }
+    }
+
+    std::atomic<std::size_t> next = 0;
+    std::atomic<int> failures = 0;
+    std::mutex outputMutex;
+
+    const auto compileFiles = [&] {
+        for (auto idx = next++; idx < filepaths.size(); idx = next++) {
+            std::stringstream messages;
+            Reporter reporter(filepaths[idx], jobs > 1 ? messages : std::cout);
+
+            if (runFile(filepaths[idx], outputFiles[idx], config, reporter, cache) != 0) {
+                ++failures;
+            }
+
+            const std::lock_guard lock(outputMutex);
+            std::cout << messages.str() << std::flush;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t worker = 1; worker < jobs; worker++) {
+        workers.emplace_back(compileFiles);
+    }
+
+    compileFiles();
+
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    return failures > 0 ? 1 : 0;
+}
+
+/// Returns the output file of an input file when compiling several files, which is named after the input file, with
+/// the extension .o for object files and without extension for executables. It is located in the directory given by
+/// -o, otherwise next to the input file.
+std::string batchOutputFile(const std::string &filepath, const Config &config) {
+    const fs::path input(filepath);
+    const auto directory = !config.outputFile.empty() ? fs::path(config.outputFile) : input.parent_path();
+
+    auto output = directory / input.stem();
+    if (!config.executable) {
+        output += ".o";
+    }
+
+    return output.string();
+}
+
+/// Adds the phase that executes the statements to the builder. This is the JIT if it was requested and is supported
+/// by the platform, otherwise the interpreter.
+void addInterpreter(PipelineBuilder &builder, const Config &config) {
+    if (config.jit && Jit::isAvailable()) {
+        builder.jit(std::cout, config.getCellSemantics());
+        return;
+    }
+
+    if (config.jit && config.verbose) {
+        std::cout << "The JIT is not available on this platform, falling back to the interpreter." << std::endl;
+    }
+
+    builder.bytecodeInterpreter(std::cout, config.getCellSemantics());
+}
@@ -9,15 +9,46 @@
 #include <format>
 #include <iostream>
 #include <sstream>
+#include "../src/Tape.h"
 #include "../src/Util.h"
 
+/// The base addresses of the I/O buffers and the constant data produced by `lea`, whereas the tape starts at 0.
+constexpr int OUT_BUF_ADDRESS = 1 << 20;
+constexpr int IN_BUF_ADDRESS = 2 << 20;
+constexpr int DATA_ADDRESS = 3 << 20;
+constexpr int IO_BUFFER_SIZE = 65536;
+
+/// Returns the offset of a memory operand relative to the tape pointer, e.g. 3 for `byte [rax + rbx + 3]`, or relative
+/// to another register, e.g. -2 for `byte [rax - 2]`.
+static int tapePtrOffset(const std::string &operand, const std::string &base = "rbx") {
+    const auto rbxPos = operand.find(base);
+    const auto end = operand.find(']', rbxPos);
+
+    if (const auto plusPos = operand.find('+', rbxPos); plusPos < end) {
+        return std::stoi(operand.substr(plusPos + 1, end - plusPos - 1));
+    } else if (const auto minusPos = operand.find('-', rbxPos); minusPos < end) {
+        return -std::stoi(operand.substr(minusPos + 1, end - minusPos - 1));
+    }
+
+    return 0;
+}
+
 AssemblerEmulator::AssemblerEmulator() {
-    tape = new int[30000];
-    memset(tape, 0, sizeof(int[30000]));
+    // Like the tape of compiled programs, the tape is padded on either side for cells relative to the tape pointer.
+    tape = new int[WRAP8_TAPE_SIZE + 2 * TAPE_PADDING] + TAPE_PADDING;
+    memset(tape - TAPE_PADDING, 0, sizeof(int[WRAP8_TAPE_SIZE + 2 * TAPE_PADDING]));
+
+    outBuf = new int[IO_BUFFER_SIZE];
+    memset(outBuf, 0, sizeof(int[IO_BUFFER_SIZE]));
+
+    inBuf = new int[IO_BUFFER_SIZE];
+    memset(inBuf, 0, sizeof(int[IO_BUFFER_SIZE]));
 }
 
 AssemblerEmulator::~AssemblerEmulator() {
-    delete[] tape;
+    delete[] (tape - TAPE_PADDING);
+    delete[] outBuf;
+    delete[] inBuf;
 }
 
 std::string AssemblerEmulator::execute(const std::string &code) {
@@ -34,6 +65,21 @@ std::string AssemblerEmulator::execute(const std::string &code) {
 
             line = goo::stripWhitespace(line);
 
+            // constant data is kept apart from the code, with each symbol referring to its first byte
+            if (const auto dbPos = line.find("db "); dbPos == 0 || line.find(": db ") != std::string::npos) {
+                if (dbPos != 0) {
+                    dataSymbols[line.substr(0, line.find(':'))] = DATA_ADDRESS + static_cast<int>(data.size());
+                }
+
+                auto bytes = std::stringstream{line.substr(line.find("db ") + 3)};
+                std::string byte;
+                while (std::getline(bytes, byte, ',')) {
+                    data.push_back(std::stoi(byte));
+                }
+
+                continue;
+            }
+
             // as only labels end with : we track the line number
             if (line.ends_with(":")) {
                 labels[line.substr(0, line.size() - 1)] = lines.size();
@@ -84,15 +130,21 @@ int AssemblerEmulator::executeLine(const int execPtr) {
     if (cmd == "mov")
         return mov(args, execPtr);
     if (cmd == "lea")
-        return execPtr + 1;
+        return lea(args, execPtr);
     if (cmd == "add")
         return add(args, execPtr);
     if (cmd == "cmp")
         return cmp(args, execPtr);
+    if (cmd == "je")
+        return je(args, execPtr);
+    if (cmd == "jne")
+        return jne(args, execPtr);
     if (cmd == "jge")
         return jge(args, execPtr);
     if (cmd == "jle")
         return jle(args, execPtr);
+    if (cmd == "jg")
+        return jg(args, execPtr);
     if (cmd == "mul")
         return mul(args, execPtr);
     if (cmd == "sub")
@@ -101,8 +153,22 @@ int AssemblerEmulator::executeLine(const int execPtr) {
         return syscall(args, execPtr);
     if (cmd == "jmp")
         return jmp(args, execPtr);
-    if (cmd == "xor")
+    if (cmd == "xor" || cmd == "align")
         return execPtr + 1;
+    if (cmd == "and")
+        return a_nd(args, execPtr);
+    if (cmd == "movdqu")
+        return movdqu(args, execPtr);
+    if (cmd == "pxor")
+        return pxor(args, execPtr);
+    if (cmd == "pcmpeqb")
+        return pcmpeqb(args, execPtr);
+    if (cmd == "pmovmskb")
+        return pmovmskb(args, execPtr);
+    if (cmd == "bsf")
+        return bsf(args, execPtr);
+    if (cmd == "bsr")
+        return bsr(args, execPtr);
 
     hasError = true;
     return -1;
@@ -122,7 +188,7 @@ int AssemblerEmulator::mov(Params args, const int execPtr) {
         return -1;
     }
 
-    memcpy(dest.ptr, &src.value, sizeof(int));
+    store(args[0], dest, src.value);
 
     return execPtr + 1;
 }
@@ -141,8 +207,7 @@ int AssemblerEmulator::add(Params args, const int execPtr) {
         return -1;
     }
 
-    const auto sum = src.value + dest.value;
-    memcpy(dest.ptr, &sum, sizeof(int));
+    store(args[0], dest, src.value + dest.value);
 
     return execPtr + 1;
 }
@@ -161,7 +226,31 @@ int AssemblerEmulator::cmp(Params args, const int execPtr) {
         return -1;
     }
 
-    cmpResult = dest.value - src.value;
+    if (isByteOperand(args[0])) {
+        cmpResult = static_cast<std::int8_t>(dest.value) - static_cast<std::int8_t>(src.value);
+    } else {
+        cmpResult = dest.value - src.value;
+    }
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::je(Params args, const int execPtr) {
+    const auto &label = args[0];
+
+    if (cmpResult == 0) {
+        return labels[label];
+    }
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::jne(Params args, const int execPtr) {
+    const auto &label = args[0];
+
+    if (cmpResult != 0) {
+        return labels[label];
+    }
 
     return execPtr + 1;
 }
@@ -186,6 +275,16 @@ int AssemblerEmulator::jle(Params args, const int execPtr) {
     return execPtr + 1;
 }
 
+int AssemblerEmulator::jg(Params args, const int execPtr) {
+    const auto &label = args[0];
+
+    if (cmpResult > 0) {
+        return labels[label];
+    }
+
+    return execPtr + 1;
+}
+
 int AssemblerEmulator::mul(Params args, const int execPtr) {
     const auto src = getValue(args[0]);
     rax = rax * src.value;
@@ -207,8 +306,7 @@ int AssemblerEmulator::sub(Params args, const int execPtr) {
         return -1;
     }
 
-    const auto difference = dest.value - src.value;
-    memcpy(dest.ptr, &difference, sizeof(int));
+    store(args[0], dest, dest.value - src.value);
 
     return execPtr + 1;
 }
@@ -218,10 +316,104 @@ int AssemblerEmulator::jmp(Params args, int execPtr) {
     return labels[label];
 }
 
+int AssemblerEmulator::lea(Params args, const int execPtr) {
+    if (args.size() != 2) {
+        hasError = true;
+        return -1;
+    }
+
+    auto dest = getValue(args[0]);
+    if (dest.ptr == nullptr) {
+        hasError = true;
+        return -1;
+    }
+
+    if (args[1] == "[rel outBuf]") {
+        store(args[0], dest, OUT_BUF_ADDRESS);
+        return execPtr + 1;
+    }
+
+    if (args[1] == "[rel inBuf]") {
+        store(args[0], dest, IN_BUF_ADDRESS);
+        return execPtr + 1;
+    }
+
+    if (args[1].starts_with("[rel ")) {
+        if (const auto symbol = dataSymbols.find(args[1].substr(5, args[1].size() - 6)); symbol != dataSymbols.end()) {
+            store(args[0], dest, symbol->second);
+            return execPtr + 1;
+        }
+    }
+
+    if (args[1] == "[tape + rcx]") {
+        store(args[0], dest, rcx);
+        return execPtr + 1;
+    }
+
+    if (args[1].starts_with("[tape + rbx")) {
+        store(args[0], dest, rbx + tapePtrOffset(args[1]));
+        return execPtr + 1;
+    }
+
+    // Apart from the above, only relative addresses to the tape pointer are emulated, as any other address refers to
+    // the tape itself.
+    if (!args[1].starts_with("[rbx")) {
+        store(args[0], dest, 0);
+        return execPtr + 1;
+    }
+
+    const auto address = args[1].substr(1, args[1].size() - 2);
+    auto value = rbx;
+
+    if (const auto plusPos = address.find('+'); plusPos != std::string::npos) {
+        value += std::stoi(address.substr(plusPos + 1));
+    } else if (const auto minusPos = address.find('-'); minusPos != std::string::npos) {
+        value -= std::stoi(address.substr(minusPos + 1));
+    }
+
+    store(args[0], dest, value);
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::a_nd(Params args, const int execPtr) {
+    if (args.size() != 2) {
+        hasError = true;
+        return -1;
+    }
+
+    const auto src = getValue(args[1]);
+    auto dest = getValue(args[0]);
+
+    if (dest.ptr == nullptr) {
+        hasError = true;
+        return -1;
+    }
+
+    store(args[0], dest, dest.value & src.value);
+
+    return execPtr + 1;
+}
+
 int AssemblerEmulator::syscall(Params args, int execPtr) {
     if (rax == 1 && rdi == 1) {
-        const auto *bytes = static_cast<unsigned char *>(static_cast<void *>(&tape[rbx]));
-        output << std::to_string(bytes[0]) << std::flush;
+        const auto *buffer = rsi >= DATA_ADDRESS
+                                 ? &data[rsi - DATA_ADDRESS]
+                                 : rsi >= OUT_BUF_ADDRESS
+                                       ? &outBuf[rsi - OUT_BUF_ADDRESS]
+                                       : &tape[rsi];
+
+        for (int idx = 0; idx < rdx; idx++) {
+            output << static_cast<char>(buffer[idx]);
+        }
+
+        output << std::flush;
+        return execPtr + 1;
+    }
+
+    // read: we always reach the end of the input
+    if (rax == 0 && rdi == 0) {
+        rax = 0;
         return execPtr + 1;
     }
 
@@ -229,6 +421,122 @@ int AssemblerEmulator::syscall(Params args, int execPtr) {
     return execPtr + 1;
 }
 
+int AssemblerEmulator::movdqu(Params args, const int execPtr) {
+    auto *dest = args.size() == 2 ? getXmm(args[0]) : nullptr;
+
+    // Only loads from the tape, relative to the tape pointer, are emulated.
+    if (dest == nullptr || !args[1].starts_with("[rax + rbx")) {
+        hasError = true;
+        return -1;
+    }
+
+    const auto address = rbx + tapePtrOffset(args[1]);
+    for (int idx = 0; idx < 16; idx++) {
+        dest[idx] = tape[address + idx] & 0xFF;
+    }
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::pxor(Params args, const int execPtr) {
+    auto *dest = args.size() == 2 ? getXmm(args[0]) : nullptr;
+    const auto *src = args.size() == 2 ? getXmm(args[1]) : nullptr;
+
+    if (dest == nullptr || src == nullptr) {
+        hasError = true;
+        return -1;
+    }
+
+    for (int idx = 0; idx < 16; idx++) {
+        dest[idx] ^= src[idx];
+    }
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::pcmpeqb(Params args, const int execPtr) {
+    auto *dest = args.size() == 2 ? getXmm(args[0]) : nullptr;
+    const auto *src = args.size() == 2 ? getXmm(args[1]) : nullptr;
+
+    if (dest == nullptr || src == nullptr) {
+        hasError = true;
+        return -1;
+    }
+
+    for (int idx = 0; idx < 16; idx++) {
+        dest[idx] = dest[idx] == src[idx] ? 0xFF : 0;
+    }
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::pmovmskb(Params args, const int execPtr) {
+    const auto *src = args.size() == 2 ? getXmm(args[1]) : nullptr;
+    auto dest = src != nullptr ? getValue(args[0]) : Value{};
+
+    if (dest.ptr == nullptr) {
+        hasError = true;
+        return -1;
+    }
+
+    int mask = 0;
+    for (int idx = 0; idx < 16; idx++) {
+        mask |= (src[idx] >> 7 & 1) << idx;
+    }
+
+    store(args[0], dest, mask);
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::bsf(Params args, const int execPtr) {
+    if (args.size() != 2) {
+        hasError = true;
+        return -1;
+    }
+
+    const auto src = getValue(args[1]);
+    auto dest = getValue(args[0]);
+
+    // Like on x86, the result is undefined for 0, which we treat as an error.
+    if (dest.ptr == nullptr || src.value == 0) {
+        hasError = true;
+        return -1;
+    }
+
+    store(args[0], dest, __builtin_ctz(src.value));
+
+    return execPtr + 1;
+}
+
+int AssemblerEmulator::bsr(Params args, const int execPtr) {
+    if (args.size() != 2) {
+        hasError = true;
+        return -1;
+    }
+
+    const auto src = getValue(args[1]);
+    auto dest = getValue(args[0]);
+
+    if (dest.ptr == nullptr || src.value == 0) {
+        hasError = true;
+        return -1;
+    }
+
+    store(args[0], dest, 31 - __builtin_clz(src.value));
+
+    return execPtr + 1;
+}
+
+int *AssemblerEmulator::getXmm(const std::string &label) {
+    if (label == "xmm0")
+        return xmm[0];
+    if (label == "xmm1")
+        return xmm[1];
+
+    return nullptr;
+}
+
 void *AssemblerEmulator::getPointer(const std::string &label) {
     if (label == "rax")
         return &rax;
@@ -244,17 +552,37 @@ void *AssemblerEmulator::getPointer(const std::string &label) {
         return &rsi;
     if (label == "r8" || label == "r8b")
         return &r8;
-    if (label == "r9" || label == "r9b")
+    if (label == "r9" || label == "r9b" || label == "r9d")
         return &r9;
     if (label == "r10" || label == "r10b")
         return &r10;
+    if (label == "r11" || label == "r11b")
+        return &r11;
+    if (label == "r12")
+        return &r12;
+    if (label == "r13")
+        return &r13;
+    if (label == "r14")
+        return &r14;
+    if (label == "r15" || label == "r15b")
+        return &r15;
 
     // if we reach this pointer, we either has an invalid register or
     // refer to the tape etc
     if (label.find("[rel tape]") != std::string::npos) {
         return tape;
-    } else if (label.find("[rax + rbx]") != std::string::npos) {
-        return &tape[rbx];
+    } else if (label.find("[rax + rbx") != std::string::npos) {
+        return &tape[rbx + tapePtrOffset(label)];
+    } else if (label.find("[rax + r8]") != std::string::npos) {
+        return &tape[r8];
+    } else if (label.find("[rax + rcx]") != std::string::npos) {
+        return &tape[rcx];
+    } else if (label.find("[rax") != std::string::npos) {
+        return &tape[tapePtrOffset(label, "rax")];
+    } else if (label.find("[outBuf + r12]") != std::string::npos) {
+        return &outBuf[r12];
+    } else if (label.find("[inBuf + r13]") != std::string::npos) {
+        return &inBuf[r13];
     }
 
     return nullptr;
@@ -284,4 +612,14 @@ Value AssemblerEmulator::getValue(const std::string& label) {
         .ptr = ptr,
         .value = value
     };
-}
\ No newline at end of file
+}
+
+void AssemblerEmulator::store(const std::string &label, const Value &dest, const int value) {
+    const auto truncated = isByteOperand(label) ? value & 0xFF : value;
+    memcpy(dest.ptr, &truncated, sizeof(int));
+}
+
+bool AssemblerEmulator::isByteOperand(const std::string &label) {
+    return label.starts_with("byte ") || label == "r8b" || label == "r9b" || label == "r10b" ||
+           label == "r11b" || label == "r15b";
+}
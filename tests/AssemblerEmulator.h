@@ -18,6 +18,12 @@ struct Value {
 /// optimized and unoptimized statements produce the same result, as well as making sure that the assembler code
 /// is equivalent to the interpreted statements.
 /// This emulator is not intended for production use, as its implementation is very crude.
+///
+/// Operands of byte size (e.g. `byte [rax + rbx]` or `r8b`) behave like bytes: results are truncated to 8 bits and
+/// comparisons are signed, as they are on x86. The tape is large enough for both CellSemantics.
+///
+/// Addresses loaded via `lea` are only tracked for the tape, the I/O buffers and constant data, each of which has its
+/// own base address. Reading input always results in the end of the input.
 class AssemblerEmulator {
     bool hasError = false;
 
@@ -31,12 +37,23 @@ class AssemblerEmulator {
 
     int *tape;
 
+    int *outBuf;
+
+    int *inBuf;
+
+    /// The bytes defined by `db`, as well as the address of each symbol referring to them.
+    std::vector<int> data;
+    std::map<std::string, int> dataSymbols;
+
     int cmpResult = 0;
 
     std::stringstream output;
 
     // registers
-    int rax = 0, rbx = 0, rcx = 0, rdx = 0, rdi = 0, rsi = 0, r8 = 0, r9 = 0, r10 = 0;
+    int rax = 0, rbx = 0, rcx = 0, rdx = 0, rdi = 0, rsi = 0, r8 = 0, r9 = 0, r10 = 0, r11 = 0, r12 = 0, r13 = 0, r14 = 0, r15 = 0;
+
+    /// xmm0 and xmm1, each of which holds 16 bytes.
+    int xmm[2][16] = {};
 
 public:
     AssemblerEmulator();
@@ -57,21 +74,51 @@ private:
 
     int cmp(Params args, int execPtr);
 
+    int je(Params args, int execPtr);
+
+    int jne(Params args, int execPtr);
+
     int jge(Params args, int execPtr);
 
     int jle(Params args, int execPtr);
 
+    int jg(Params args, int execPtr);
+
     int mul(Params args, int execPtr);
 
     int sub(Params args, int execPtr);
 
     int jmp(Params args, int execPtr);
 
+    int lea(Params args, int execPtr);
+
+    int a_nd(Params args, int execPtr);
+
     int syscall(Params args, int execPtr);
 
+    int movdqu(Params args, int execPtr);
+
+    int pxor(Params args, int execPtr);
+
+    int pcmpeqb(Params args, int execPtr);
+
+    int pmovmskb(Params args, int execPtr);
+
+    int bsf(Params args, int execPtr);
+
+    int bsr(Params args, int execPtr);
+
+    /// Returns the bytes of xmm0 or xmm1, or nullptr for any other operand.
+    int *getXmm(const std::string &label);
+
     void *getPointer(const std::string& label);
 
     Value getValue(const std::string& label);
+
+    /// Writes the value to the destination, truncating it to 8 bits for operands of byte size.
+    static void store(const std::string &label, const Value &dest, int value);
+
+    static bool isByteOperand(const std::string &label);
 };
 
 
@@ -2,9 +2,16 @@
 // Created by michael on 17.06.25.
 //
 
+#include <sstream>
 #include <catch2/catch_test_macros.hpp>
 
 #include "AssemblerEmulator.h"
+#include "../src/CodeGen.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+#include "../src/Tape.h"
+
+using namespace goo;
 
 
 TEST_CASE("Assembler Emulator: make sure that statements are correctly grouped", "[asmemu]") {
@@ -16,3 +23,89 @@ TEST_CASE("Assembler Emulator: make sure that statements are correctly grouped",
         "sub r8, rbx\n"
         "mov byte [rax + rbx], r8");
 }
+
+/// Runs the code generated for the given cell semantics in the emulator and compares its output with the Interpreter.
+void testCellSemantics(const std::string &code, const CellSemantics cellSemantics) {
+    const auto &payload = std::make_shared<StringPayload>(StringPayload{.value = code});
+
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    StandardPipelineBuilder codeGenBuilder(reporter);
+    const auto codeGenPipeline = codeGenBuilder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .codeGen(CodeGenConfig{.debugBuild = false, .cellSemantics = cellSemantics})
+            .debug(debugPhase)
+            .build();
+
+    REQUIRE(codeGenPipeline->execute(payload));
+
+    AssemblerEmulator assembler;
+    const auto &emulatedResult = assembler.execute(debugPhase->getValue());
+
+    std::stringstream buffer;
+
+    StandardPipelineBuilder interpreterBuilder(reporter);
+    const auto interpreterPipeline = interpreterBuilder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .interpreter(buffer, cellSemantics)
+            .build();
+
+    REQUIRE(interpreterPipeline->execute(payload));
+
+    REQUIRE(emulatedResult == buffer.str());
+}
+
+TEST_CASE("Assembler Emulator: make sure that compat cells match the Interpreter", "[asmemu]") {
+    testCellSemantics("+++.>++.<-.", CELLS_COMPAT);
+    testCellSemantics("-.", CELLS_COMPAT);
+    testCellSemantics("+++[>++<-]>.", CELLS_COMPAT);
+    testCellSemantics("+++[>+++[>++<-]<-]>>.", CELLS_COMPAT);
+    testCellSemantics("++++.[-].", CELLS_COMPAT);
+}
+
+TEST_CASE("Assembler Emulator: make sure that wrap8 cells match the Interpreter", "[asmemu]") {
+    testCellSemantics("+++.>++.<-.", CELLS_WRAP8);
+    testCellSemantics("-.", CELLS_WRAP8);
+    testCellSemantics("--.>-----.", CELLS_WRAP8);
+    testCellSemantics("+++[>++<-]>.", CELLS_WRAP8);
+    testCellSemantics("+++[>+++[>++<-]<-]>>.", CELLS_WRAP8);
+    testCellSemantics("++++++++++[>+++++++++++++<-]>.", CELLS_WRAP8);
+    testCellSemantics("-[>+++<-]>.", CELLS_WRAP8);
+    testCellSemantics("+++[<+++>-]<.", CELLS_WRAP8);
+    testCellSemantics("<-.>>>+[<<+>>-]<<.", CELLS_WRAP8);
+}
+
+TEST_CASE("Assembler Emulator: make sure that cells modified more than once are cached in registers", "[asmemu]") {
+    const auto &payload = std::make_shared<StringPayload>(StringPayload{.value = ",+>+<+.>."});
+
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .codeGen(CodeGenConfig{.debugBuild = false})
+            .debug(debugPhase)
+            .build();
+
+    REQUIRE(pipeline->execute(payload));
+
+    // The current cell is modified twice, the next one only once.
+    const auto &code = debugPhase->getValue();
+    REQUIRE(code.find("mov r9b, byte [rax + rbx]") != std::string::npos);
+    REQUIRE(code.find("mov byte [rax + rbx], r9b") != std::string::npos);
+    REQUIRE(code.find("lea rcx, [rbx + 1]") != std::string::npos);
+    REQUIRE(code.find("add byte [rax + rcx], 1") != std::string::npos);
+
+    testCellSemantics("+>++<+>-<.>.", CELLS_COMPAT);
+    testCellSemantics("+>++<+>-<.>.", CELLS_WRAP8);
+    testCellSemantics("+++[-]+++>+<[-]+.>.", CELLS_COMPAT);
+    testCellSemantics("+++[-]+++>+<[-]+.>.", CELLS_WRAP8);
+}
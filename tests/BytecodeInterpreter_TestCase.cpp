@@ -0,0 +1,108 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+#include "../src/Tape.h"
+
+using namespace goo;
+
+/*
+ * These test cases make sure that the BytecodeInterpreter produces the same output as the tree-walking Interpreter,
+ * both for optimized and unoptimized statements.
+ */
+
+std::string runTreeInterpreter(const std::string &code, const bool optimize,
+                               const CellSemantics cellSemantics = CELLS_COMPAT) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser();
+
+    if (optimize) {
+        builder.optimizer();
+    }
+
+    const auto pipeline = builder.interpreter(buffer, cellSemantics).build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    return buffer.str();
+}
+
+std::string runBytecodeInterpreter(const std::string &code, const bool optimize,
+                                   const CellSemantics cellSemantics = CELLS_COMPAT) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser();
+
+    if (optimize) {
+        builder.optimizer();
+    }
+
+    const auto pipeline = builder.bytecodeInterpreter(buffer, cellSemantics).build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    return buffer.str();
+}
+
+void testBytecodeStmts(const std::string &code, const CellSemantics cellSemantics = CELLS_COMPAT) {
+    REQUIRE(runTreeInterpreter(code, false, cellSemantics) == runBytecodeInterpreter(code, false, cellSemantics));
+    REQUIRE(runTreeInterpreter(code, true, cellSemantics) == runBytecodeInterpreter(code, true, cellSemantics));
+}
+
+TEST_CASE("Bytecode: make sure that simple statements are processed correctly", "[bytecode]") {
+    testBytecodeStmts("+.");
+    testBytecodeStmts("++-.");
+    testBytecodeStmts(">+<.");
+    testBytecodeStmts("-.");
+    testBytecodeStmts("<+.>>+.");
+}
+
+TEST_CASE("Bytecode: make sure that conditionals are processed correctly", "[bytecode]") {
+    testBytecodeStmts("[+].");
+    testBytecodeStmts("+++[>++<-]>.");
+    testBytecodeStmts("++[>+++[>++<-]<-]>>.");
+    testBytecodeStmts("+[[-]+[-]].");
+}
+
+TEST_CASE("Bytecode: make sure that optimized statements are processed correctly", "[bytecode]") {
+    testBytecodeStmts("++[>++++<-]>.");
+    testBytecodeStmts("+[->+<]>.");
+    testBytecodeStmts(">+[-<+>]<.");
+    testBytecodeStmts("++++.[-]+++.");
+}
+
+TEST_CASE("Bytecode: make sure that wrap8 cells are processed correctly", "[bytecode]") {
+    testBytecodeStmts("-.", CELLS_WRAP8);
+    testBytecodeStmts("<-.>>+.", CELLS_WRAP8);
+    testBytecodeStmts("++++++++++[>+++++++++++++<-]>.", CELLS_WRAP8);
+    testBytecodeStmts("-[>+++<-]>.", CELLS_WRAP8);
+    testBytecodeStmts("+++[<+++>-]<.", CELLS_WRAP8);
+}
+
+TEST_CASE("Bytecode: make sure that linear loops match unoptimized loops", "[bytecode]") {
+    for (const auto cellSemantics: {CELLS_COMPAT, CELLS_WRAP8}) {
+        for (const auto &code: {"+++[->+>++>+++<<<]>.>.>.", "+++[->-<]>.", "-[->+++<]>.", ">[-<+>]<."}) {
+            REQUIRE(runTreeInterpreter(code, false, cellSemantics) == runBytecodeInterpreter(code, true, cellSemantics));
+        }
+    }
+}
+
+TEST_CASE("Bytecode: make sure that scans match unoptimized loops", "[bytecode]") {
+    for (const auto cellSemantics: {CELLS_COMPAT, CELLS_WRAP8}) {
+        for (const auto &code: {">+>+>+<<[>]+++.", "+++>>>+>>+>>+<<[<<]<.", "+[<]+.", "<[<]+[>]+.", "+>>+<<[>>>]+."}) {
+            REQUIRE(runTreeInterpreter(code, false, cellSemantics) == runBytecodeInterpreter(code, true, cellSemantics));
+        }
+    }
+}
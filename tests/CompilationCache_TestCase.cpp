@@ -0,0 +1,95 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/CompilationCache.h"
+
+using namespace goo;
+
+namespace fs = std::filesystem;
+
+/// Writes the content to a file within the directory and returns its path.
+std::string writeFile(const fs::path &directory, const std::string &name, const std::string &content) {
+    const auto path = (directory / name).string();
+
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << content;
+
+    return path;
+}
+
+std::string readFile(const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    std::stringstream content;
+    content << ifs.rdbuf();
+
+    return content.str();
+}
+
+TEST_CASE("CompilationCache: make sure that keys depend on the source and the options", "[cache]") {
+    const auto key = CompilationCache::key("+[-].", "opt=2");
+
+    REQUIRE(key.size() == 64);
+    REQUIRE(key == CompilationCache::key("+[-].", "opt=2"));
+    REQUIRE(key != CompilationCache::key("+[-],", "opt=2"));
+    REQUIRE(key != CompilationCache::key("+[-].", "opt=3"));
+    REQUIRE(CompilationCache::key("ab", "c") != CompilationCache::key("a", "bc"));
+}
+
+TEST_CASE("CompilationCache: make sure that stored files are restored", "[cache]") {
+    const auto directory = fs::temp_directory_path() / "goo_cache_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    CompilationCache cache(CompilationCacheConfig{.directory = (directory / "cache").string()});
+    const auto key = CompilationCache::key("+", "");
+    const auto output = (directory / "out.o").string();
+
+    REQUIRE_FALSE(cache.restore(key, output));
+
+    cache.store(key, writeFile(directory, "compiled.o", "ELF"));
+
+    // The temporary file has been renamed to the entry.
+    REQUIRE(std::distance(fs::directory_iterator(directory / "cache"), fs::directory_iterator()) == 1);
+
+    REQUIRE(cache.restore(key, output));
+    REQUIRE(readFile(output) == "ELF");
+
+    // Modifying the restored file in place leaves the entry intact.
+    writeFile(directory, "out.o", "modified");
+    REQUIRE(cache.restore(key, output));
+    REQUIRE(readFile(output) == "ELF");
+
+    REQUIRE(cache.getHits() == 2);
+    REQUIRE(cache.getMisses() == 1);
+
+    fs::remove_all(directory);
+}
+
+TEST_CASE("CompilationCache: make sure that the least recently used entries are evicted", "[cache]") {
+    const auto directory = fs::temp_directory_path() / "goo_cache_eviction_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    CompilationCache cache(CompilationCacheConfig{.directory = (directory / "cache").string(), .maxBytes = 250});
+    const auto compiled = writeFile(directory, "compiled.o", std::string(100, 'x'));
+    const auto output = (directory / "out.o").string();
+
+    cache.store("first", compiled);
+    cache.store("second", compiled);
+
+    // Using the first entry makes the second one the least recently used.
+    REQUIRE(cache.restore("first", output));
+    cache.store("third", compiled);
+
+    REQUIRE(cache.restore("first", output));
+    REQUIRE_FALSE(cache.restore("second", output));
+    REQUIRE(cache.restore("third", output));
+
+    fs::remove_all(directory);
+}
@@ -0,0 +1,132 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/AstPrinter.h"
+#include "../src/CodeGen.h"
+#include "../src/ElfAsmBuilder.h"
+#include "../src/ElfWriter.h"
+#include "../src/Jit.h"
+#include "../src/Optimizer.h"
+#include "../src/PartialEvaluator.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+namespace fs = std::filesystem;
+
+/*
+ * These test cases make sure that every phase after the parser handles a million nested conditionals, which would
+ * overflow the call stack if any of them recursed into the bodies of conditionals. Each loop of the program is entered
+ * once, therefor the interpreters run through all of them as well.
+ */
+
+constexpr int DEEP_NESTING = 1000000;
+
+/// Increases the first cell, enters all nested loops, resets the cell in the innermost one and prints the cell plus 1.
+std::string deeplyNestedCode() {
+    return "+" + std::string(DEEP_NESTING, '[') + "-" + std::string(DEEP_NESTING, ']') + "+.";
+}
+
+/// Runs the deeply nested code with an interpreter or the JIT and returns its output.
+std::string runDeeplyNested(const char backend, const int level) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer(OptimizerConfig{.level = level});
+
+    switch (backend) {
+        case 'b':
+            builder.bytecodeInterpreter(buffer);
+            break;
+        case 'j':
+            builder.jit(buffer);
+            break;
+        default:
+            builder.interpreter(buffer);
+            break;
+    }
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = deeplyNestedCode()})));
+
+    return buffer.str();
+}
+
+/// Compiles the deeply nested code to an executable, runs it and returns its output.
+std::string runDeeplyNestedExecutable(const bool evaluate) {
+    const auto path = (fs::temp_directory_path() / "goo_deep_nesting_test").string();
+
+    Reporter reporter;
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer(OptimizerConfig{.level = 2});
+
+    if (evaluate) {
+        builder.partialEvaluator(PartialEvaluatorConfig{});
+    }
+
+    builder.elfCodeGen(CodeGenConfig{.debugBuild = false}, ELF_EXECUTABLE)
+            .elfWriter(ElfWriterConfig{.verbose = false, .executable = true, .outputFile = path});
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = deeplyNestedCode()})));
+
+    std::FILE *process = popen(path.c_str(), "r");
+    REQUIRE(process != nullptr);
+
+    std::string output;
+    for (int c = fgetc(process); c != EOF; c = fgetc(process)) {
+        output += static_cast<char>(c);
+    }
+
+    REQUIRE(pclose(process) == 0);
+    fs::remove(path);
+
+    return output;
+}
+
+TEST_CASE("Deep nesting: make sure that the AST of a million nested conditionals is printed", "[deep-nesting]") {
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .astPrinter()
+            .debug(debugPhase)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = deeplyNestedCode()})));
+
+    // Beyond MAX_INDENTATION, the depth is printed instead of further tabs.
+    const auto innermost = std::string(MAX_INDENTATION, '\t') + "(1000000) <DecrementByte> 1:1000002\n";
+    REQUIRE(debugPhase->getValue().find(innermost) != std::string::npos);
+}
+
+TEST_CASE("Deep nesting: make sure that a million nested loops are run by every engine", "[deep-nesting]") {
+    REQUIRE(runDeeplyNested('i', 0) == "\x01");
+    REQUIRE(runDeeplyNested('b', 0) == "\x01");
+    REQUIRE(runDeeplyNested('b', 3) == "\x01");
+
+    if (Jit::isAvailable()) {
+        REQUIRE(runDeeplyNested('j', 2) == "\x01");
+    }
+}
+
+TEST_CASE("Deep nesting: make sure that a million nested loops are compiled", "[deep-nesting]") {
+    REQUIRE(runDeeplyNestedExecutable(false) == "\x01");
+    REQUIRE(runDeeplyNestedExecutable(true) == "\x01");
+}
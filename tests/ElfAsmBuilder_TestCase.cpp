@@ -0,0 +1,203 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <elf.h>
+#include <filesystem>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/AsmInstruction.h"
+#include "../src/CodeGen.h"
+#include "../src/ElfAsmBuilder.h"
+#include "../src/ElfWriter.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+#include "../src/Tape.h"
+
+using namespace goo;
+namespace fs = std::filesystem;
+
+/*
+ * These test cases make sure that the ElfAsmBuilder understands the operands produced by CodeGen and that the
+ * resulting files are valid. On x86-64 Linux, the executables are run and compared with the Interpreter.
+ */
+
+std::string buildElf(const std::string &code, const ElfType type) {
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .elfCodeGen(CodeGenConfig{.debugBuild = false}, type)
+            .debug(debugPhase);
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    return debugPhase->getValue();
+}
+
+/// Runs the executable and returns its output.
+std::string runExecutable(const std::string &code, const std::string &input,
+                          const CodeGenConfig &config = CodeGenConfig{.debugBuild = false}) {
+    const auto path = (fs::temp_directory_path() / "goo_elf_test").string();
+
+    Reporter reporter;
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .elfCodeGen(config, ELF_EXECUTABLE)
+            .elfWriter(ElfWriterConfig{.verbose = false, .executable = true, .outputFile = path});
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    const auto command = "printf '" + input + "' | " + path;
+    std::FILE *process = popen(command.c_str(), "r");
+    REQUIRE(process != nullptr);
+
+    std::string output;
+    for (int c = fgetc(process); c != EOF; c = fgetc(process)) {
+        output += static_cast<char>(c);
+    }
+
+    REQUIRE(pclose(process) == 0);
+    fs::remove(path);
+
+    return output;
+}
+
+std::string runInterpreterForElf(const std::string &code, const CellSemantics cellSemantics) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .interpreter(buffer, cellSemantics);
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    return buffer.str();
+}
+
+void testElfStmts(const std::string &code, const CellSemantics cellSemantics = CELLS_COMPAT) {
+#if defined(__x86_64__) && defined(__linux__)
+    const auto config = CodeGenConfig{.debugBuild = false, .cellSemantics = cellSemantics};
+    REQUIRE(runExecutable(code, "", config) == runInterpreterForElf(code, cellSemantics));
+#endif
+}
+
+TEST_CASE("ElfAsmBuilder: make sure that operands are parsed correctly", "[elf]") {
+    SymbolTable symbols;
+    AsmOperand operand;
+
+    REQUIRE(parseOperand("r8b", symbols, operand));
+    REQUIRE(operand.kind == OPERAND_REGISTER);
+    REQUIRE(operand.reg == R8);
+    REQUIRE(operand.size == 1);
+
+    REQUIRE(parseOperand("byte [rax + rbx]", symbols, operand));
+    REQUIRE(operand.kind == OPERAND_MEMORY);
+    REQUIRE(operand.size == 1);
+    REQUIRE(operand.mem.base == RAX);
+    REQUIRE(operand.mem.index == RBX);
+
+    REQUIRE(parseOperand("[rel tape]", symbols, operand));
+    REQUIRE(operand.kind == OPERAND_MEMORY);
+    REQUIRE(operand.mem.ripRelative);
+    REQUIRE(symbols.name(operand.symbol) == "tape");
+
+    REQUIRE(parseOperand("[tape + rbx]", symbols, operand));
+    REQUIRE(operand.mem.base == NO_REGISTER);
+    REQUIRE(operand.mem.index == RBX);
+    REQUIRE(symbols.name(operand.symbol) == "tape");
+
+    REQUIRE(parseOperand("byte 0", symbols, operand));
+    REQUIRE(operand.kind == OPERAND_IMMEDIATE);
+    REQUIRE(operand.size == 1);
+    REQUIRE(operand.imm == 0);
+
+    REQUIRE(parseOperand("29999", symbols, operand));
+    REQUIRE(operand.imm == 29999);
+
+    REQUIRE(parseOperand("loop1Exit", symbols, operand));
+    REQUIRE(operand.kind == OPERAND_SYMBOL);
+    REQUIRE(symbols.name(operand.symbol) == "loop1Exit");
+
+    REQUIRE_FALSE(parseOperand("byte [rax + ]", symbols, operand));
+    REQUIRE_FALSE(parseOperand("byte rax", symbols, operand));
+}
+
+TEST_CASE("ElfAsmBuilder: make sure that valid ELF headers are produced", "[elf]") {
+    const auto object = buildElf("+[->+<].", ELF_RELOCATABLE);
+    REQUIRE(object.size() > sizeof(Elf64_Ehdr));
+
+    Elf64_Ehdr header;
+    memcpy(&header, object.data(), sizeof(header));
+
+    REQUIRE(memcmp(header.e_ident, ELFMAG, SELFMAG) == 0);
+    REQUIRE(header.e_ident[EI_CLASS] == ELFCLASS64);
+    REQUIRE(header.e_type == ET_REL);
+    REQUIRE(header.e_machine == EM_X86_64);
+    REQUIRE(header.e_shnum > 0);
+    REQUIRE(header.e_shoff + header.e_shnum * sizeof(Elf64_Shdr) == object.size());
+
+    const auto executable = buildElf("+[->+<].", ELF_EXECUTABLE);
+    memcpy(&header, executable.data(), sizeof(header));
+
+    REQUIRE(header.e_type == ET_EXEC);
+    REQUIRE(header.e_entry != 0);
+    REQUIRE(header.e_phnum > 0);
+}
+
+TEST_CASE("ElfAsmBuilder: make sure that executables produce the same output as the Interpreter", "[elf]") {
+    testElfStmts("+.");
+    testElfStmts("++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.");
+    testElfStmts("-.--.>-----.");
+    testElfStmts("+++[>++<-]>.");
+    testElfStmts("+++[>+++[>++<-]<-]>>.");
+    testElfStmts("<.>>>>>>>>>-.");
+    testElfStmts("++++++++++[>++++++++++<-]>.");
+    testElfStmts(">+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>>+++++" + std::string(21, '<') + "[>]>.");
+    testElfStmts("+++++++>>>+>>+>>+>>+>>+>>+>>+>>+>>+>>+>><<[<<]<.");
+
+#if defined(__x86_64__) && defined(__linux__)
+    REQUIRE(runExecutable(",+.", "A") == "B");
+#endif
+}
+
+TEST_CASE("ElfAsmBuilder: make sure that wrap8 executables produce the same output as the Interpreter", "[elf]") {
+    testElfStmts("-.--.>-----.", CELLS_WRAP8);
+    testElfStmts("<-.>>>>>>>>>-.", CELLS_WRAP8);
+    testElfStmts("++++++++++[>+++++++++++++<-]>.", CELLS_WRAP8);
+    testElfStmts("-[>+++<-]>.", CELLS_WRAP8);
+    testElfStmts("+++[<+++>-]<.", CELLS_WRAP8);
+    testElfStmts("<[<]+[>]+.", CELLS_WRAP8);
+    testElfStmts("+[<]+.", CELLS_WRAP8);
+}
+
+TEST_CASE("ElfAsmBuilder: make sure that buffered I/O behaves like unbuffered I/O", "[elf]") {
+    // Prints 80,000 bytes, which exceeds the output buffer.
+    testElfStmts("++++++++[>++++++++++[>++++++++++[>++++++++++[>++++++++++[>.<-]<-]<-]<-]<-]");
+
+#if defined(__x86_64__) && defined(__linux__)
+    const auto unbuffered = CodeGenConfig{.debugBuild = false, .bufferedIo = false};
+
+    REQUIRE(runExecutable(",.,.,.", "abc") == "abc");
+    REQUIRE(runExecutable(",.,.,.", "abc", unbuffered) == "abc");
+    REQUIRE(runExecutable("+.,.", "") == "\x01\x01");
+    REQUIRE(runExecutable("+.,.", "", unbuffered) == "\x01\x01");
+#endif
+}
@@ -0,0 +1,65 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <filesystem>
+#include <fstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/Input.h"
+#include "../src/Parser.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+
+namespace fs = std::filesystem;
+
+/// Writes the code to a temporary file and returns its path.
+std::string writeSource(const std::string &name, const std::string &code) {
+    const auto path = (fs::temp_directory_path() / name).string();
+
+    std::ofstream ofs(path);
+    ofs << code;
+
+    return path;
+}
+
+TEST_CASE("Input: make sure that mapped files are passed on as source", "[input]") {
+    const auto path = writeSource("goo_mmap_input_test", "+[->+<]\n.");
+
+    Reporter reporter;
+    const auto sourcePhase = std::make_shared<DebugPhase>(SOURCE, reporter);
+    const auto stmtPhase = std::make_shared<DebugPhase>(STMT, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.mmapFileInput()
+            .debug(sourcePhase)
+            .streamingParser(false)
+            .debug(stmtPhase)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<FilePayload>(FilePayload{.filepath = path})));
+    REQUIRE(sourcePhase->getValue() == "+[->+<]\n.");
+    REQUIRE(stmtPhase->getStmts().size() == 3);
+    REQUIRE(stmtPhase->getStmts()[2]->line == 2);
+
+    fs::remove(path);
+}
+
+TEST_CASE("Input: make sure that empty and missing files are handled", "[input]") {
+    const auto path = writeSource("goo_mmap_empty_test", "");
+
+    const auto file = MappedFile::open(path);
+    REQUIRE(file != nullptr);
+    REQUIRE(file->content().empty());
+
+    fs::remove(path);
+
+    REQUIRE(MappedFile::open(path) == nullptr);
+
+    Reporter reporter;
+    MmapFileInput input(reporter);
+    REQUIRE(input.run(std::make_shared<FilePayload>(FilePayload{.filepath = path})) == nullptr);
+    REQUIRE(reporter.hasError());
+}
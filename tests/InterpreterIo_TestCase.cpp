@@ -0,0 +1,77 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <sstream>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/InterpreterIo.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+
+/*
+ * These test cases make sure that the InterpreterIo buffers output until it is flushed and reads input in blocks.
+ */
+
+TEST_CASE("InterpreterIo: make sure that output is only written when flushed or full", "[io]") {
+    std::stringstream out;
+    InterpreterIo io(out);
+
+    io.write('a');
+    io.write('\0');
+    REQUIRE(out.str().empty());
+
+    io.flush();
+    REQUIRE(out.str() == std::string("a\0", 2));
+
+    for (std::size_t idx = 0; idx <= InterpreterIo::BUFFER_SIZE; idx++) {
+        io.write('b');
+    }
+
+    REQUIRE(out.str().size() == 2 + InterpreterIo::BUFFER_SIZE);
+
+    io.flush();
+    REQUIRE(out.str().size() == 3 + InterpreterIo::BUFFER_SIZE);
+}
+
+TEST_CASE("InterpreterIo: make sure that input is read in blocks and output is flushed before", "[io]") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    REQUIRE(write(fds[1], "xy", 2) == 2);
+
+    std::stringstream out;
+    InterpreterIo io(out, fds[0]);
+    io.write('>');
+
+    char byte = 0;
+    REQUIRE(io.read(byte) == READ_OK);
+    REQUIRE(byte == 'x');
+    REQUIRE(out.str() == ">");
+
+    close(fds[1]);
+
+    REQUIRE(io.read(byte) == READ_OK);
+    REQUIRE(byte == 'y');
+    REQUIRE(io.read(byte) == READ_EOF);
+    REQUIRE(byte == 'y');
+
+    close(fds[0]);
+}
+
+TEST_CASE("InterpreterIo: make sure that the interpreter prints raw bytes", "[io]") {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .interpreter(buffer)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = "++++++++[>++++++++<-]>+.+."})));
+    REQUIRE(buffer.str() == "AB");
+}
@@ -0,0 +1,100 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../src/BytecodeInterpreter.h"
+#include "../src/Interpreter.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+
+/*
+ * Compares the throughput of the tree-walking Interpreter with the BytecodeInterpreter. The benchmarks are hidden,
+ * run them explicitly with: unit_tests "[benchmark]"
+ */
+
+/// Temporarily replaces stdin with a file containing `input`, as both interpreters read directly from STDIN_FILENO.
+class StdinReplacement {
+    int savedStdin;
+    std::string path;
+
+public:
+    explicit StdinReplacement(const std::string &input) {
+        char tmpPath[] = "/tmp/goo_benchXXXXXX";
+        const int fd = mkstemp(tmpPath);
+        path = tmpPath;
+
+        write(fd, input.data(), input.size());
+        close(fd);
+
+        savedStdin = dup(STDIN_FILENO);
+        const int inputFd = open(path.c_str(), O_RDONLY);
+        dup2(inputFd, STDIN_FILENO);
+        close(inputFd);
+    }
+
+    ~StdinReplacement() {
+        dup2(savedStdin, STDIN_FILENO);
+        close(savedStdin);
+        std::remove(path.c_str());
+    }
+
+    /// Rewinds stdin, so that each benchmark run reads the same input.
+    static void rewind() {
+        lseek(STDIN_FILENO, 0, SEEK_SET);
+    }
+};
+
+std::shared_ptr<StmtPayload> optimizedExample(const std::string &filename) {
+    Reporter reporter;
+    const auto debugPhase = std::make_shared<DebugPhase>(STMT, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.fileInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .debug(debugPhase)
+            .build();
+
+    const auto path = std::string(GOO_EXAMPLES_DIR) + "/" + filename;
+    REQUIRE(pipeline->execute(std::make_shared<FilePayload>(FilePayload{.filepath = path})));
+
+    return debugPhase->getStmtPayload();
+}
+
+TEST_CASE("Benchmark: tree-walking interpreter vs. bytecode interpreter on c-tree.bf", "[.][benchmark]") {
+    const auto payload = optimizedExample("c-tree.bf");
+
+    // c-tree.bf reads the height of the tree as its first input.
+    StdinReplacement stdinReplacement("9\n");
+
+    BENCHMARK("Interpreter") {
+        StdinReplacement::rewind();
+
+        Reporter reporter;
+        std::stringstream out;
+        Interpreter interpreter(reporter, out);
+        interpreter.run(payload);
+        return out.str().size();
+    };
+
+    BENCHMARK("BytecodeInterpreter") {
+        StdinReplacement::rewind();
+
+        Reporter reporter;
+        std::stringstream out;
+        BytecodeInterpreter interpreter(reporter, out);
+        interpreter.run(payload);
+        return out.str().size();
+    };
+}
@@ -0,0 +1,83 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/AsmBuilder.h"
+#include "../src/CodeGen.h"
+#include "../src/IrAsmBuilder.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+
+/*
+ * These test cases make sure that the IrAsmBuilder renders exactly the same assembler code as the StringAsmBuilder.
+ */
+
+std::string generateWith(const std::shared_ptr<AsmBuilder> &asmBuilder, const std::string &code, const bool optimize,
+                         const bool debugBuild) {
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STMT, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser();
+
+    if (optimize) {
+        builder.optimizer();
+    }
+
+    const auto pipeline = builder.debug(debugPhase).build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    CodeGen codeGen(CodeGenConfig{.debugBuild = debugBuild}, asmBuilder, reporter);
+    const auto payload = codeGen.run(debugPhase->getStmtPayload());
+
+    REQUIRE_FALSE(reporter.hasError());
+    return std::static_pointer_cast<StringPayload>(payload)->value;
+}
+
+void testIrStmts(const std::string &code) {
+    for (const auto optimize: {false, true}) {
+        for (const auto debugBuild: {false, true}) {
+            Reporter reporter;
+
+            const auto expected = generateWith(std::make_shared<StringAsmBuilder>(), code, optimize, debugBuild);
+            const auto actual = generateWith(std::make_shared<IrAsmBuilder>(reporter), code, optimize, debugBuild);
+
+            REQUIRE(expected == actual);
+        }
+    }
+}
+
+TEST_CASE("IrAsmBuilder: make sure that the same code as with StringAsmBuilder is rendered", "[ir]") {
+    testIrStmts("+.");
+    testIrStmts("+++++-->>><<,.#");
+    testIrStmts("-.--.>-----.");
+    testIrStmts("+++[>++<-]>.");
+    testIrStmts("+++[>+++[>++<-]<-]>>.");
+    testIrStmts("++++[->+++<]>[-]<<<.");
+    testIrStmts("++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.");
+}
+
+TEST_CASE("IrAsmBuilder: make sure that labels are interned", "[ir]") {
+    Reporter reporter;
+    IrAsmBuilder builder(reporter);
+
+    builder.label("loop1")
+            .cmp("byte [rax + rbx]", "byte 0")
+            .jle("loop1Exit")
+            .jmp("loop1")
+            .label("loop1Exit");
+
+    const auto &instructions = builder.getInstructions();
+    const auto &last = instructions[instructions.size() - 1];
+
+    REQUIRE(instructions[instructions.size() - 2].dest.symbol == instructions[instructions.size() - 5].dest.symbol);
+    REQUIRE(last.dest.symbol == instructions[instructions.size() - 3].dest.symbol);
+    REQUIRE(builder.getSymbols().name(last.dest.symbol) == "loop1Exit");
+    REQUIRE_FALSE(reporter.hasError());
+}
@@ -0,0 +1,128 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/Jit.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+#include "../src/Tape.h"
+
+using namespace goo;
+
+/*
+ * These test cases make sure that the JIT produces the same output and warnings as the Interpreter. They are skipped
+ * on platforms that don't support the JIT.
+ */
+
+struct ExecutionResult {
+    std::string output;
+    bool hasWarnings;
+};
+
+ExecutionResult runWithJit(const std::string &code, const bool jit, const CellSemantics cellSemantics) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer();
+
+    if (jit) {
+        builder.jit(buffer, cellSemantics);
+    } else {
+        builder.interpreter(buffer, cellSemantics);
+    }
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    return ExecutionResult{.output = buffer.str(), .hasWarnings = reporter.hasWarnings()};
+}
+
+void testJitStmts(const std::string &code, const CellSemantics cellSemantics = CELLS_COMPAT) {
+    if (!Jit::isAvailable()) {
+        return;
+    }
+
+    const auto interpreted = runWithJit(code, false, cellSemantics);
+    const auto compiled = runWithJit(code, true, cellSemantics);
+
+    REQUIRE(interpreted.output == compiled.output);
+    REQUIRE(interpreted.hasWarnings == compiled.hasWarnings);
+}
+
+TEST_CASE("JIT: make sure that simple statements are processed correctly", "[jit]") {
+    testJitStmts("+.");
+    testJitStmts("++-.");
+    testJitStmts(">+<.");
+    testJitStmts("-.");
+    testJitStmts("--------------------------------------------------------------------------------------------------.");
+}
+
+TEST_CASE("JIT: make sure that conditionals are processed correctly", "[jit]") {
+    testJitStmts("[+].");
+    testJitStmts("+++[>++<-]>.");
+    testJitStmts("++[>+++[>++<-]<-]>>.");
+    testJitStmts("++++[>++++[>++++<-]<-]>>.");
+}
+
+TEST_CASE("JIT: make sure that optimized statements are processed correctly", "[jit]") {
+    testJitStmts("++[>++++<-]>.");
+    testJitStmts("+[->+<]>.");
+    testJitStmts(">+[-<+>]<.");
+    testJitStmts("++++.[-]+++.");
+}
+
+TEST_CASE("JIT: make sure that linear loops are processed correctly", "[jit]") {
+    testJitStmts("+++[->+>++>+++<<<]>.>.>.");
+    testJitStmts("+++[->-<]>.");
+    testJitStmts("-[->+++<]>.", CELLS_WRAP8);
+    testJitStmts("+++[->+>++>+++<<<]>.>.>.", CELLS_WRAP8);
+}
+
+TEST_CASE("JIT: make sure that scans are processed correctly", "[jit]") {
+    testJitStmts(">+>+>+<<[>]+++.");
+    testJitStmts("+++>>>+>>+>>+<<[<<]<.");
+    testJitStmts("+[<]+.");
+    testJitStmts("<[<]+[>]+.");
+    testJitStmts("<[<]+[>]+.", CELLS_WRAP8);
+    testJitStmts("+>>+<<[>>>]+.", CELLS_WRAP8);
+}
+
+TEST_CASE("JIT: make sure that the tape pointer wraps around with a warning", "[jit]") {
+    testJitStmts("<+.>.");
+    testJitStmts("<<<+>>>.");
+}
+
+TEST_CASE("JIT: make sure that wrap8 cells are processed correctly", "[jit]") {
+    testJitStmts("-.", CELLS_WRAP8);
+    testJitStmts("<-.>>+.", CELLS_WRAP8);
+    testJitStmts("++++++++++[>+++++++++++++<-]>.", CELLS_WRAP8);
+    testJitStmts("-[>+++<-]>.", CELLS_WRAP8);
+    testJitStmts("+++[<+++>-]<.", CELLS_WRAP8);
+}
+
+TEST_CASE("JIT: make sure that the tape is kept between runs", "[jit]") {
+    if (!Jit::isAvailable()) {
+        return;
+    }
+
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .jit(buffer)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = "+++>++"})));
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = ".<."})));
+    REQUIRE(buffer.str() == "\x02\x03");
+}
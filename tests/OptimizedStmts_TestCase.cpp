@@ -90,3 +90,26 @@ TEST_CASE("Optimizer: make sure that statements are not grouped when mixed", "[o
     testStmts("-<->-<-.");
     testStmts("+>->+>+.");
 }
+
+TEST_CASE("Optimizer: make sure that deferred pointer movements are optimized correctly", "[optimizer]") {
+    testStmts(">+>++>+++<<.>.>.");
+    testStmts(">>+++<<->>.<<.");
+    testStmts("+>++[<+>-]<.>>+++[>++<-]>.");
+    testStmts("++[>+>++<<-]>.>.");
+    testStmts(">>,.<[-]+.");
+}
+
+TEST_CASE("Optimizer: make sure that linear loops are optimized correctly", "[optimizer]") {
+    testStmts("+++[->+>++>+++<<<]>.>.>.");
+    testStmts(">++[>>+<<<+>-]>.<.>>.");
+    testStmts(">++++[-<->]<.");
+}
+
+TEST_CASE("Optimizer: make sure that scans are optimized correctly", "[optimizer]") {
+    testStmts(">+>+>+<<[>]+++.");
+    testStmts(">+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>>+++++" + std::string(21, '<') + "[>]>.");
+    testStmts(">+>>>+>>>+>>>+>>>+>>>+>>>+>>>+>>>>+++++" + std::string(25, '<') + "[>>>]>.");
+    testStmts("+++++++>>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+><[<]<.");
+    testStmts("+++++++>>>+>>+>>+>>+>>+>>+>>+>>+>>+>>+>><<[<<]<.");
+    testStmts("+[<]+.");
+}
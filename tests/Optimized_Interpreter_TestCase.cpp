@@ -93,3 +93,26 @@ TEST_CASE("Interpreter-Optimizer: make sure that statements are not grouped when
     testAssemblerInterpreterStmts("-<->-<-.");
     testAssemblerInterpreterStmts("+>->+>+.");
 }
+
+TEST_CASE("Interpreter-Optimizer: make sure that deferred pointer movements are processed correctly", "[interpreter-optimizer]") {
+    testAssemblerInterpreterStmts(">+>++>+++<<.>.>.");
+    testAssemblerInterpreterStmts("++[>+>++<<-]>.>.");
+    testAssemblerInterpreterStmts(">>+++[<++>-]<[-]+.");
+}
+
+TEST_CASE("Interpreter-Optimizer: make sure that linear loops are processed correctly", "[interpreter-optimizer]") {
+    testAssemblerInterpreterStmts("+++[->+>++>+++<<<]>.>.>.");
+    testAssemblerInterpreterStmts(">++[>>+<<<+>-]>.<.>>.");
+    testAssemblerInterpreterStmts("+++++++++++++++[->+++++++++<]>.");
+}
+
+TEST_CASE("Interpreter-Optimizer: make sure that scans are processed correctly", "[interpreter-optimizer]") {
+    testAssemblerInterpreterStmts(">+>+>+<<[>]+++.");
+    testAssemblerInterpreterStmts(">+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>>+++++" + std::string(21, '<') + "[>]>.");
+    testAssemblerInterpreterStmts(">+>>>+>>>+>>>+>>>+>>>+>>>+>>>+>>>>+++++" + std::string(25, '<') + "[>>>]>.");
+    testAssemblerInterpreterStmts("+++++++>>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+>+><[<]<.");
+    testAssemblerInterpreterStmts("+++++++>>>+>>+>>+>>+>>+>>+>>+>>+>>+>>+>><<[<<]<.");
+    testAssemblerInterpreterStmts("+" + std::string(17, '>') + "+" + std::string(17, '<') + "[" + std::string(17, '>') +
+                                  "]+++.");
+    testAssemblerInterpreterStmts("+[<]+.");
+}
@@ -2,11 +2,13 @@
 // Created by michael on 16.06.25.
 //
 
+#include <sstream>
 #include <catch2/catch_test_macros.hpp>
 
 #include "../src/Optimizer.h"
 #include "../src/Parser.h"
 #include "../src/Pipeline.h"
+#include "../src/Tape.h"
 
 using namespace goo;
 
@@ -16,7 +18,7 @@ using namespace goo;
  * into a list of statements.
  */
 
-void recursivePatternMatch(const StmtVector &stmts, const std::vector<std::pair<TokenType, int> > &expected, int &idx);
+void recursivePatternMatch(const StmtSpan stmts, const std::vector<std::pair<TokenType, int> > &expected, int &idx);
 
 std::shared_ptr<Payload> mockStmts(const std::string &code) {
     Reporter reporter;
@@ -33,7 +35,7 @@ std::shared_ptr<Payload> mockStmts(const std::string &code) {
     bool success = pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code}));
     REQUIRE(success);
 
-    return std::make_shared<StmtPayload>(StmtPayload { .stmts = debugPhase->getStmts() });
+    return debugPhase->getStmtPayload();
 }
 
 void checkGroupings(const std::string &inputCode, const std::vector<std::pair<TokenType, int> > &expected) {
@@ -49,21 +51,23 @@ void checkGroupings(const std::string &inputCode, const std::vector<std::pair<To
     REQUIRE(idx == expected.size());
 }
 
-void recursivePatternMatch(const StmtVector &stmts, const std::vector<std::pair<TokenType, int> > &expected, int &expectedIdx) {
+void recursivePatternMatch(const StmtSpan stmts, const std::vector<std::pair<TokenType, int> > &expected, int &expectedIdx) {
     for (int idx = 0, expIdx = expectedIdx; idx < stmts.size() && idx < expected.size(); idx++, expIdx = expectedIdx) {
         REQUIRE(stmts[idx]->type == expected[expIdx].first);
 
         int count = -1;
         if (stmts[idx]->type == INC_BYTE) {
-            count = std::static_pointer_cast<IncrementByte>(stmts[0])->count;
+            count = static_cast<IncrementByte *>(stmts[idx])->count;
         } else if (stmts[idx]->type == DEC_BYTE) {
-            count = std::static_pointer_cast<DecrementByte>(stmts[0])->count;
+            count = static_cast<DecrementByte *>(stmts[idx])->count;
         } else if (stmts[idx]->type == INC_PTR) {
-            count = std::static_pointer_cast<IncrementPtr>(stmts[0])->count;
+            count = static_cast<IncrementPtr *>(stmts[idx])->count;
         } else if (stmts[idx]->type == DEC_PTR) {
-            count = std::static_pointer_cast<DecrementPtr>(stmts[0])->count;
+            count = static_cast<DecrementPtr *>(stmts[idx])->count;
+        } else if (stmts[idx]->type == SCAN) {
+            count = static_cast<Scan *>(stmts[idx])->stride;
         } else if (stmts[idx]->type == IF) {
-            const auto &conditional = std::static_pointer_cast<Conditional>(stmts[idx]);
+            const auto &conditional = static_cast<Conditional *>(stmts[idx]);
 
             if (!conditional->stmts.empty()) {
                 recursivePatternMatch(conditional->stmts, expected, ++expectedIdx);
@@ -89,9 +93,10 @@ TEST_CASE("Optimizer: make sure that statements are correctly grouped", "[optimi
 
 TEST_CASE("Optimizer: make sure that non-groupable statements are not grouped", "[optimizer]") {
     checkGroupings("+,+", {{INC_BYTE, 1}, {IN, 1}, {INC_BYTE, 1}});
-    checkGroupings("-<-", {{DEC_BYTE, 1}, {DEC_PTR, 1}, {DEC_BYTE, 1}});
-    checkGroupings(">+>", {{INC_PTR, 1}, {INC_BYTE, 1}, {INC_PTR, 1}});
-    checkGroupings("<-<", {{DEC_PTR, 1}, {DEC_BYTE, 1}, {DEC_PTR, 1}});
+    // The pointer movements are deferred by the OffsetPass, therefor they are moved to the end.
+    checkGroupings("-<-", {{DEC_BYTE, 1}, {DEC_BYTE, 1}, {DEC_PTR, 1}});
+    checkGroupings(">+>", {{INC_BYTE, 1}, {INC_PTR, 2}});
+    checkGroupings("<-<", {{DEC_BYTE, 1}, {DEC_PTR, 2}});
     checkGroupings(",,", {{IN, 1}, {IN, 1}});
     checkGroupings("..", {{OUT, 1}, {OUT, 1}});
     checkGroupings("[[]]", {});
@@ -99,5 +104,294 @@ TEST_CASE("Optimizer: make sure that non-groupable statements are not grouped",
 
 TEST_CASE("Optimizer: make sure that conditionals are correctly grouped", "[optimizer]") {
     checkGroupings("[++]", {{IF, 1}, {INC_BYTE, 2}});
-    checkGroupings("[[>>]]", {{IF, 1}, {IF, 1}, {INC_PTR, 2}});
+    checkGroupings("[[>>]]", {{IF, 1}, {SCAN, 2}});
+}
+
+/// Runs the optimizer and compares the type of each top-level statement, paired with the offset relative to the tape
+/// pointer for statements that address a byte, or the count of pointer movements.
+void checkOffsets(const std::string &inputCode, const std::vector<std::pair<TokenType, int> > &expected) {
+    Reporter reporter;
+    Optimizer optimizer(reporter);
+    const auto result = std::static_pointer_cast<StmtPayload>(optimizer.run(mockStmts(inputCode)));
+    REQUIRE(result != nullptr);
+
+    std::vector<std::pair<TokenType, int> > offsets;
+
+    for (const auto &stmt: result->stmts) {
+        int value = 0;
+
+        switch (stmt->type) {
+            case INC_BYTE:
+                value = static_cast<IncrementByte *>(stmt)->offset;
+                break;
+            case DEC_BYTE:
+                value = static_cast<DecrementByte *>(stmt)->offset;
+                break;
+            case OUT:
+                value = static_cast<Output *>(stmt)->offset;
+                break;
+            case IN:
+                value = static_cast<Input *>(stmt)->offset;
+                break;
+            case RESET:
+                value = static_cast<Reset *>(stmt)->tapePtrOffset;
+                break;
+            case INC_PTR:
+                value = static_cast<IncrementPtr *>(stmt)->count;
+                break;
+            case DEC_PTR:
+                value = static_cast<DecrementPtr *>(stmt)->count;
+                break;
+            case SCAN:
+                value = static_cast<Scan *>(stmt)->stride;
+                break;
+            default:
+                break;
+        }
+
+        offsets.emplace_back(stmt->type, value);
+    }
+
+    REQUIRE(offsets == expected);
+}
+
+TEST_CASE("Optimizer: make sure that pointer movements are folded into offsets", "[optimizer]") {
+    checkOffsets(">+>+>+<<<", {{INC_BYTE, 1}, {INC_BYTE, 2}, {INC_BYTE, 3}});
+    checkOffsets(">.<<,>>>", {{OUT, 1}, {IN, -1}, {INC_PTR, 2}});
+    checkOffsets("<<--+>[-]", {{DEC_BYTE, -2}, {RESET, -1}, {DEC_PTR, 1}});
+}
+
+TEST_CASE("Optimizer: make sure that pointer movements are applied before conditionals", "[optimizer]") {
+    // The conditional checks the byte at the tape pointer, therefor the movement must be applied before.
+    checkOffsets(">+>[>+<<]", {{INC_BYTE, 1}, {INC_PTR, 2}, {IF, 0}});
+    checkOffsets(">>[->+<]<+", {{INC_PTR, 2}, {LINEAR_LOOP, 0}, {INC_BYTE, -1}, {DEC_PTR, 1}});
+
+    // The body of the conditional is folded separately and must end at its own tape pointer.
+    Reporter reporter;
+    Optimizer optimizer(reporter);
+    const auto result = std::static_pointer_cast<StmtPayload>(optimizer.run(mockStmts("[>+>+<]")));
+
+    const auto conditional = static_cast<Conditional *>(result->stmts[0]);
+    REQUIRE(conditional->stmts.size() == 3);
+    REQUIRE(static_cast<IncrementByte *>(conditional->stmts[0])->offset == 1);
+    REQUIRE(static_cast<IncrementByte *>(conditional->stmts[1])->offset == 2);
+    REQUIRE(conditional->stmts[2]->type == INC_PTR);
+}
+
+TEST_CASE("Optimizer: make sure that offsets don't exceed the padding of the tape", "[optimizer]") {
+    checkOffsets(std::string(TAPE_PADDING + 1, '>') + "+", {{INC_PTR, TAPE_PADDING + 1}, {INC_BYTE, 0}});
+}
+
+/// Runs the optimizer and returns the targets of the linear loop it produces for `inputCode`, if there is any.
+bool optimizeLinearLoop(const std::string &inputCode, std::vector<LinearTarget> &targets) {
+    Reporter reporter;
+    Optimizer optimizer(reporter);
+    const auto result = std::static_pointer_cast<StmtPayload>(optimizer.run(mockStmts(inputCode)));
+    REQUIRE(result->stmts.size() == 1);
+
+    if (result->stmts[0]->type != LINEAR_LOOP) {
+        return false;
+    }
+
+    targets = static_cast<LinearLoop *>(result->stmts[0])->targets;
+    return true;
+}
+
+TEST_CASE("Optimizer: make sure that linear loops are detected", "[optimizer]") {
+    std::vector<LinearTarget> targets;
+
+    REQUIRE(optimizeLinearLoop("[->+<]", targets));
+    REQUIRE(targets == std::vector<LinearTarget>{{1, 1}});
+
+    REQUIRE(optimizeLinearLoop("[->+>++>+++<<<]", targets));
+    REQUIRE(targets == std::vector<LinearTarget>{{1, 1}, {2, 2}, {3, 3}});
+
+    REQUIRE(optimizeLinearLoop("[>>+<<<--<+>>-]", targets));
+    REQUIRE(targets == std::vector<LinearTarget>{{-2, 1}, {-1, -2}, {2, 1}});
+}
+
+TEST_CASE("Optimizer: make sure that non-linear loops are kept", "[optimizer]") {
+    std::vector<LinearTarget> targets;
+
+    REQUIRE_FALSE(optimizeLinearLoop("[->+<<]", targets));
+    REQUIRE_FALSE(optimizeLinearLoop("[-->+<]", targets));
+    REQUIRE_FALSE(optimizeLinearLoop("[+>+<]", targets));
+    REQUIRE_FALSE(optimizeLinearLoop("[->.<]", targets));
+    REQUIRE_FALSE(optimizeLinearLoop("[->[-]<]", targets));
+}
+
+TEST_CASE("Optimizer: make sure that scans are detected", "[optimizer]") {
+    checkOffsets("[>]", {{SCAN, 1}});
+    checkOffsets("[<<<]", {{SCAN, -3}});
+    checkOffsets("[>><]", {{SCAN, 1}});
+    checkOffsets(">+[<]+", {{INC_BYTE, 1}, {INC_PTR, 1}, {SCAN, -1}, {INC_BYTE, 0}});
+    checkOffsets("[[>>>>]<]", {{IF, 0}});
+
+    // Loops that don't only move the tape pointer are kept.
+    checkOffsets("[>+]", {{IF, 0}});
+    checkOffsets("[>,]", {{IF, 0}});
+}
+
+/// Runs the optimizer with the given config and returns the payload of the optimized statements.
+std::shared_ptr<StmtPayload> optimizeWith(const std::string &inputCode, const OptimizerConfig &config) {
+    Reporter reporter;
+    Optimizer optimizer(config, reporter);
+    const auto result = std::static_pointer_cast<StmtPayload>(optimizer.run(mockStmts(inputCode)));
+    REQUIRE(!reporter.hasError());
+
+    return result;
+}
+
+/// Runs the code with the interpreter, optimized with the given config, and returns its output.
+std::string interpretOptimized(const std::string &code, const OptimizerConfig &config) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer(config)
+            .interpreter(buffer)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+    return buffer.str();
+}
+
+TEST_CASE("Optimizer: make sure that the optimization level selects the passes", "[optimizer]") {
+    REQUIRE(optimizeWith("+>+", OptimizerConfig{.level = 0})->stmts.size() == 3);
+
+    // Without the OffsetPass, pointer movements remain where they are.
+    const auto payload = optimizeWith("[-]++>>+", OptimizerConfig{.level = 1});
+    const auto &stmts = payload->stmts;
+    REQUIRE(stmts.size() == 3);
+    REQUIRE(stmts[0]->type == RESET);
+    REQUIRE(static_cast<Reset *>(stmts[0])->initialValue == 2);
+    REQUIRE(stmts[1]->type == INC_PTR);
+    REQUIRE(stmts[2]->type == INC_BYTE);
+
+    REQUIRE(Optimizer::passNames(2) == std::vector<std::string>{"group", "reset", "linear-loop", "scan", "offset"});
+    REQUIRE(Optimizer::passNames(3) == Optimizer::passNames(2));
+}
+
+TEST_CASE("Optimizer: make sure that passes can be selected by name", "[optimizer]") {
+    // Without grouping, the loop consists of two pointer movements and therefor isn't a scan.
+    REQUIRE(optimizeWith("[>>]", OptimizerConfig{.passes = {"scan"}})->stmts[0]->type == IF);
+    REQUIRE(optimizeWith("[>>]", OptimizerConfig{.passes = {"group", "scan"}})->stmts[0]->type == SCAN);
+
+    Reporter reporter;
+    Optimizer optimizer(OptimizerConfig{.passes = {"group", "unknown"}}, reporter);
+    auto _ = optimizer.run(mockStmts("+"));
+    REQUIRE(reporter.hasError());
+}
+
+TEST_CASE("Optimizer: make sure that passes accept statements that are addressed by offset", "[optimizer]") {
+    // Each of these passes runs after the OffsetPass, as it happens when the passes are run repeatedly.
+    const auto groupedPayload = optimizeWith(">+<+", OptimizerConfig{.passes = {"group", "offset", "group"}});
+    const auto &grouped = groupedPayload->stmts;
+    REQUIRE(grouped.size() == 2);
+    REQUIRE(static_cast<IncrementByte *>(grouped[0])->offset == 1);
+    REQUIRE(static_cast<IncrementByte *>(grouped[1])->offset == 0);
+
+    REQUIRE(optimizeWith("[>-<]", OptimizerConfig{.passes = {"group", "offset", "reset"}})->stmts[0]->type == IF);
+    REQUIRE(optimizeWith("[-]>+", OptimizerConfig{.passes = {"group", "offset", "reset"}})->stmts.size() == 3);
+
+    const auto linearLoopPayload = optimizeWith("[->+>++<<]",
+                                                OptimizerConfig{.passes = {"group", "offset", "linear-loop"}});
+    const auto &linearLoop = linearLoopPayload->stmts;
+    REQUIRE(linearLoop[0]->type == LINEAR_LOOP);
+    REQUIRE(static_cast<LinearLoop *>(linearLoop[0])->targets == std::vector<LinearTarget>{{1, 1}, {2, 2}});
+
+    const auto shiftedPayload = optimizeWith(">.>+<<", OptimizerConfig{.passes = {"group", "offset", "offset"}});
+    const auto &shifted = shiftedPayload->stmts;
+    REQUIRE(shifted.size() == 2);
+    REQUIRE(static_cast<Output *>(shifted[0])->offset == 1);
+    REQUIRE(static_cast<IncrementByte *>(shifted[1])->offset == 2);
+}
+
+TEST_CASE("Optimizer: make sure that the passes are run until they reach a fixed point", "[optimizer]") {
+    Reporter reporter;
+    Optimizer optimizer(OptimizerConfig{.level = 3}, reporter);
+    const auto result = std::static_pointer_cast<StmtPayload>(optimizer.run(mockStmts(">+<[->+<]>[<+>-]<.")));
+
+    // The second iteration doesn't change anything, therefor there is no third one.
+    REQUIRE(optimizer.getIterations() == 2);
+    REQUIRE(optimizer.getStats().size() == 5);
+    REQUIRE(optimizer.getStats()[0].runs == 2);
+
+    const std::vector<std::string> programs = {
+        "++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.",
+        "+++[->+>++>+++<<<]>.>.>.[-]++.",
+        ">+>+>+<<[>]+++.<[<]>."
+    };
+
+    for (const auto &program: programs) {
+        REQUIRE(interpretOptimized(program, OptimizerConfig{.level = 3}) ==
+                interpretOptimized(program, OptimizerConfig{.level = 0}));
+    }
+}
+
+TEST_CASE("Optimizer: make sure that statistics are collected for each pass", "[optimizer]") {
+    std::stringstream stats;
+
+    Reporter reporter;
+    Optimizer optimizer(OptimizerConfig{.passes = {"group", "reset"}, .statsOut = &stats}, reporter);
+    auto _ = optimizer.run(mockStmts("+++[-]"));
+
+    REQUIRE(optimizer.getStats()[0].name == "group");
+    REQUIRE(optimizer.getStats()[0].stmtsBefore == 5);
+    REQUIRE(optimizer.getStats()[0].stmtsAfter == 3);
+    REQUIRE(optimizer.getStats()[1].stmtsBefore == 3);
+    REQUIRE(optimizer.getStats()[1].stmtsAfter == 2);
+
+    REQUIRE(stats.str().find("Optimizer: 1 iteration(s)") != std::string::npos);
+    REQUIRE(stats.str().find("  group: 1 run(s), ") != std::string::npos);
+    REQUIRE(stats.str().find("5 -> 3 statements") != std::string::npos);
+}
+
+TEST_CASE("Optimizer: make sure that statistics are headed by the file they belong to", "[optimizer]") {
+    std::stringstream stats;
+
+    Reporter reporter;
+    Optimizer optimizer(OptimizerConfig{.passes = {"group"}, .statsOut = &stats, .statsFile = "test.bf"}, reporter);
+    auto _ = optimizer.run(mockStmts("+++"));
+
+    REQUIRE(stats.str().starts_with("test.bf:\nOptimizer: 1 iteration(s)\n  group: 1 run(s), "));
+}
+
+TEST_CASE("Optimizer: make sure that passes report whether they changed anything", "[optimizer]") {
+    const auto payload = mockStmts(">+<[->+<]>[<+>-]<.[>>]");
+    const auto stmtPayload = std::static_pointer_cast<StmtPayload>(payload);
+    auto &arena = *stmtPayload->arena;
+
+    for (const auto &name: Optimizer::passNames(3)) {
+        const auto pass = Optimizer::createPass(name);
+
+        StmtVector stmts = stmtPayload->stmts;
+        pass->rewrite(stmts, arena);
+
+        // A pass that already ran has nothing left to rewrite in its own output.
+        REQUIRE_FALSE(pass->rewrite(stmts, arena));
+    }
+
+    StmtVector stmts = {};
+    REQUIRE_FALSE(GroupPass().rewrite(stmts, arena));
+}
+
+TEST_CASE("Optimizer: make sure that untouched conditionals are shared", "[optimizer]") {
+    const auto payload = std::static_pointer_cast<StmtPayload>(mockStmts("++[.]"));
+    auto &arena = *payload->arena;
+
+    StmtVector stmts = payload->stmts;
+    REQUIRE(GroupPass().rewrite(stmts, arena));
+    REQUIRE(stmts.size() == 2);
+    REQUIRE(stmts[1] == payload->stmts[2]);
+
+    // Running a pass leaves the original statements untouched, while nested changes create a new conditional.
+    const auto nested = std::static_pointer_cast<StmtPayload>(mockStmts("[++.]"));
+    const auto grouped = GroupPass().run(nested->stmts, *nested->arena);
+    REQUIRE(grouped[0] != nested->stmts[0]);
+    REQUIRE(static_cast<Conditional *>(grouped[0])->stmts.size() == 2);
+    REQUIRE(static_cast<Conditional *>(nested->stmts[0])->stmts.size() == 3);
 }
@@ -8,7 +8,8 @@
 
 using namespace goo;
 
-std::vector<std::shared_ptr<Stmt>> parse(const std::vector<TokenType> &input) {
+/// Parses the tokens and returns the payload, which keeps the statements alive.
+std::shared_ptr<StmtPayload> parse(const std::vector<TokenType> &input) {
     std::vector<std::shared_ptr<Token>> tokens;
     for (const auto &type : input) {
         tokens.emplace_back(new Token(type, 0, 0));
@@ -22,11 +23,12 @@ std::vector<std::shared_ptr<Stmt>> parse(const std::vector<TokenType> &input) {
 
     REQUIRE(result != nullptr);
 
-    return result->stmts;
+    return result;
 }
 
 void checkStatementSequence(const std::vector<TokenType> &input, const std::vector<TokenType> &expected) {
-    const auto result = parse(input);
+    const auto payload = parse(input);
+    const auto &result = payload->stmts;
 
     REQUIRE(result.size() == expected.size());
 
@@ -75,21 +77,43 @@ TEST_CASE("Parser: make sure that unknown statements are treated as errors", "[p
     REQUIRE(reporter.hasError());
 }
 
+TEST_CASE("Parser: make sure that unmatched [ statements are treated as errors", "[parser]") {
+    std::vector<std::shared_ptr<Token>> tokens;
+    tokens.emplace_back(new Token(IF, 1, 1));
+    tokens.emplace_back(new Token(IF, 1, 2));
+    tokens.emplace_back(new Token(FI, 1, 3));
+    tokens.emplace_back(new Token(EOF_, 1, 3));
+
+    const auto payload = std::make_shared<TokenPayload>(TokenPayload { .tokens = tokens });
+
+    Reporter reporter;
+    Parser parser(reporter);
+    auto result = std::static_pointer_cast<StmtPayload>(parser.run(payload));
+
+    REQUIRE(result != nullptr);
+    REQUIRE(reporter.hasError());
+
+    // The unmatched conditional is closed at the end, to keep the statements consistent.
+    REQUIRE(result->stmts.size() == 1);
+    REQUIRE(result->stmts[0]->matches({IF, IF, FI}));
+}
+
 TEST_CASE("Parser: make sure that conditionals are being folded correctly", "[parser]") {
     checkStatementSequence({ IF, INC_BYTE, FI, EOF_ }, { IF });
 }
 
 TEST_CASE("Parser: make sure that deeply nested conditionals are being parsed correctly", "[parser]") {
-    const auto result = parse({ IF, IF, IF, IF, IF, INC_BYTE, FI, FI, FI, FI, FI, EOF_ });
+    const auto payload = parse({ IF, IF, IF, IF, IF, INC_BYTE, FI, FI, FI, FI, FI, EOF_ });
+    const auto &result = payload->stmts;
     int expectedDepth = 5;
 
     REQUIRE(result[0]->type == IF);
 
-    auto current = result[0];
+    Stmt *current = result[0];
     while (current->type == IF) {
         expectedDepth--;
 
-        const auto conditional = std::static_pointer_cast<Conditional>(current);
+        const auto conditional = static_cast<Conditional *>(current);
         REQUIRE(conditional->stmts.size() == 1);
         current = conditional->stmts[0];
     }
@@ -98,3 +122,62 @@ TEST_CASE("Parser: make sure that deeply nested conditionals are being parsed co
     REQUIRE(expectedDepth == 0);
 }
 
+
+/// Parses the source with the StreamingParser and returns the payload, which keeps the statements alive.
+std::shared_ptr<StmtPayload> parseStreaming(const std::string &code, const bool groupRuns, Reporter &reporter) {
+    StreamingParser parser(groupRuns, STRING, reporter);
+    auto result = std::static_pointer_cast<StmtPayload>(
+        parser.run(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    REQUIRE(result != nullptr);
+
+    return result;
+}
+
+TEST_CASE("Parser: make sure that the streaming parser parses like the parser", "[parser]") {
+    Reporter reporter;
+    const auto payload = parseStreaming("+>[-<.[,]]!", false, reporter);
+    const auto &result = payload->stmts;
+
+    REQUIRE_FALSE(reporter.hasError());
+    REQUIRE(result.size() == 4);
+    REQUIRE(result[0]->type == INC_BYTE);
+    REQUIRE(result[1]->type == INC_PTR);
+    REQUIRE(result[2]->matches({IF, DEC_BYTE, DEC_PTR, OUT, IF, FI}));
+    REQUIRE(static_cast<Conditional *>(result[2])->stmts[3]->matches({IF, IN, FI}));
+    REQUIRE(result[3]->type == DEBUG);
+
+    parseStreaming("+]", false, reporter);
+    REQUIRE(reporter.hasError());
+}
+
+TEST_CASE("Parser: make sure that the streaming parser groups runs of statements", "[parser]") {
+    Reporter reporter;
+    const auto payload = parseStreaming("+++[->>+<<]", true, reporter);
+    const auto &result = payload->stmts;
+
+    REQUIRE(result.size() == 2);
+    REQUIRE(static_cast<IncrementByte *>(result[0])->count == 3);
+
+    const auto conditional = static_cast<Conditional *>(result[1]);
+    REQUIRE(conditional->stmts.size() == 4);
+    REQUIRE(static_cast<IncrementPtr *>(conditional->stmts[1])->count == 2);
+    REQUIRE(static_cast<DecrementPtr *>(conditional->stmts[3])->count == 2);
+}
+
+TEST_CASE("Parser: make sure that the streaming parser handles deep nesting", "[parser]") {
+    constexpr int depth = 1000000;
+
+    Reporter reporter;
+    const auto payload = parseStreaming(std::string(depth, '[') + "+" + std::string(depth, ']'), true, reporter);
+
+    const Stmt *current = payload->stmts[0];
+    int actualDepth = 0;
+
+    while (current->type == IF) {
+        actualDepth++;
+        current = static_cast<const Conditional *>(current)->stmts[0];
+    }
+
+    REQUIRE(actualDepth == depth);
+}
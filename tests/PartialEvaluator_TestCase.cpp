@@ -0,0 +1,239 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/CodeGen.h"
+#include "../src/ElfAsmBuilder.h"
+#include "../src/ElfWriter.h"
+#include "../src/Jit.h"
+#include "../src/PartialEvaluator.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+#include "../src/Tape.h"
+#include "AssemblerEmulator.h"
+
+using namespace goo;
+namespace fs = std::filesystem;
+
+/*
+ * These test cases make sure that the PartialEvaluator only evaluates statements that don't depend on input and that
+ * every backend produces the same output for the evaluated statements as the Interpreter does for the original ones.
+ */
+
+/// Runs the partial evaluation and returns the payload, which keeps the statements alive.
+std::shared_ptr<StmtPayload> evaluateStmts(const std::string &code,
+                                           const std::int64_t stepBudget = DEFAULT_STEP_BUDGET) {
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STMT, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .partialEvaluator(PartialEvaluatorConfig{.stepBudget = stepBudget})
+            .debug(debugPhase)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+    REQUIRE(!reporter.hasWarnings());
+
+    return debugPhase->getStmtPayload();
+}
+
+/// Runs the code with the given backend, either with or without partial evaluation.
+std::string runEvaluated(const std::string &code, const bool evaluate, const char backend,
+                         const CellSemantics cellSemantics) {
+    Reporter reporter;
+    std::stringstream buffer;
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer();
+
+    if (evaluate) {
+        builder.partialEvaluator(PartialEvaluatorConfig{.cellSemantics = cellSemantics});
+    }
+
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    switch (backend) {
+        case 'b':
+            builder.bytecodeInterpreter(buffer, cellSemantics);
+            break;
+        case 'j':
+            builder.jit(buffer, cellSemantics);
+            break;
+        case 'c':
+            builder.codeGen(CodeGenConfig{.debugBuild = false, .cellSemantics = cellSemantics}).debug(debugPhase);
+            break;
+        default:
+            builder.interpreter(buffer, cellSemantics);
+            break;
+    }
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    if (backend == 'c') {
+        AssemblerEmulator emulator;
+        return emulator.execute(debugPhase->getValue());
+    }
+
+    return buffer.str();
+}
+
+void testEvaluatedStmts(const std::string &code, const CellSemantics cellSemantics = CELLS_COMPAT) {
+    const auto expected = runEvaluated(code, false, 'i', cellSemantics);
+
+    REQUIRE(runEvaluated(code, true, 'i', cellSemantics) == expected);
+    REQUIRE(runEvaluated(code, true, 'b', cellSemantics) == expected);
+    REQUIRE(runEvaluated(code, true, 'c', cellSemantics) == expected);
+
+    if (Jit::isAvailable()) {
+        REQUIRE(runEvaluated(code, true, 'j', cellSemantics) == expected);
+    }
+}
+
+/// Compiles the code with partial evaluation to an executable, runs it with the given input and returns its output.
+std::string runEvaluatedExecutable(const std::string &code, const std::string &input) {
+    const auto path = (fs::temp_directory_path() / "goo_partial_evaluator_test").string();
+
+    Reporter reporter;
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .partialEvaluator(PartialEvaluatorConfig{})
+            .elfCodeGen(CodeGenConfig{.debugBuild = false}, ELF_EXECUTABLE)
+            .elfWriter(ElfWriterConfig{.verbose = false, .executable = true, .outputFile = path});
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    const auto command = "printf '" + input + "' | " + path;
+    std::FILE *process = popen(command.c_str(), "r");
+    REQUIRE(process != nullptr);
+
+    std::string output;
+    for (int c = fgetc(process); c != EOF; c = fgetc(process)) {
+        output += static_cast<char>(c);
+    }
+
+    REQUIRE(pclose(process) == 0);
+    fs::remove(path);
+
+    return output;
+}
+
+TEST_CASE("PartialEvaluator: make sure that programs without input are evaluated completely", "[partial-evaluator]") {
+    const auto payload = evaluateStmts("+++.>++.");
+    const auto &stmts = payload->stmts;
+    REQUIRE(stmts.size() == 1);
+    REQUIRE(stmts[0]->type == CONST_OUTPUT);
+    REQUIRE(static_cast<ConstOutput *>(stmts[0])->value == "\x03\x02");
+
+    // Without any output, nothing remains at all.
+    REQUIRE(evaluateStmts("+++[>++<-]>")->stmts.empty());
+}
+
+TEST_CASE("PartialEvaluator: make sure that the evaluation stops at the first input", "[partial-evaluator]") {
+    const auto payload = evaluateStmts("+++.>++,.");
+    const auto &stmts = payload->stmts;
+    REQUIRE(stmts.size() == 5);
+    REQUIRE(stmts[0]->type == CONST_OUTPUT);
+    REQUIRE(static_cast<ConstOutput *>(stmts[0])->value == "\x03");
+
+    REQUIRE(stmts[1]->type == TAPE_INIT);
+    const auto tapeInit = static_cast<TapeInit *>(stmts[1]);
+    REQUIRE(tapeInit->cells == std::vector<TapeCell>{{0, 3}, {1, 2}});
+    REQUIRE(tapeInit->tapePtr == 0);
+
+    REQUIRE(stmts[2]->type == IN);
+    REQUIRE(stmts[3]->type == OUT);
+
+    // A conditional that reads input is rolled back completely, including its output.
+    const auto rolledBackPayload = evaluateStmts("++>+[<.,]");
+    const auto &rolledBack = rolledBackPayload->stmts;
+    REQUIRE(rolledBack.size() == 2);
+    REQUIRE(rolledBack[0]->type == TAPE_INIT);
+    REQUIRE(static_cast<TapeInit *>(rolledBack[0])->cells == std::vector<TapeCell>{{0, 2}, {1, 1}});
+    REQUIRE(static_cast<TapeInit *>(rolledBack[0])->tapePtr == 1);
+    REQUIRE(rolledBack[1]->type == IF);
+
+    // If the first statement already reads input, the statements are left untouched.
+    REQUIRE(evaluateStmts(",+.")->stmts.size() == 3);
+}
+
+TEST_CASE("PartialEvaluator: make sure that the evaluation stops when the step budget is exhausted", "[partial-evaluator]") {
+    const auto payload = evaluateStmts("+.>+.>+.", 2);
+    const auto &stmts = payload->stmts;
+    REQUIRE(stmts.size() == 7);
+    REQUIRE(static_cast<ConstOutput *>(stmts[0])->value == "\x01");
+    REQUIRE(stmts[1]->type == TAPE_INIT);
+
+    // Endless loops run out of budget, too.
+    const auto endlessPayload = evaluateStmts("+.+[>+<]", 1000);
+    const auto &endless = endlessPayload->stmts;
+    REQUIRE(endless.size() == 3);
+    REQUIRE(static_cast<ConstOutput *>(endless[0])->value == "\x01");
+    REQUIRE(static_cast<TapeInit *>(endless[1])->cells == std::vector<TapeCell>{{0, 2}});
+
+    // Loops that move the tape pointer beyond the end of the tape are left to the backend, as it warns about it.
+    REQUIRE(evaluateStmts("+[>+]")->stmts.size() == 2);
+}
+
+TEST_CASE("PartialEvaluator: make sure that evaluated statements produce the same output", "[partial-evaluator]") {
+    testEvaluatedStmts("++++++++[>++++[>++>+++>+++>+<<<<-]>+>+>->>+[<]<-]>>.>---.+++++++..+++.>>.<-.<.+++.------.--------.>>+.");
+    testEvaluatedStmts("+++[->+>++>+++<<<]>.>.>.");
+    testEvaluatedStmts(">+>+>+<<[>]+++.");
+    testEvaluatedStmts("<[<]+[>]+.");
+    testEvaluatedStmts("-.--.>-----.");
+    testEvaluatedStmts("-.--.>-----.", CELLS_WRAP8);
+    testEvaluatedStmts("<[<]+[>]+.", CELLS_WRAP8);
+    testEvaluatedStmts("+>>+<<[>>>]+.", CELLS_WRAP8);
+
+    // The tape pointer wraps around with a warning, which is left to the backend.
+    testEvaluatedStmts("+.>+[<]+.");
+}
+
+TEST_CASE("PartialEvaluator: make sure that programs without input compile to a single write", "[partial-evaluator]") {
+    Reporter reporter;
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .partialEvaluator(PartialEvaluatorConfig{})
+            .codeGen(CodeGenConfig{.debugBuild = false})
+            .debug(debugPhase)
+            .build();
+
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = "+++[>+++<-]>.+.+."})));
+
+    // One syscall writes the output, the other one exits.
+    const auto &code = debugPhase->getValue();
+    int syscalls = 0;
+    for (auto pos = code.find("syscall"); pos != std::string::npos; pos = code.find("syscall", pos + 1)) {
+        syscalls++;
+    }
+
+    REQUIRE(syscalls == 2);
+    REQUIRE(code.find("constOutput") != std::string::npos);
+
+#if defined(__x86_64__) && defined(__linux__)
+    REQUIRE(runEvaluatedExecutable("+++[>+++<-]>.+.+.", "") == "\x09\x0a\x0b");
+    REQUIRE(runEvaluatedExecutable("+++.>++,.", "A") == "\x03" "A");
+    REQUIRE(runEvaluatedExecutable("++++++++[>++++++++<-]>+.,.,.", "bc") == "Abc");
+#endif
+}
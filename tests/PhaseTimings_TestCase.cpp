@@ -0,0 +1,106 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <algorithm>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/PhaseTimings.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+
+TEST_CASE("PhaseTimings: make sure that each phase is measured", "[phase-timings]") {
+    std::stringstream messages;
+    Reporter reporter("", messages);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .build();
+
+    PhaseTimings timings;
+    pipeline->setPhaseObserver(timings.observer());
+
+    const auto payload = std::make_shared<StringPayload>(StringPayload{.value = "++[->+<]>."});
+    REQUIRE(pipeline->execute(payload));
+
+    const auto &phases = timings.getTimings();
+    REQUIRE(phases.size() == 4);
+
+    REQUIRE(phases[0].phase == "string-input");
+    REQUIRE(phases[0].payloadSize == 10);
+    REQUIRE(phases[0].payloadUnit == "bytes");
+
+    // The scanner terminates the tokens with EOF_.
+    REQUIRE(phases[1].phase == "scanner");
+    REQUIRE(phases[1].payloadSize == 11);
+    REQUIRE(phases[1].payloadUnit == "tokens");
+
+    // The conditional and the four statements within it.
+    REQUIRE(phases[2].phase == "parser");
+    REQUIRE(phases[2].payloadSize == 9);
+    REQUIRE(phases[2].payloadUnit == "statements");
+
+    // ++, the linear loop, > and .
+    REQUIRE(phases[3].phase == "optimizer");
+    REQUIRE(phases[3].payloadSize == 4);
+
+    for (const auto &timing: phases) {
+        REQUIRE(timing.wallTime.count() >= 0);
+        REQUIRE(timing.cpuTime.count() >= 0);
+        REQUIRE(timing.peakRssDelta >= 0);
+    }
+}
+
+TEST_CASE("PhaseTimings: make sure that the phase reporting an error is measured as well", "[phase-timings]") {
+    std::stringstream messages;
+    Reporter reporter("", messages);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer()
+            .build();
+
+    PhaseTimings timings;
+    pipeline->setPhaseObserver(timings.observer());
+
+    const auto payload = std::make_shared<StringPayload>(StringPayload{.value = "+]"});
+    REQUIRE_FALSE(pipeline->execute(payload));
+
+    const auto &phases = timings.getTimings();
+    REQUIRE(phases.size() == 3);
+    REQUIRE(phases.back().phase == "parser");
+}
+
+TEST_CASE("PhaseTimings: make sure that the measurements are printed as JSON", "[phase-timings]") {
+    std::stringstream messages;
+    Reporter reporter("", messages);
+
+    StandardPipelineBuilder builder(reporter);
+    const auto pipeline = builder.stringInput()
+            .lexer()
+            .build();
+
+    PhaseTimings timings("hello.bf");
+    pipeline->setPhaseObserver(timings.observer());
+
+    const auto payload = std::make_shared<StringPayload>(StringPayload{.value = "+."});
+    REQUIRE(pipeline->execute(payload));
+
+    std::stringstream json;
+    timings.printJson(json);
+
+    const auto line = json.str();
+    REQUIRE(line.starts_with(R"({"file": "hello.bf", "phases": [{"phase": "string-input", )"));
+    REQUIRE(line.find(R"("phase": "scanner")") != std::string::npos);
+    REQUIRE(line.find(R"("payloadSize": 3, "payloadUnit": "tokens"})") != std::string::npos);
+    REQUIRE(line.ends_with("]}\n"));
+    REQUIRE(std::ranges::count(line, '\n') == 1);
+}
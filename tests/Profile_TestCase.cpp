@@ -0,0 +1,225 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/CodeGen.h"
+#include "../src/ElfAsmBuilder.h"
+#include "../src/ElfWriter.h"
+#include "../src/Optimizer.h"
+#include "../src/Pipeline.h"
+#include "../src/Profile.h"
+#include "../src/Reporter.h"
+
+using namespace goo;
+namespace fs = std::filesystem;
+
+/// Writes a profile file of the given counters, like a profiled binary would.
+void writeProfile(const std::string &path, const std::vector<ProfileCounter> &counters) {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << Profile::header(counters);
+
+    for (const auto &counter: counters) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            ofs.put(static_cast<char>(counter.count >> shift & 0xFF));
+        }
+    }
+}
+
+/// A profile of a program with a hot loop at 1:2 and a loop at 2:1, that is never reached.
+Profile hotAndColdProfile() {
+    return Profile({
+        ProfileCounter{.kind = LOOP_ENTRIES, .line = 1, .column = 2, .count = 1},
+        ProfileCounter{.kind = LOOP_ITERATIONS, .line = 1, .column = 2, .count = 5000},
+        ProfileCounter{.kind = LOOP_ENTRIES, .line = 2, .column = 1, .count = 0},
+        ProfileCounter{.kind = LOOP_ITERATIONS, .line = 2, .column = 1, .count = 0}
+    });
+}
+
+/// Compiles the code with the profile and returns the assembler code.
+std::string compileWithProfile(const std::string &code, const Profile &profile, const CellSemantics cellSemantics) {
+    Reporter reporter;
+    const auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    // Only grouping keeps the loops as they are, instead of turning them into linear loops.
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer(OptimizerConfig{.passes = {"group"}, .profile = std::make_shared<const Profile>(profile)})
+            .codeGen(CodeGenConfig{.debugBuild = false, .cellSemantics = cellSemantics})
+            .debug(debugPhase);
+
+    REQUIRE(builder.build()->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+    return debugPhase->getValue();
+}
+
+TEST_CASE("Profile: make sure that profiles are read correctly", "[profile]") {
+    const auto path = (fs::temp_directory_path() / "goo_profile_test.prof").string();
+
+    writeProfile(path, {
+                     ProfileCounter{.kind = LOOP_ENTRIES, .line = 1, .column = 3, .count = 1},
+                     ProfileCounter{.kind = LOOP_ITERATIONS, .line = 1, .column = 3, .count = 5000000000},
+                     ProfileCounter{.kind = OUTPUTS, .line = 2, .column = 1, .count = 7}
+                 });
+
+    const auto profile = Profile::read(path);
+    REQUIRE(profile.has_value());
+
+    const auto &counters = profile->getCounters();
+    REQUIRE(counters.size() == 3);
+    REQUIRE(counters[1].kind == LOOP_ITERATIONS);
+    REQUIRE(counters[1].line == 1);
+    REQUIRE(counters[1].column == 3);
+    REQUIRE(counters[1].count == 5000000000);
+    REQUIRE(counters[2].kind == OUTPUTS);
+    REQUIRE(counters[2].count == 7);
+
+    std::stringstream out;
+    profile->print(out);
+    REQUIRE(out.str() == "Hottest loops (1 of 1):\n  1:3: 5000000000 iteration(s), 1 entries\n7 output(s), 0 input(s)\n");
+
+    fs::remove(path);
+}
+
+TEST_CASE("Profile: make sure that invalid profiles are rejected", "[profile]") {
+    const auto path = (fs::temp_directory_path() / "goo_profile_test.prof").string();
+
+    REQUIRE_FALSE(Profile::read(path + ".missing").has_value());
+
+    std::ofstream(path) << "+[->+<]";
+    REQUIRE_FALSE(Profile::read(path).has_value());
+
+    // A binary that is killed before exiting writes no counters at all.
+    std::ofstream(path, std::ios::binary) << Profile::header({ProfileCounter{.kind = INPUTS, .line = 1, .column = 1}});
+    REQUIRE_FALSE(Profile::read(path).has_value());
+
+    fs::remove(path);
+}
+
+TEST_CASE("Profile: make sure that profiled executables count loops, output and input", "[profile]") {
+#if defined(__x86_64__) && defined(__linux__)
+    const auto executable = (fs::temp_directory_path() / "goo_profile_test").string();
+    const auto profileFile = executable + ".prof";
+
+    // The optimizer is skipped, as it would turn the inner loop into a linear loop.
+    Reporter reporter;
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .elfCodeGen(CodeGenConfig{.debugBuild = false, .profileFile = profileFile}, ELF_EXECUTABLE)
+            .elfWriter(ElfWriterConfig{.verbose = false, .executable = true, .outputFile = executable});
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = ",++[>+++[>+<-]<-]\n>>."})));
+
+    // The input 'A' (65) plus 2 results in 67 iterations of the outer loop and 3 of the inner loop each.
+    REQUIRE(std::system(("printf 'A' | " + executable + " > /dev/null").c_str()) == 0);
+
+    const auto profile = Profile::read(profileFile);
+    REQUIRE(profile.has_value());
+
+    std::vector<std::tuple<ProfileCounterKind, int, int, std::uint64_t>> counters;
+    for (const auto &[kind, line, column, count]: profile->getCounters()) {
+        counters.emplace_back(kind, line, column, count);
+    }
+
+    REQUIRE(counters == std::vector<std::tuple<ProfileCounterKind, int, int, std::uint64_t>>{
+                {INPUTS, 1, 1, 1},
+                {LOOP_ENTRIES, 1, 4, 1},
+                {LOOP_ITERATIONS, 1, 4, 67},
+                {LOOP_ENTRIES, 1, 9, 67},
+                {LOOP_ITERATIONS, 1, 9, 201},
+                {OUTPUTS, 2, 3, 1}
+            });
+
+    fs::remove(executable);
+    fs::remove(profileFile);
+#endif
+}
+
+TEST_CASE("LoopProfile: make sure that loops are matched despite small changes", "[profile]") {
+    const auto match = [](const std::string &code) {
+        Reporter reporter;
+        const auto debugPhase = std::make_shared<DebugPhase>(STMT, reporter);
+
+        StandardPipelineBuilder builder(reporter);
+        builder.stringInput()
+                .lexer()
+                .parser()
+                .debug(debugPhase);
+
+        REQUIRE(builder.build()->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+        return LoopProfile::match(hotAndColdProfile(), debugPhase->getStmts());
+    };
+
+    const auto unchanged = match("+[->+<]\n[-]");
+    REQUIRE(unchanged.heat(1, 2) == HEAT_HOT);
+    REQUIRE(unchanged.heat(2, 1) == HEAT_COLD);
+
+    // With as many loops as before, loops are matched by their index.
+    const auto moved = match("\n\n++[->+<]\n[-]");
+    REQUIRE(moved.heat(3, 3) == HEAT_HOT);
+    REQUIRE(moved.heat(4, 1) == HEAT_COLD);
+
+    // Otherwise by their position, or the nearest one within a few lines.
+    const auto added = match("+[->+<]\n\n[-]\n\n\n\n\n[+]");
+    REQUIRE(added.heat(1, 2) == HEAT_HOT);
+    REQUIRE(added.heat(3, 1) == HEAT_COLD);
+    REQUIRE(added.heat(8, 1) == HEAT_UNKNOWN);
+    REQUIRE(added.getLoopCount() == 3);
+    REQUIRE(added.count(HEAT_UNKNOWN) == 1);
+}
+
+TEST_CASE("Profile: make sure that hot loops are aligned and unrolled", "[profile]") {
+    const auto code = compileWithProfile("+[->+<]\n[-]", hotAndColdProfile(), CELLS_COMPAT);
+
+    REQUIRE(code.find("align 16\nhotLoop") != std::string::npos);
+    REQUIRE(code.find("\tjg hotLoop") != std::string::npos);
+
+    // Only the cold loop is translated as usual.
+    REQUIRE(code.find("\tjmp loop") != std::string::npos);
+    REQUIRE(code.find("\tjmp loop") == code.rfind("\tjmp loop"));
+
+    REQUIRE(compileWithProfile("+[->+<]\n[-]", hotAndColdProfile(), CELLS_WRAP8).find("\tjne hotLoop") !=
+            std::string::npos);
+}
+
+TEST_CASE("Profile: make sure that executables optimized with a profile produce the same output", "[profile]") {
+#if defined(__x86_64__) && defined(__linux__)
+    const auto executable = (fs::temp_directory_path() / "goo_profile_use_test").string();
+
+    // The loop runs 7 times, therefor the unrolled body exits in its middle.
+    const std::string code = "+++++++[>++++++++++<-]\n[-]>-----.";
+
+    for (const auto cellSemantics: {CELLS_COMPAT, CELLS_WRAP8}) {
+        Reporter reporter;
+        StandardPipelineBuilder builder(reporter);
+        builder.stringInput()
+                .lexer()
+                .parser()
+                .optimizer(OptimizerConfig{
+                    .passes = {"group"}, .profile = std::make_shared<const Profile>(hotAndColdProfile())
+                })
+                .elfCodeGen(CodeGenConfig{.debugBuild = false, .cellSemantics = cellSemantics}, ELF_EXECUTABLE)
+                .elfWriter(ElfWriterConfig{.verbose = false, .executable = true, .outputFile = executable});
+
+        // The profile refers to 1:2, therefor the loop at 1:8 is matched by its index.
+        REQUIRE(builder.build()->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+        REQUIRE(std::system((executable + " > " + executable + ".out").c_str()) == 0);
+
+        std::ifstream ifs(executable + ".out");
+        REQUIRE(std::string(std::istreambuf_iterator(ifs), {}) == "A");
+    }
+
+    fs::remove(executable);
+    fs::remove(executable + ".out");
+#endif
+}
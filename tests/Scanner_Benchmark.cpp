@@ -0,0 +1,70 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <fstream>
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../src/Scanner.h"
+
+using namespace goo;
+
+/*
+ * Compares skipping comments byte by byte with the vectorized TokenStream. The benchmarks are hidden, run them
+ * explicitly with: unit_tests "[benchmark]"
+ */
+
+/// Creates a large, comment-heavy source from c-tree.bf, with paragraphs of prose between each of its lines.
+std::string commentHeavySource() {
+    std::ifstream ifs(std::string(GOO_EXAMPLES_DIR) + "/c-tree.bf");
+    std::stringstream code;
+    code << ifs.rdbuf();
+
+    const std::string prose = "This program prints a christmas tree of the height that is read as input\n"
+            "and the lines in between are commentary that takes up most of the file\n"
+            "just like in many real world sources that explain what happens there\n";
+
+    std::string source;
+    std::istringstream lines(code.str());
+    std::string line;
+
+    for (int copy = 0; copy < 20; copy++) {
+        lines.clear();
+        lines.seekg(0);
+
+        while (std::getline(lines, line)) {
+            source += prose + prose + line + "\n";
+        }
+    }
+
+    return source;
+}
+
+std::size_t countTokens(const std::string &source, const bool vectorize) {
+    TokenStream stream(source, false, vectorize);
+    std::size_t count = 0;
+
+    while (stream.next().type != EOF_) {
+        count++;
+    }
+
+    return count;
+}
+
+TEST_CASE("Benchmark: scalar vs. vectorized scanning of a comment-heavy source", "[.][benchmark]") {
+    const auto source = commentHeavySource();
+    REQUIRE(countTokens(source, false) == countTokens(source, true));
+
+    // The vectorized benchmark falls back to scalar code on CPUs without AVX2 and SSE4.2.
+    WARN(std::string("vector extension: ") + std::string(TokenStream::vectorExtension()));
+
+    BENCHMARK("TokenStream (scalar)") {
+        return countTokens(source, false);
+    };
+
+    BENCHMARK("TokenStream (vectorized)") {
+        return countTokens(source, true);
+    };
+}
@@ -46,4 +46,49 @@ TEST_CASE("Scanner: make sure that any non-statements are ignored", "[scanner]")
     checkTokenSequence("ab", { });
     checkTokenSequence("a+b", { INC_BYTE });
     checkTokenSequence("{]", { FI });
-}
\ No newline at end of file
+}
+TEST_CASE("Scanner: make sure that the token stream groups runs of statements", "[scanner]") {
+    TokenStream stream("+++>\n--..[<<]", true);
+
+    const std::vector<std::pair<TokenType, int>> expected = {
+        {INC_BYTE, 3}, {INC_PTR, 1}, {DEC_BYTE, 2}, {OUT, 1}, {OUT, 1}, {IF, 1}, {DEC_PTR, 2}, {FI, 1}, {EOF_, 1}
+    };
+
+    for (const auto &[type, count]: expected) {
+        const auto token = stream.next();
+        REQUIRE(token.type == type);
+        REQUIRE(token.count == count);
+    }
+
+    TokenStream ungrouped("a++\n +");
+    REQUIRE(ungrouped.next().column == 2);
+    REQUIRE(ungrouped.next().column == 3);
+
+    const auto token = ungrouped.next();
+    REQUIRE(token.line == 2);
+    REQUIRE(token.column == 2);
+    REQUIRE(token.count == 1);
+}
+
+TEST_CASE("Scanner: make sure that vectorized comment skipping keeps lines and columns", "[scanner]") {
+    // Long comments with line breaks at varying positions, to cross the blocks of the vectorized scanner.
+    std::string source;
+    for (int idx = 0; idx < 200; idx++) {
+        source += std::string(idx % 70, 'a') + (idx % 3 == 0 ? "\n" : " ") + "+>[<-]";
+        source += std::string(idx % 17, '\n') + std::string(1, '\0') + "comment.";
+    }
+
+    TokenStream vectorized(source, true);
+    TokenStream scalar(source, true, false);
+
+    TokenRun expected{};
+    do {
+        expected = scalar.next();
+        const auto actual = vectorized.next();
+
+        REQUIRE(actual.type == expected.type);
+        REQUIRE(actual.count == expected.count);
+        REQUIRE(actual.line == expected.line);
+        REQUIRE(actual.column == expected.column);
+    } while (expected.type != EOF_);
+}
@@ -0,0 +1,35 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/Sha256.h"
+
+using namespace goo;
+
+std::string sha256(const std::string_view bytes) {
+    Sha256 digest;
+    digest.update(bytes);
+
+    return digest.hexDigest();
+}
+
+TEST_CASE("Sha256: make sure that digests match the test vectors of FIPS 180-4", "[sha256]") {
+    REQUIRE(sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    REQUIRE(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    REQUIRE(sha256(std::string(1000000, 'a')) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE("Sha256: make sure that bytes passed in parts are hashed like a whole", "[sha256]") {
+    const std::string bytes(200, 'x');
+
+    Sha256 digest;
+    digest.update(std::string_view(bytes).substr(0, 63));
+    digest.update(std::string_view(bytes).substr(63, 2));
+    digest.update(std::string_view(bytes).substr(65));
+
+    REQUIRE(digest.hexDigest() == sha256(bytes));
+}
@@ -0,0 +1,53 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/StmtArena.h"
+
+using namespace goo;
+
+TEST_CASE("StmtArena: make sure that statements are constructed within the arena", "[stmt-arena]") {
+    StmtArena arena;
+
+    const auto incByte = arena.make<IncrementByte>(1, 2, 3, 4);
+    REQUIRE(incByte->column == 1);
+    REQUIRE(incByte->line == 2);
+    REQUIRE(incByte->count == 3);
+    REQUIRE(incByte->offset == 4);
+
+    const auto linearLoop = arena.make<LinearLoop>(0, 0, std::vector<LinearTarget>{{1, 2}});
+    REQUIRE(linearLoop->targets == std::vector<LinearTarget>{{1, 2}});
+
+    const auto constOutput = arena.make<ConstOutput>(0, 0, std::string(1000, 'x'));
+    REQUIRE(constOutput->value.size() == 1000);
+
+    REQUIRE(arena.size() == 3);
+
+    // Consecutive statements are placed next to each other, instead of being allocated one by one.
+    const auto first = arena.make<Output>(0, 0);
+    const auto second = arena.make<Output>(0, 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(second) - reinterpret_cast<std::uintptr_t>(first) == sizeof(Output));
+}
+
+TEST_CASE("StmtArena: make sure that lists of statements are copied into the arena", "[stmt-arena]") {
+    StmtArena arena;
+
+    StmtVector stmts;
+    for (int idx = 0; idx < 100'000; idx++) {
+        stmts.push_back(arena.make<IncrementPtr>(idx, 0));
+    }
+
+    // The list is larger than a block, therefor it gets a block of its own.
+    const auto conditional = arena.make<Conditional>(0, 0, arena.list(stmts));
+    stmts.clear();
+
+    REQUIRE(conditional->stmts.size() == 100'000);
+    REQUIRE(conditional->stmts[99'999]->column == 99'999);
+    REQUIRE_FALSE(conditional->matches({IF, INC_PTR, FI}));
+
+    REQUIRE(arena.list({}).empty());
+    REQUIRE(arena.size() == 100'001);
+}
@@ -0,0 +1,102 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <sstream>
+#include <catch2/catch_test_macros.hpp>
+
+#include "AssemblerEmulator.h"
+#include "../src/CodeGen.h"
+#include "../src/Jit.h"
+#include "../src/Optimizer.h"
+#include "../src/Pipeline.h"
+#include "../src/Reporter.h"
+#include "../src/Tape.h"
+
+using namespace goo;
+
+/*
+ * These test cases make sure that every engine reaches the same cells at either end of the tape, with and without
+ * optimizations. Optimized statements address cells relative to the tape pointer, which must wrap around the tape
+ * exactly like the tape pointer does. Each program starts at cell 0 and moves left.
+ */
+
+enum TapeEdgeEngine {
+    EDGE_INTERPRETER,
+    EDGE_BYTECODE,
+    EDGE_JIT,
+    EDGE_CODEGEN
+};
+
+std::string runAtTapeEdge(const std::string &code, const TapeEdgeEngine engine, const OptimizerConfig &config,
+                          const CellSemantics cellSemantics) {
+    Reporter reporter;
+    std::stringstream buffer;
+    auto debugPhase = std::make_shared<DebugPhase>(STRING, reporter);
+
+    StandardPipelineBuilder builder(reporter);
+    builder.stringInput()
+            .lexer()
+            .parser()
+            .optimizer(config);
+
+    switch (engine) {
+        case EDGE_INTERPRETER:
+            builder.interpreter(buffer, cellSemantics);
+            break;
+        case EDGE_BYTECODE:
+            builder.bytecodeInterpreter(buffer, cellSemantics);
+            break;
+        case EDGE_JIT:
+            builder.jit(buffer, cellSemantics);
+            break;
+        case EDGE_CODEGEN:
+            builder.codeGen(CodeGenConfig{.debugBuild = false, .cellSemantics = cellSemantics})
+                    .debug(debugPhase);
+            break;
+    }
+
+    const auto pipeline = builder.build();
+    REQUIRE(pipeline->execute(std::make_shared<StringPayload>(StringPayload{.value = code})));
+
+    if (engine == EDGE_CODEGEN) {
+        AssemblerEmulator assembler;
+        return assembler.execute(debugPhase->getValue());
+    }
+
+    return buffer.str();
+}
+
+/// Compares the output of every engine and optimization level with the unoptimized Interpreter, in both semantics.
+void testTapeEdge(const std::string &code, const std::string &expected) {
+    for (const auto cellSemantics: {CELLS_COMPAT, CELLS_WRAP8}) {
+        REQUIRE(runAtTapeEdge(code, EDGE_INTERPRETER, OptimizerConfig{.level = 0}, cellSemantics) == expected);
+
+        for (const auto engine: {EDGE_INTERPRETER, EDGE_BYTECODE, EDGE_JIT, EDGE_CODEGEN}) {
+            if (engine == EDGE_JIT && !Jit::isAvailable()) {
+                continue;
+            }
+
+            for (const auto level: {0, 1, 2, 3}) {
+                REQUIRE(runAtTapeEdge(code, engine, OptimizerConfig{.level = level}, cellSemantics) == expected);
+            }
+
+            // Linear loops without any deferred pointer movements.
+            const OptimizerConfig linearLoops{.passes = {"group", "linear-loop"}};
+            REQUIRE(runAtTapeEdge(code, engine, linearLoops, cellSemantics) == expected);
+        }
+    }
+}
+
+TEST_CASE("Tape edge: make sure that cells beyond either end of the tape are reached with any optimization", "[tape-edge]") {
+    testTapeEdge("<+><[.-]", "\x01");
+    testTapeEdge("<+>>+<<.>>.<.", std::string("\x01\x01\x00", 3));
+    testTapeEdge("<+[>>+<<[-]]>>.", "\x01");
+    testTapeEdge("[][]+[[>><][]<<<][][]>>.[<][]", "\x01");
+}
+
+TEST_CASE("Tape edge: make sure that linear loops reach targets beyond either end of the tape", "[tape-edge]") {
+    testTapeEdge("<+[->+<]>.", "\x01");
+    testTapeEdge("<+++[->>++<<]>>.", "\x06");
+    testTapeEdge(">+[-<<+++>>]<<.", "\x03");
+}
@@ -0,0 +1,115 @@
+//
+// Created by michael on 18.10.26.
+//
+
+#include <functional>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/X86Encoder.h"
+
+using namespace goo;
+
+/*
+ * The expected byte sequences have been cross-checked with the output of an assembler for the corresponding
+ * instruction. Note that the encoder always uses 32-bit displacements for jumps.
+ */
+
+void checkEncoding(const std::function<void(X86Encoder &)> &encode, const std::vector<std::uint8_t> &expected) {
+    X86Encoder encoder;
+    encode(encoder);
+    REQUIRE(encoder.finish());
+    REQUIRE(encoder.bytes() == expected);
+}
+
+TEST_CASE("X86Encoder: make sure that arithmetic instructions are encoded correctly", "[x86encoder]") {
+    // add byte [rbx + r12], 1
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_ADD, 1, Memory{.base = RBX, .index = R12}, 1); },
+                  {0x42, 0x80, 0x04, 0x23, 0x01});
+    // sub byte [rbx + r12 + 300], 5
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_SUB, 1, Memory{.base = RBX, .index = R12, .disp = 300}, 5); },
+                  {0x42, 0x80, 0xAC, 0x23, 0x2C, 0x01, 0x00, 0x00, 0x05});
+    // add rbx, 1
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_ADD, 8, RBX, 1); }, {0x48, 0x83, 0xC3, 0x01});
+    // cmp r12, 30000
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_CMP, 8, R12, 30000); }, {0x49, 0x81, 0xFC, 0x30, 0x75, 0x00, 0x00});
+    // add byte [rax + rbx], r9b
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_ADD, 1, Memory{.base = RAX, .index = RBX}, R9); },
+                  {0x44, 0x00, 0x0C, 0x18});
+    // sub r8b, byte [rax + rbx]
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_SUB, 1, R8, Memory{.base = RAX, .index = RBX}); },
+                  {0x44, 0x2A, 0x04, 0x18});
+    // xor rdi, rdi
+    checkEncoding([](X86Encoder &e) { e.alu(ALU_XOR, 8, RDI, RDI); }, {0x48, 0x31, 0xFF});
+    // mul r9b
+    checkEncoding([](X86Encoder &e) { e.mul(1, R9); }, {0x41, 0xF6, 0xE1});
+    // imul eax, eax, 7
+    checkEncoding([](X86Encoder &e) { e.imul(4, RAX, RAX, 7); }, {0x6B, 0xC0, 0x07});
+}
+
+TEST_CASE("X86Encoder: make sure that move instructions are encoded correctly", "[x86encoder]") {
+    // mov rbx, 0
+    checkEncoding([](X86Encoder &e) { e.mov(8, RBX, 0); }, {0x48, 0xC7, 0xC3, 0x00, 0x00, 0x00, 0x00});
+    // mov rax, 0x1122334455667788
+    checkEncoding([](X86Encoder &e) { e.mov(8, RAX, 0x1122334455667788); },
+                  {0x48, 0xB8, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+    // mov sil, 3
+    checkEncoding([](X86Encoder &e) { e.mov(1, RSI, 3); }, {0x40, 0xB6, 0x03});
+    // mov byte [rax + rbx], 0
+    checkEncoding([](X86Encoder &e) { e.mov(1, Memory{.base = RAX, .index = RBX}, 0); },
+                  {0xC6, 0x04, 0x18, 0x00});
+    // mov r12, [r14]
+    checkEncoding([](X86Encoder &e) { e.mov(8, R12, Memory{.base = R14}); }, {0x4D, 0x8B, 0x26});
+    // mov [r13], rax
+    checkEncoding([](X86Encoder &e) { e.mov(8, Memory{.base = R13}, RAX); }, {0x49, 0x89, 0x45, 0x00});
+    // movzx eax, byte [rbx + r12]
+    checkEncoding([](X86Encoder &e) { e.movzxByte(RAX, Memory{.base = RBX, .index = R12}); },
+                  {0x42, 0x0F, 0xB6, 0x04, 0x23});
+    // lea rax, [rel 0x10]
+    checkEncoding([](X86Encoder &e) { e.lea(RAX, Memory{.disp = 0x10, .ripRelative = true}); },
+                  {0x48, 0x8D, 0x05, 0x10, 0x00, 0x00, 0x00});
+    // lea rsi, [rbx * 1 + 0x400000]
+    checkEncoding([](X86Encoder &e) { e.lea(RSI, Memory{.index = RBX, .disp = 0x400000}); },
+                  {0x48, 0x8D, 0x34, 0x1D, 0x00, 0x00, 0x40, 0x00});
+    // mov r8b, byte [rsp]
+    checkEncoding([](X86Encoder &e) { e.mov(1, R8, Memory{.base = RSP}); }, {0x44, 0x8A, 0x04, 0x24});
+}
+
+TEST_CASE("X86Encoder: make sure that SSE2 and bit scan instructions are encoded correctly", "[x86encoder]") {
+    // movdqu xmm0, [rax + rbx - 15]
+    checkEncoding([](X86Encoder &e) { e.sse(SSE_MOVDQU, RAX, Memory{.base = RAX, .index = RBX, .disp = -15}); },
+                  {0xF3, 0x0F, 0x6F, 0x44, 0x18, 0xF1});
+    // movdqu xmm9, [rax + r12]
+    checkEncoding([](X86Encoder &e) { e.sse(SSE_MOVDQU, R9, Memory{.base = RAX, .index = R12}); },
+                  {0xF3, 0x46, 0x0F, 0x6F, 0x0C, 0x20});
+    // pxor xmm1, xmm1
+    checkEncoding([](X86Encoder &e) { e.sse(SSE_PXOR, RCX, RCX); }, {0x66, 0x0F, 0xEF, 0xC9});
+    // pcmpeqb xmm8, xmm1
+    checkEncoding([](X86Encoder &e) { e.sse(SSE_PCMPEQB, R8, RCX); }, {0x66, 0x44, 0x0F, 0x74, 0xC1});
+    // pmovmskb r9d, xmm0
+    checkEncoding([](X86Encoder &e) { e.sse(SSE_PMOVMSKB, R9, RAX); }, {0x66, 0x44, 0x0F, 0xD7, 0xC8});
+    // bsf eax, ecx
+    checkEncoding([](X86Encoder &e) { e.bitScan(false, 4, RAX, RCX); }, {0x0F, 0xBC, 0xC1});
+    // bsr r9d, r9d
+    checkEncoding([](X86Encoder &e) { e.bitScan(true, 4, R9, R9); }, {0x45, 0x0F, 0xBD, 0xC9});
+}
+
+TEST_CASE("X86Encoder: make sure that jumps are resolved correctly", "[x86encoder]") {
+    // A backward jump to itself: jmp $
+    checkEncoding([](X86Encoder &e) {
+        const auto label = e.newLabel();
+        e.bind(label);
+        e.jmp(label);
+    }, {0xE9, 0xFB, 0xFF, 0xFF, 0xFF});
+
+    // A forward jump over a syscall: je +2
+    checkEncoding([](X86Encoder &e) {
+        const auto label = e.newLabel();
+        e.jcc(COND_E, label);
+        e.syscall();
+        e.bind(label);
+    }, {0x0F, 0x84, 0x02, 0x00, 0x00, 0x00, 0x0F, 0x05});
+
+    X86Encoder encoder;
+    encoder.jmp(encoder.newLabel());
+    REQUIRE_FALSE(encoder.finish());
+}